@@ -5,6 +5,7 @@
 
 // Global State
 let currentStudent = null;
+let sessionToken = null;    // issued by /api/login/*, sent as a Bearer token
 let allApplicants = [];
 let adminLoggedIn = false;
 let studentLoginAttempts = 3;
@@ -200,6 +201,7 @@ async function performStudentLogin() {
 
             if (result.success) {
                 currentStudent = result.student;
+                sessionToken = result.token || null;
                 currentStudent.password = password; // Store for local operations
                 addStatusMessage('loginStatusMessages', 'Login successful!', 'success');
                 showAlert('loginAlert', `Welcome, ${currentStudent.name}!`, 'success');
@@ -255,7 +257,33 @@ function updateAttemptsInfo(elementId, attempts) {
 // ============================================================
 // PREFERENCE OPTIONS - Dynamic filtering
 // ============================================================
-const allDepartments = ['CSE', 'IT', 'TT', 'APM'];
+// Replaced by the server's program registry when the API is up
+let allDepartments = ['CSE', 'IT', 'TT', 'APM'];
+let programSeats = { CSE: 10, IT: 10, TT: 10, APM: 10 };
+
+async function loadPrograms() {
+    try {
+        const response = await fetch(`${API_BASE}/api/programs`);
+        if (!response.ok) return;
+        const data = await response.json();
+        if (!Array.isArray(data.programs) || data.programs.length === 0) return;
+        allDepartments = data.programs.map(p => p.code);
+        programSeats = {};
+        data.programs.forEach(p => { programSeats[p.code] = p.seats; });
+    } catch (e) {
+        return;
+    }
+
+    // Rebuild the selects that list every program
+    const selects = ['editPref1', 'editPref2', 'editPref3', 'editPref4', 'departmentSelect'];
+    selects.forEach(id => {
+        const select = document.getElementById(id);
+        if (!select) return;
+        while (select.options.length > 1) select.remove(1);
+        allDepartments.forEach(dept => select.add(new Option(dept, dept)));
+    });
+    updatePreferenceOptions();
+}
 
 function updatePreferenceOptions() {
     const prefSelects = [
@@ -483,7 +511,7 @@ async function savePreferences() {
         try {
             const response = await fetch(`${API_BASE}/api/applicants/${currentStudent.id}`, {
                 method: 'PUT',
-                headers: { 'Content-Type': 'application/json' },
+                headers: authHeaders({ 'Content-Type': 'application/json' }),
                 body: JSON.stringify({ pref: prefs })
             });
             const result = await response.json();
@@ -544,7 +572,7 @@ async function updatePassword() {
         try {
             const response = await fetch(`${API_BASE}/api/applicants/${currentStudent.id}`, {
                 method: 'PUT',
-                headers: { 'Content-Type': 'application/json' },
+                headers: authHeaders({ 'Content-Type': 'application/json' }),
                 body: JSON.stringify({ password: newPwd })
             });
             const result = await response.json();
@@ -572,8 +600,23 @@ async function updatePassword() {
     setTimeout(() => backToStudentDashboard(), 1000);
 }
 
+// Adds the session token, when there is one, to request headers
+function authHeaders(headers) {
+    if (sessionToken) headers['Authorization'] = `Bearer ${sessionToken}`;
+    return headers;
+}
+
+function endSession() {
+    if (useAPI && sessionToken) {
+        fetch(`${API_BASE}/api/logout`, { method: 'POST', headers: authHeaders({}) })
+            .catch(() => {});
+    }
+    sessionToken = null;
+}
+
 function studentLogout() {
     if (confirm('Are you sure you want to logout?')) {
+        endSession();
         currentStudent = null;
         backToMainMenu();
     }
@@ -712,20 +755,43 @@ function performSearchByName() {
     renderApplicantsTable(result, 'searchNameResult');
 }
 
-function viewMeritList() {
+// Seat fill and cutoff ranks kept by the server (GET /api/stats), or null
+async function fetchAdmissionStats() {
+    if (!useAPI) return null;
+    try {
+        const response = await fetch(`${API_BASE}/api/stats`);
+        if (response.ok) return (await response.json()).stats;
+    } catch (e) {
+        console.log('Stats fetch failed, counting locally');
+    }
+    return null;
+}
+
+async function viewMeritList() {
     loadApplicants();
     const selected = allApplicants.filter(a => a.allocated === 1);
     renderApplicantsTable(selected, 'meritListTable');
 
-    const deptCounts = { CSE: 0, IT: 0, TT: 0, APM: 0 };
-    selected.forEach(a => { if (deptCounts[a.department] !== undefined) deptCounts[a.department]++; });
+    const stats = await fetchAdmissionStats();
+    const deptCounts = {};
+    allDepartments.forEach(d => { deptCounts[d] = 0; });
+    const closing = {};
+    if (stats) {
+        stats.programs.forEach(p => {
+            deptCounts[p.program] = p.filled;
+            if (p.closing_rank !== null) closing[p.program] = p.closing_rank;
+        });
+    } else {
+        selected.forEach(a => { if (deptCounts[a.department] !== undefined) deptCounts[a.department]++; });
+    }
+    const total = stats ? stats.allocated : selected.length;
+    const label = d => closing[d] !== undefined ? `${d} (closing rank ${closing[d]})` : d;
 
     document.getElementById('meritStats').innerHTML = `
-        <div class="stat-card"><div class="stat-value">${selected.length}</div><div class="stat-label">Total Selected</div></div>
-        <div class="stat-card"><div class="stat-value">${deptCounts.CSE}</div><div class="stat-label">CSE</div></div>
-        <div class="stat-card"><div class="stat-value">${deptCounts.IT}</div><div class="stat-label">IT</div></div>
-        <div class="stat-card"><div class="stat-value">${deptCounts.TT}</div><div class="stat-label">TT</div></div>
-        <div class="stat-card"><div class="stat-value">${deptCounts.APM}</div><div class="stat-label">APM</div></div>
+        <div class="stat-card"><div class="stat-value">${total}</div><div class="stat-label">Total Selected</div></div>
+        ${allDepartments.map(d =>
+            `<div class="stat-card"><div class="stat-value">${deptCounts[d]}</div><div class="stat-label">${label(d)}</div></div>`
+        ).join('')}
     `;
     showScreen('meritListScreen');
 }
@@ -780,12 +846,13 @@ async function performGenerateMeritList() {
                 headers: { 'Content-Type': 'application/json' },
                 body: JSON.stringify({ algorithm: algorithm })
             });
-            const result = await response.json();
+            const started = await response.json();
+            const result = started.success ? await waitForMeritJob(started.job_id) : null;
 
-            if (result.success) {
+            if (result) {
                 showAlert('meritGenAlert',
                     `Merit list generated! ${result.allocated} students allocated across departments. ` +
-                    `(CSE: ${result.seats.CSE}, IT: ${result.seats.IT}, TT: ${result.seats.TT}, APM: ${result.seats.APM})`,
+                    `(${allDepartments.map(d => `${d}: ${result.seats[d]}`).join(', ')})`,
                     'success');
                 await loadApplicants();
                 setTimeout(() => backToAdminDashboard(), 2000);
@@ -806,16 +873,16 @@ async function performGenerateMeritList() {
     // Sort applicants by JEE rank (lower is better)
     allApplicants.sort((a, b) => a.jee_rank - b.jee_rank);
 
-    // Allocate departments (10 seats each)
-    const seatAlloc = { CSE: 0, IT: 0, TT: 0, APM: 0 };
-    const maxSeats = 10;
+    // Allocate departments (registry seats each)
+    const seatAlloc = {};
+    allDepartments.forEach(d => { seatAlloc[d] = 0; });
 
     for (let applicant of allApplicants) {
         applicant.allocated = 0;
         applicant.department = 'NA';
 
         for (let dept of applicant.pref) {
-            if (seatAlloc[dept] !== undefined && seatAlloc[dept] < maxSeats) {
+            if (seatAlloc[dept] !== undefined && seatAlloc[dept] < programSeats[dept]) {
                 seatAlloc[dept]++;
                 applicant.allocated = 1;
                 applicant.department = dept;
@@ -972,7 +1039,7 @@ async function updateApplicantAPI(id, data) {
         try {
             await fetch(`${API_BASE}/api/applicants/${id}`, {
                 method: 'PUT',
-                headers: { 'Content-Type': 'application/json' },
+                headers: authHeaders({ 'Content-Type': 'application/json' }),
                 body: JSON.stringify(data)
             });
         } catch (e) {
@@ -998,6 +1065,18 @@ async function registerStudentAPI(data) {
     return null;
 }
 
+// Poll a merit job until it finishes; resolves to its result or null
+async function waitForMeritJob(jobId, intervalMs = 500) {
+    while (true) {
+        const response = await fetch(`${API_BASE}/api/jobs/${jobId}`);
+        if (!response.ok) return null;
+        const job = await response.json();
+        if (job.phase === 'done') return { success: true, ...job.result };
+        if (job.phase === 'failed') return null;
+        await new Promise(resolve => setTimeout(resolve, intervalMs));
+    }
+}
+
 async function generateMeritAPI() {
     if (useAPI) {
         try {
@@ -1005,8 +1084,9 @@ async function generateMeritAPI() {
                 method: 'POST',
                 headers: { 'Content-Type': 'application/json' }
             });
-            const result = await response.json();
-            if (result.success) {
+            const started = await response.json();
+            const result = started.success ? await waitForMeritJob(started.job_id) : null;
+            if (result) {
                 await loadApplicants(); // Reload data
                 return result;
             }
@@ -1022,6 +1102,7 @@ async function generateMeritAPI() {
 // ============================================================
 window.addEventListener('load', async () => {
     await checkAPIAvailability();
+    if (useAPI) await loadPrograms();
     await loadApplicants();
 });
 
@@ -0,0 +1,52 @@
+#ifndef ADMISSION_STATS_H
+#define ADMISSION_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "student.h"
+
+/* ============================================================
+   ADMISSION STATISTICS
+   Seat fill, opening/closing JEE rank and first-preference
+   demand per program (department), overall and per category.
+   Kept up to date row by row as applicants change, so reading
+   them costs the same at any dataset size. Counts move by one
+   per change; a program's rank bounds are rescanned only when a
+   change releases its opening or closing rank (statsSettle), and
+   only for that program.
+   ============================================================ */
+
+typedef struct {
+    int filled;                // allotted seats
+    int demand;                // applicants with this first preference
+    int openRank;              // best allotted JEE rank, 0 when none
+    int closeRank;             // worst allotted JEE rank, 0 when none
+} StatsCell;
+
+typedef struct {
+    int seats;
+    StatsCell total;
+    StatsCell cat[CAT_COUNT];
+} ProgramStats;
+
+#define STATS_JSON_LEN (256 + MAX_PROGRAMS * 768)   // fits statsFormatJson() output
+#define STATS_DIRTY_WORDS ((MAX_PROGRAMS + 63) / 64)
+
+typedef struct {
+    int applicants;
+    int categories[CAT_COUNT];
+    int programs;              // departments counted
+    ProgramStats program[MAX_PROGRAMS];
+    int anyDirty;
+    uint64_t dirty[STATS_DIRTY_WORDS];  // bit d: program d's rank bounds are stale
+} AdmissionStats;
+
+void statsRebuild(AdmissionStats *s, const Applicant a[], int n);
+void statsApply(AdmissionStats *s, const Applicant *before, const Applicant *after);
+void statsSettle(AdmissionStats *s, const Applicant a[], int n);
+void statsReallocate(AdmissionStats *s, const Applicant a[], int n);
+
+int statsAllocated(const AdmissionStats *s);
+int statsFormatJson(const AdmissionStats *s, char *buf, size_t size);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef APPLICANT_TABLE_H
+#define APPLICANT_TABLE_H
+
+#include <limits.h>
+#include "student.h"
+#include "sorting.h"
+
+/* ============================================================
+   COLUMNAR APPLICANT TABLE
+   The fields of Applicant stored one contiguous array per field
+   (all in one allocation), so a pass that needs only ranks or
+   preferences streams just those bytes. The sort reads jee_rank
+   and marks, allocation reads pref and writes department and
+   allocated, and filters scan the code and range columns with
+   the kernels in scan_kernels.c. Rows are converted at the edges
+   with tableFromRows()/tableToRows(), and tableRow() gives a
+   single Applicant view for menus and JSON.
+   ============================================================ */
+
+typedef struct {
+    int count;
+    int capacity;
+    int *id;
+    int *marks;
+    int *jee_rank;
+    StrRef *name;
+    StrRef *password;
+    uint8_t *pref[PREF_COUNT];      // pref[p][i]: row i's choice p
+    uint8_t *category;
+    uint8_t *department;
+    uint8_t *allocated;
+} ApplicantTable;
+
+/* Row filter; -1 in a code field matches anything. Start from
+   TABLE_FILTER_ANY and set the fields to test. */
+typedef struct {
+    int category;       // Category
+    int department;     // department id or DEPT_NONE
+    int allocated;      // 1 selected, 0 waiting
+    int rankMin, rankMax;
+    int marksMin, marksMax;
+} TableFilter;
+
+#define TABLE_FILTER_ANY { -1, -1, -1, INT_MIN, INT_MAX, INT_MIN, INT_MAX }
+
+int tableInit(ApplicantTable *t, int capacity);
+void tableFree(ApplicantTable *t);
+int tableFromRows(ApplicantTable *t, const Applicant a[], int n);
+void tableToRows(const ApplicantTable *t, Applicant a[]);
+Applicant tableRow(const ApplicantTable *t, int i);
+
+int tableSort(ApplicantTable *t, SortAlgorithm algo, int threads);
+int tableFilter(const ApplicantTable *t, const TableFilter *f, int out[]);
+int tableCount(const ApplicantTable *t, const TableFilter *f);
+
+#endif
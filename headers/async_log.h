@@ -0,0 +1,31 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <stddef.h>
+
+/* ============================================================
+   ASYNCHRONOUS REQUEST LOG
+   Callers copy a fixed-size record into a bounded ring and return;
+   a background thread formats and writes records in batches. When
+   the ring is full new records are dropped and counted, and the
+   writer notes the loss in the log. The file is rotated to
+   NAME.1 .. NAME.<keep> by size and by age. asyncLogClose()
+   writes out what is still queued, so call it on shutdown after
+   the last thread that logs has finished.
+   ============================================================ */
+
+#define LOG_RING_SIZE 4096          /* records; power of two */
+#define LOG_FLUSH_MS 200            /* writer wakes at least this often */
+
+typedef struct {
+    size_t maxBytes;                /* rotate past this size, 0 = never */
+    int maxAgeSeconds;              /* rotate after this long, 0 = never */
+    int keep;                       /* rotated files kept */
+} LogRotation;
+
+int asyncLogOpen(const char *dir, const char *name, const LogRotation *rotation);
+void asyncLogWrite(const char *method, const char *uri, int status, const char *details);
+void asyncLogClose(void);
+unsigned long long asyncLogDropped(void);
+
+#endif
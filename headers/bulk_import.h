@@ -0,0 +1,62 @@
+#ifndef BULK_IMPORT_H
+#define BULK_IMPORT_H
+
+#include <stddef.h>
+#include "student.h"
+
+/* ============================================================
+   BULK APPLICANT IMPORT
+   Parses a stream of NDJSON objects or CSV rows, validating and
+   indexing each record as it arrives. Accepted records collect in
+   `rows` (with IDs assigned) for the caller to commit in one batch;
+   rejected rows are reported with their line number.
+   Input may be fed in chunks of any size.
+   ============================================================ */
+
+#define BULK_MAX_LINE 1024
+#define BULK_MAX_ERRORS 100
+#define BULK_MAX_COLUMNS 16
+#define BULK_ERROR_LEN 100       // one row's error message, with the NUL
+
+typedef enum {
+    BULK_NDJSON,
+    BULK_CSV
+} BulkFormat;
+
+typedef struct {
+    int line;
+    char error[BULK_ERROR_LEN];
+} BulkError;
+
+typedef struct {
+    BulkFormat format;
+
+    Applicant *rows;        // accepted records
+    int count;
+    int capacity;
+    int rejected;
+
+    BulkError errors[BULK_MAX_ERRORS];  // first BULK_MAX_ERRORS rejections
+    int nerrors;
+
+    int *ids;               // open-addressing set of IDs in use
+    int idSlots;
+    int idCount;
+    long nextId;            // may pass INT_MAX: checked before use
+
+    int line;               // current input line (1-based)
+    int headerSeen;         // CSV: header parsed
+    int columns[BULK_MAX_COLUMNS];
+    int ncolumns;
+
+    char carry[BULK_MAX_LINE];  // partial line between chunks
+    size_t carryLen;
+    int carryOverflow;
+} BulkImport;
+
+int bulkBegin(BulkImport *b, BulkFormat format, const Applicant *existing, int n);
+void bulkFeed(BulkImport *b, const char *buf, size_t len);
+void bulkFinish(BulkImport *b);
+void bulkFree(BulkImport *b);
+
+#endif
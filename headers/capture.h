@@ -0,0 +1,59 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* ============================================================
+   REQUEST CAPTURE LOG
+   Compact binary record of API traffic for later replay: a file
+   header, then one record per request holding its arrival offset,
+   server latency, status, method, URI and body. All integers are
+   little-endian as written by the capturing host.
+   ============================================================ */
+
+#define CAPTURE_MAGIC "ADMCAP01"
+#define CAPTURE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t startUnixUs;   /* wall clock when the capture began */
+} CaptureHeader;
+
+typedef struct {
+    uint64_t offsetUs;      /* arrival time since the capture began */
+    uint32_t latencyUs;     /* time the server spent handling it */
+    uint32_t bodyLen;
+    uint16_t status;
+    uint16_t uriLen;
+    uint8_t methodLen;
+    uint8_t reserved[3];
+} CaptureRecord;
+
+/* Writer (api_server) */
+int captureOpen(const char *path);
+int captureEnabled(void);
+uint64_t captureNowUs(void);
+void captureWrite(uint64_t arrivalUs, uint32_t latencyUs, int status,
+                  const char *method, size_t methodLen,
+                  const char *uri, size_t uriLen,
+                  const char *body, size_t bodyLen);
+void captureFlush(void);
+void captureClose(void);
+
+/* Reader (replay tool) */
+typedef struct {
+    CaptureRecord rec;
+    char method[256];
+    char *uri;              /* NUL-terminated; owned by the reader */
+    char *body;
+    size_t uriCap, bodyCap;
+} CaptureEntry;
+
+FILE *captureOpenRead(const char *path, CaptureHeader *h);
+int captureRead(FILE *fp, CaptureEntry *e);
+void captureEntryFree(CaptureEntry *e);
+
+#endif
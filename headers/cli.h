@@ -0,0 +1,6 @@
+#ifndef CLI_H
+#define CLI_H
+
+int cliMain(int argc, char *argv[]);
+
+#endif
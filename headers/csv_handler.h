@@ -3,8 +3,14 @@
 
 #include "student.h"
 
+#define CSV_UNREADABLE (-1)         // file missing or cannot be opened
+#define CSV_INVALID (-2)            // has a row that cannot be read, or too big to load
+
 int loadApplicants(Applicant a[]);
 void saveApplicants(Applicant a[], int n);
+int loadApplicantsFrom(const char *path, Applicant **out);
+int saveApplicantsTo(const char *path, Applicant a[], int n);
+int saveApplicantsDurable(const char *path, Applicant a[], int n);
 void loadAdminCredentials();
 void saveAdminCredentials();
 
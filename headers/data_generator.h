@@ -2,24 +2,59 @@
 #define DATA_GENERATOR_H
 
 #include <stdio.h>
+#include <stdint.h>
+#include "student.h"
 
-#define MAX_NAME_LEN 100
-#define MAX_PASS_LEN 16
-#define PREF_COUNT 4
+/* Longest CSV line write_applicant_csv can produce */
+#define MAX_CSV_LINE 256
 
+/* A generated applicant: the record itself, with the name and
+   password kept as text beside it. Rows are written straight out,
+   so the generator never interns them. */
 typedef struct {
-    int id;
-    char name[MAX_NAME_LEN];
-    char password[MAX_PASS_LEN];
-    char category[4];
-    char pref[PREF_COUNT][4];
-    char department[4];
-    int marks;
-    int jee_rank;
-    int allocated;
-} Applicant;
-
-void generate_applicant(Applicant *a);
-void write_applicant_csv(FILE *fp, const Applicant *a);
+    Applicant a;            /* name and password handles left at 0 */
+    char name[NAME_LEN];
+    char password[PASSWORD_LEN];
+} GenRow;
+
+/* Counter-based random stream: output i is a hash of (key, i), so any
+   row's stream can be recreated from the seed alone, on any thread. */
+typedef struct {
+    uint64_t key;
+    uint64_t counter;
+} GenRng;
+
+void gen_rng_init(GenRng *r, uint64_t seed, uint64_t stream);
+uint64_t gen_rng_next(GenRng *r);
+uint32_t gen_rng_below(GenRng *r, uint32_t n);
+
+uint64_t gen_unique_id_index(uint64_t index, uint64_t total, uint64_t seed);
+
+/* ============================================================
+   WORKLOAD PROFILES
+   Shape of the generated marks, ranks and preferences. Start from
+   a named profile and override individual parameters.
+   ============================================================ */
+typedef struct {
+    const char *name;
+    int rank_range;      /* ranks drawn from [1, rank_range] */
+    int tie_buckets;     /* > 0: ranks collapse onto this many values */
+    double correlation;  /* 0..1: how closely marks track rank */
+    int mark_levels;     /* 0 or 2..101: marks rounded onto this many values */
+    double skew;         /* department popularity exponent, 0 = even */
+    int min_prefs;       /* preference lists hold min_prefs..4 entries */
+    int presorted;       /* ranks ascend with row index */
+} GenProfile;
+
+int gen_profile_lookup(const char *name, GenProfile *out);
+int gen_profile_set(GenProfile *p, const char *key, const char *value);
+const char *gen_profile_names(void);
+
+void generate_applicant(GenRow *r, GenRng *rng, const GenProfile *p,
+                        uint64_t row, uint64_t total);
+void generate_row(GenRow *r, const GenProfile *p, uint64_t seed,
+                  uint64_t row, uint64_t total);
+int format_applicant_csv(char *buf, const GenRow *r);
+void write_applicant_csv(FILE *fp, const GenRow *r);
 
 #endif
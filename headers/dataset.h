@@ -0,0 +1,49 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "student.h"
+#include "admission_stats.h"
+
+/* ============================================================
+   RESIDENT APPLICANT DATASET (RCU-STYLE)
+   Readers take a lock-free snapshot with datasetAcquire() and
+   must call datasetRelease() when done. A snapshot never changes.
+   Writers copy the current version (datasetBeginWrite), modify
+   the copy, and publish it atomically (datasetPublish). Old
+   versions are freed once no reader can still hold them.
+   Every version carries its admission statistics: writers report
+   each row they add or change with statsApply(&v->stats, ...),
+   and publishing settles them.
+   ============================================================ */
+
+typedef struct DatasetVersion {
+    unsigned long version;          // increases with every publish
+    int count;
+    int capacity;
+    Applicant *rows;
+    int *id_slots;                  // id -> row + 1 hash, built on publish
+    unsigned int id_mask;
+    AdmissionStats stats;           // of rows[], settled on publish
+    unsigned long retire_epoch;     // set when replaced
+    struct DatasetVersion *next_retired;
+} DatasetVersion;
+
+int datasetInit(const char *path);
+void datasetShutdown(void);
+
+const DatasetVersion *datasetAcquire(void);
+void datasetRelease(const DatasetVersion *v);
+unsigned long datasetCurrentVersion(void);
+const Applicant *datasetFindById(const DatasetVersion *v, long id);
+
+DatasetVersion *datasetBeginWrite(int extra);
+void datasetPublish(DatasetVersion *v);
+int datasetPublishDurable(DatasetVersion *v);
+void datasetAbortWrite(DatasetVersion *v);
+
+int datasetRefreshIfChanged(void);
+void datasetReclaim(void);
+int datasetRetiredCount(void);
+void datasetThreadExit(void);
+
+#endif
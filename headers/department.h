@@ -1,9 +1,41 @@
 #ifndef DEPARTMENT_H
 #define DEPARTMENT_H
 
+#include <stddef.h>
+#include "student.h"
+
+/* ============================================================
+   PROGRAM REGISTRY
+   The programs (departments) applicants choose between, read
+   from PROGRAMS_FILE, or the file named by $ADM_PROGRAMS:
+     Code,Seats,Name
+     CSE,10,Computer Science and Engineering
+   Program ids are dense, 0..programCount()-1 in file order, and
+   fit the byte codes of an Applicant (up to MAX_PROGRAMS). Codes
+   map to ids through an open-addressing hash built at load and
+   kept at most half full, so a lookup is one hash and usually a
+   single compare. Without a file the four built-in programs are
+   used. Load before starting any threads; the registry is read
+   without locks afterwards.
+   ============================================================ */
+
+#define PROGRAMS_FILE "programs.csv"
+#define PROGRAM_CODE_LEN 12            // longest code + 1
+#define PROGRAM_NAME_LEN 64            // longest name + 1
+#define MAX_PROGRAM_SEATS 1000000
+
+int programsInit(void);
+int programsLoad(const char *path, char *err, size_t errSize);
+int programCount(void);
+int programSeats(int index);
+unsigned int programsFingerprint(void);
+
 void listDepartments();
+int readDepartmentChoice(void);
 int isValidDepartment(char dept[]);
 int getDeptIndex(char dept[]);
+int parseDepartment(const char *code);
 char* getDeptName(int index);
+char* getDeptCode(int index);
 
 #endif
@@ -0,0 +1,54 @@
+#ifndef JSON_REQUEST_H
+#define JSON_REQUEST_H
+
+#include <stddef.h>
+
+/* ============================================================
+   SINGLE-PASS JSON REQUEST PARSER
+   Parses one flat JSON object in a single linear scan without
+   allocating or copying. Values are returned as views into the
+   request buffer (which need not be NUL-terminated) and checked
+   against a per-endpoint schema: type, required, maximum length.
+   ============================================================ */
+
+#define JSON_MAX_ITEMS 8
+
+typedef struct {
+    const char *ptr;    // raw bytes between the quotes (still escaped)
+    size_t len;
+} JsonView;
+
+typedef enum {
+    JSON_STRING,
+    JSON_INT,
+    JSON_STRING_ARRAY
+} JsonType;
+
+typedef struct {
+    const char *name;
+    JsonType type;
+    int required;
+    size_t max_len;     // strings / array elements, after unescaping
+    int max_items;      // arrays only
+} JsonField;
+
+typedef struct {
+    int present;
+    JsonView str;                   // JSON_STRING
+    long num;                       // JSON_INT
+    JsonView items[JSON_MAX_ITEMS]; // JSON_STRING_ARRAY
+    int count;
+} JsonValue;
+
+int jsonParseRequest(const char *buf, size_t len,
+                     const JsonField *schema, int nfields,
+                     JsonValue *out, char *err, size_t errlen);
+int jsonCopyString(char *dst, size_t size, JsonView v);
+int jsonViewEquals(JsonView v, const char *s);
+
+/* Response building: append to a fixed buffer, tracking the length
+   the output would need (see json_request.c) */
+void jsonAppend(char *buf, size_t size, size_t *len, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+#endif
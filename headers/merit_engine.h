@@ -0,0 +1,17 @@
+#ifndef MERIT_ENGINE_H
+#define MERIT_ENGINE_H
+
+#include "student.h"
+#include "department.h"
+#include "applicant_table.h"
+
+/* Allocation progress callback: rows processed so far out of n */
+typedef void (*MeritProgressFn)(void *ctx, int done, int n);
+
+int allocateSeats(Applicant a[], int n, int seats[MAX_PROGRAMS],
+                  MeritProgressFn progress, void *ctx);
+int allocateTableSeats(ApplicantTable *t, int seats[MAX_PROGRAMS],
+                       MeritProgressFn progress, void *ctx);
+int writeMeritList(const char *path, Applicant a[], int n);
+
+#endif
@@ -6,5 +6,6 @@ void viewMeritList();
 void viewCategoryWiseMeritList();
 void viewDepartmentWiseMeritList();
 void viewWaitingList();
+void viewAdmissionStats();
 
 #endif
@@ -0,0 +1,73 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================
+   SERVER METRICS
+   Counters and log-linear latency histograms kept per thread:
+   each thread only ever writes its own shard (plain relaxed
+   stores, no locked instructions), and readers sum the shards.
+   Rendered in Prometheus text format for /metrics and the
+   periodic dump file.
+   ============================================================ */
+
+typedef enum {
+    METRIC_ROUTE_APPLICANTS,
+    METRIC_ROUTE_BULK,
+    METRIC_ROUTE_UPDATE,
+    METRIC_ROUTE_LOGIN_STUDENT,
+    METRIC_ROUTE_LOGIN_ADMIN,
+    METRIC_ROUTE_SESSION,
+    METRIC_ROUTE_LOGOUT,
+    METRIC_ROUTE_REGISTER,
+    METRIC_ROUTE_GENERATE_MERIT,
+    METRIC_ROUTE_JOB_STATUS,
+    METRIC_ROUTE_QUERY,
+    METRIC_ROUTE_STATS,
+    METRIC_ROUTE_PREDICT,
+    METRIC_ROUTE_PROGRAMS,
+    METRIC_ROUTE_METRICS,
+    METRIC_ROUTE_PREFLIGHT,
+    METRIC_ROUTE_STATIC,
+    METRIC_ROUTE_COUNT
+} MetricRoute;
+
+/* Merit job phases, same order as the job's phase_ms[] */
+typedef enum {
+    METRIC_PHASE_LOAD,
+    METRIC_PHASE_SORT,
+    METRIC_PHASE_ALLOCATE,
+    METRIC_PHASE_PERSIST,
+    METRIC_PHASE_COUNT
+} MetricPhase;
+
+typedef enum {
+    METRIC_MERIT_CACHE_HIT,     /* generate-merit answered from the last run */
+    METRIC_MERIT_CACHE_MISS,    /* generate-merit started a new job */
+    METRIC_MERIT_JOINED,        /* generate-merit attached to a running job */
+    METRIC_MERIT_RETRIES,
+    METRIC_MERIT_FAILED,
+    METRIC_REQUEST_BYTES,
+    METRIC_RATE_LIMITED,        /* answered 429 by a token bucket */
+    METRIC_SHED,                /* answered 503 by admission control */
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+/* Point-in-time values supplied by the caller when rendering */
+typedef struct {
+    const char *name;
+    const char *help;
+    double value;
+} MetricGauge;
+
+void metricsObserveRequest(MetricRoute route, int status, uint64_t latencyUs);
+void metricsObservePhase(MetricPhase phase, uint64_t us);
+void metricsCount(MetricCounter counter, uint64_t n);
+void metricsThreadExit(void);
+
+char *metricsRender(const MetricGauge *gauges, int ngauges, size_t *len);
+int metricsDumpFile(const char *path, const MetricGauge *gauges, int ngauges);
+
+#endif
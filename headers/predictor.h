@@ -0,0 +1,44 @@
+#ifndef PREDICTOR_H
+#define PREDICTOR_H
+
+#include <stdint.h>
+#include "student.h"
+
+/* ============================================================
+   WHAT-IF ALLOCATION PREDICTOR
+   "With this rank, which department would I get?" answered from
+   the current allocation, without rerunning it. The index holds
+   every applicant's merit key in sorted order and, per department,
+   the sorted keys of the applicants it admitted. Allocation walks
+   the merit order greedily, so the applicants ahead of a new one
+   keep their seats: a preference is available when fewer than its
+   seats went to applicants ranked ahead. That is one binary search
+   per preference, O(PREF_COUNT log n). Exact for the allocation as
+   last run; applicants added since then are not placed until the
+   next merit run.
+   ============================================================ */
+
+typedef struct {
+    int count;                                   // applicants indexed
+    unsigned long long *keys;                    // all merit keys, sorted
+    int programs;                                // departments indexed
+    unsigned long long *admitted[MAX_PROGRAMS];  // admits' keys, sorted
+    int filled[MAX_PROGRAMS];
+    int seats[MAX_PROGRAMS];
+    int closeRank[MAX_PROGRAMS][CAT_COUNT + 1];  // worst admitted rank; [CAT_COUNT] = all
+} Predictor;
+
+typedef struct {
+    int department;            // predicted department, or DEPT_NONE
+    int preference;            // 1-based preference it meets, 0 for none
+    int meritPosition;         // 1-based place among the indexed applicants
+    int ahead[PREF_COUNT];     // admits of each preference ranked ahead
+} Prediction;
+
+int predictorBuild(Predictor *p, const Applicant a[], int n);
+void predictorFree(Predictor *p);
+void predictAllocation(const Predictor *p, int jeeRank, int marks,
+                       const uint8_t pref[PREF_COUNT], const Applicant *self,
+                       Prediction *out);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stddef.h>
+#include "applicant_table.h"
+#include "scan_kernels.h"
+
+/* ============================================================
+   AD-HOC APPLICANT QUERIES
+   [SELECT] agg, ... [WHERE cond AND ...] [GROUP BY field]
+     agg:   COUNT | MIN(f) | MAX(f) | AVG(f) | SUM(f)
+            f is id, marks or jee_rank (default: COUNT)
+     cond:  field op value, op one of = != < <= > >=
+            (codes only take = and !=)
+     group: category, department, allocated or pref1..pref4
+   Fields: id, marks, jee_rank (rank), category, department
+   (dept, program), allocated (status), pref1..pref4. Keywords
+   and codes are case-insensitive; allocated takes 1/0 or
+   SELECTED/WAITING.
+   e.g. count, avg(marks) where category = OBC and marks > 80
+        and pref1 = TT group by department
+   Each condition becomes one kernel pass over its column that
+   narrows a selection bitmap; each group and aggregate is
+   another pass over the selected rows.
+   ============================================================ */
+
+#define QUERY_MAX_TERMS 16
+#define QUERY_MAX_AGGS 8
+#define QUERY_MAX_GROUPS (DEPT_NONE + 1)   // largest code domain
+#define QUERY_JSON_LEN (64 + QUERY_MAX_GROUPS * (64 + QUERY_MAX_AGGS * 48))  // fits any result
+
+typedef enum {
+    QF_ID,
+    QF_MARKS,
+    QF_JEE_RANK,
+    QF_CATEGORY,
+    QF_DEPARTMENT,
+    QF_ALLOCATED,
+    QF_PREF1,                  // QF_PREF1 + p for choice p
+    QF_COUNT = QF_PREF1 + PREF_COUNT
+} QueryField;
+
+typedef enum { QOP_EQ, QOP_NE, QOP_LT, QOP_LE, QOP_GT, QOP_GE } QueryOp;
+typedef enum { AGG_COUNT, AGG_MIN, AGG_MAX, AGG_AVG, AGG_SUM } QueryAggKind;
+
+typedef struct {
+    QueryField field;
+    QueryOp op;
+    int value;                 // number or code
+} QueryTerm;
+
+typedef struct {
+    QueryAggKind kind;
+    QueryField field;          // unused for AGG_COUNT
+} QueryAgg;
+
+typedef struct {
+    QueryTerm terms[QUERY_MAX_TERMS];
+    int termCount;
+    QueryAgg aggs[QUERY_MAX_AGGS];
+    int aggCount;
+    int groupBy;               // QueryField, or -1 for one group
+} Query;
+
+typedef struct {
+    int key;                   // group code, -1 without GROUP BY
+    long long count;
+    ScanAgg agg[QUERY_MAX_AGGS];
+} QueryGroup;
+
+typedef struct {
+    int rows;
+    int matched;
+    int groupCount;            // non-empty groups, in code order
+    QueryGroup groups[QUERY_MAX_GROUPS];
+} QueryResult;
+
+int queryParse(const char *text, Query *q, char *err, size_t errSize);
+int queryRun(const Query *q, const ApplicantTable *t, QueryResult *r);
+int queryFormatJson(const Query *q, const QueryResult *r, char *buf, size_t size);
+
+#endif
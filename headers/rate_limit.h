@@ -0,0 +1,47 @@
+#ifndef RATE_LIMIT_H
+#define RATE_LIMIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   RATE LIMITING AND ADMISSION CONTROL (API SERVER)
+   Token buckets refill continuously at `rate` tokens per second up
+   to `burst`; each request takes one token. Client buckets are kept
+   per client address and route in a fixed table, so memory is
+   bounded however many clients connect. Admission control caps
+   expensive work two ways: a count of operations in flight
+   (including background merit jobs) and a budget of event-loop time
+   spent in expensive handlers per second. Buckets, the client table
+   and the time budget belong to the event-loop thread; the in-flight
+   count is atomic.
+   ============================================================ */
+
+#define RATE_CLIENT_SLOTS 4096      /* power of two */
+#define RATE_MAX_ROUTES 32          /* at least the caller's route count */
+
+typedef struct {
+    double rate;                    /* tokens per second, 0 = unlimited */
+    double burst;
+} RateLimit;
+
+typedef struct {
+    double tokens;
+    uint64_t lastUs;                /* 0 = never used: starts full */
+} TokenBucket;
+
+/* 1 if a token was taken, else 0 with *retryAfter seconds to wait */
+int tokenBucketTake(TokenBucket *b, const RateLimit *limit, uint64_t nowUs, int *retryAfter);
+/* Gives back a token taken for a request that was not served after all */
+void tokenBucketRefund(TokenBucket *b, const RateLimit *limit);
+
+TokenBucket *rateClientBucket(const uint8_t *addr, size_t len, int route, uint64_t nowUs);
+
+void admissionInit(int maxInFlight, uint64_t budgetUsPerSecond);
+int admissionTryEnter(void);
+void admissionLeave(void);
+int admissionInFlight(void);
+void admissionCharge(uint64_t busyUs, uint64_t nowUs);
+int admissionOverBudget(uint64_t nowUs);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SCAN_KERNELS_H
+#define SCAN_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   COLUMN SCAN KERNELS
+   Equality and range predicates over table columns, producing
+   selection bitmaps (bit i of word i / 64 is row i; bits past
+   the last row are zero) or plain counts, and count/sum/min/max
+   of an int column over a selection. The SIMD version is
+   picked once at run time from what the CPU supports: AVX-512BW,
+   AVX2, SSE2, or the scalar fallback on other machines.
+   ADM_SIMD=scalar|sse2|avx2|avx512 caps the choice, for
+   benchmarking and for checking the paths against each other.
+   ============================================================ */
+
+typedef enum {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2,
+    SCAN_AVX512
+} ScanLevel;
+
+#define BITMAP_WORDS(n) (((size_t) (n) + 63) / 64)
+
+/* count/sum/min/max of the selected values; min and max are only
+   meaningful when count > 0 */
+typedef struct {
+    long long count;
+    long long sum;
+    int min, max;
+} ScanAgg;
+
+ScanLevel scanLevel(void);
+const char *scanLevelName(ScanLevel level);
+
+void scanEqU8(const uint8_t *col, int n, uint8_t value, uint64_t bits[]);
+void scanRangeI32(const int *col, int n, int lo, int hi, uint64_t bits[]);
+int countEqU8(const uint8_t *col, int n, uint8_t value);
+void aggregateI32(const int *col, int n, const uint64_t bits[], ScanAgg *agg);
+
+void bitmapFill(uint64_t bits[], int n);
+void bitmapAnd(uint64_t dst[], const uint64_t src[], int n);
+void bitmapAndNot(uint64_t dst[], const uint64_t src[], int n);
+int bitmapCount(const uint64_t bits[], int n);
+int bitmapRows(const uint64_t bits[], int n, int out[]);
+
+#endif
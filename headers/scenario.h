@@ -0,0 +1,58 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <stddef.h>
+#include "student.h"
+#include "applicant_table.h"
+
+/* ============================================================
+   SEAT-MATRIX SCENARIOS
+   Reruns allocation under many seat matrices and rules for
+   capacity planning. Every scenario walks the same read-only
+   table in merit order, which is sorted once, so scenarios run
+   side by side on worker threads and each one writes only its
+   own summary. Each summary also counts the applicants who
+   gain, lose or change a seat compared with the baseline (the
+   default allocation, each program's registry seats open).
+   One scenario per line:
+     name [DEPT=seats ...] [DEPT.CAT=reserved ...] [prefs=N]
+   DEPT=seats sets a program's seats (default from the registry),
+   DEPT.CAT=n reserves n of them for a category and leaves the
+   rest open, prefs=N honours only the first N preferences.
+   e.g. cse-grows CSE=20 CSE.SC=3 CSE.ST=2 prefs=3
+   An applicant takes an open seat in a preference when one is
+   left, otherwise a seat reserved for their category.
+   ============================================================ */
+
+#define SCENARIO_NAME_LEN 32
+
+typedef struct {
+    char name[SCENARIO_NAME_LEN];
+    int seats[MAX_PROGRAMS];
+    int reserved[MAX_PROGRAMS][CAT_COUNT];
+    int prefs;                 // preferences honoured, 1..PREF_COUNT
+} Scenario;
+
+typedef struct {
+    int filled;
+    int reservedFilled;        // of filled, seats taken from a reservation
+    int openRank;              // best admitted JEE rank, 0 when none
+    int closeRank;             // worst admitted JEE rank, 0 when none
+} ScenarioProgram;
+
+typedef struct {
+    int admitted;
+    int gained;                // admitted here, waiting in the baseline
+    int lost;                  // admitted in the baseline, waiting here
+    int moved;                 // admitted to another program than in the baseline
+    int categoryAdmitted[CAT_COUNT];
+    ScenarioProgram program[MAX_PROGRAMS];
+    double ms;
+} ScenarioResult;
+
+void scenarioDefault(Scenario *s, const char *name);
+int scenarioParse(const char *line, Scenario *s, char *err, size_t errSize);
+int scenarioRunAll(const ApplicantTable *t, const Scenario sc[], int count,
+                   ScenarioResult *baseline, ScenarioResult out[], int threads);
+
+#endif
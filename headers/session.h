@@ -0,0 +1,49 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stddef.h>
+#include <time.h>
+
+/* ============================================================
+   LOGIN SESSIONS AND ADMIN CREDENTIALS (API SERVER)
+   Admin credentials are loaded once into a hash table keyed by
+   EmpID and reloaded when the file changes on disk. A successful
+   login issues a random opaque token. The session table is an
+   open-addressing hash, so checking a token costs a few probes,
+   and each use pushes the expiry forward. It starts at
+   SESSION_CAPACITY slots, clears expired sessions and doubles when
+   a login finds no room; only at SESSION_MAX_CAPACITY is a login
+   refused, never by ending someone else's session. Not
+   thread-safe: call these from the event-loop thread only.
+   ============================================================ */
+
+#define SESSION_TOKEN_LEN 32        /* hex characters */
+#define SESSION_TTL_SECONDS (30 * 60)
+#define SESSION_CAPACITY 8192       /* initial slots, power of two */
+#define SESSION_MAX_CAPACITY (1u << 20) /* ~160 MB of sessions at most */
+
+typedef enum {
+    SESSION_STUDENT = 1,
+    SESSION_ADMIN
+} SessionRole;
+
+typedef struct {
+    char token[SESSION_TOKEN_LEN + 1];  /* empty = free slot */
+    SessionRole role;
+    long subjectId;                 /* applicant ID or EmpID */
+    char name[100];                 /* admin username */
+    time_t expires;
+} Session;
+
+int credentialsLoad(const char *path);
+int credentialsRefreshIfChanged(void);
+int credentialsCheckAdmin(long empId, const char *username, const char *password);
+int credentialsCount(void);
+
+const Session *sessionCreate(SessionRole role, long subjectId, const char *name);
+const Session *sessionLookup(const char *token, size_t len);
+int sessionRevoke(const char *token, size_t len);
+void sessionRevokeSubject(SessionRole role, long subjectId, const Session *keep);
+int sessionCount(void);
+
+#endif
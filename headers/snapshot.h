@@ -0,0 +1,40 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "student.h"
+
+/* ============================================================
+   BINARY APPLICANT SNAPSHOT
+   Header followed by chunks of up to SNAPSHOT_CHUNK_ROWS records.
+   Each chunk is a SnapshotChunk, the raw Applicant records, then
+   the chunk's strings (NUL-terminated); in the file a record's
+   name and password are byte offsets into those strings, and they
+   are interned again on load. Loads and saves with a few large
+   reads/writes per chunk instead of parsing text. Only valid
+   between builds with the same Applicant layout, and with the
+   same program registry since departments are stored as ids
+   (both checked).
+   ============================================================ */
+
+#define SNAPSHOT_MAGIC "ADMSNAP3"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_CHUNK_ROWS 16384
+
+typedef struct {
+    uint32_t rows;
+    uint32_t stringBytes;
+} SnapshotChunk;
+
+/* Largest chunk of `rows` records, header and strings included */
+#define SNAPSHOT_CHUNK_BOUND(rows) \
+    (sizeof(SnapshotChunk) + (size_t) (rows) * (sizeof(Applicant) + NAME_LEN + PASSWORD_LEN))
+
+int writeSnapshotHeader(FILE *fp, uint64_t count);
+int saveSnapshot(const char *path, Applicant a[], int n);
+int loadSnapshot(const char *path, Applicant **out);
+int isSnapshotFile(const char *path);
+int loadApplicantsAuto(const char *path, Applicant **out);
+
+#endif
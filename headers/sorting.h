@@ -1,12 +1,56 @@
 #ifndef SORTING_H
 #define SORTING_H
 
+#include <stdio.h>
 #include "student.h"
 
+#define MAX_SORT_THREADS 64
+
+typedef enum {
+    SORT_SELECTION = 1,
+    SORT_INSERTION,
+    SORT_MERGE,
+    SORT_QUICK,
+    SORT_RADIX
+} SortAlgorithm;
+
+/* Sort work counters, collected only while enabled at run time.
+   Building with -DSORT_STATS=0 compiles the counting out. */
+#ifndef SORT_STATS
+#define SORT_STATS 1
+#endif
+
+typedef struct {
+    unsigned long long comparisons;     /* key comparisons */
+    unsigned long long moves;           /* merit key copies */
+    unsigned long long bytesCopied;     /* keys and the final record moves */
+    unsigned long long allocations;     /* scratch buffers malloc'd */
+    unsigned long long bytesAllocated;
+} SortStats;
+
+/* Sort item: the merit key of a row and the row's index */
+typedef struct {
+    unsigned long long key;
+    int index;
+} MeritKey;
+
 int isBetter(Applicant a, Applicant b);
-void selectionSort(Applicant a[], int n);
-void insertionSort(Applicant a[], int n);
-void quickSort(Applicant a[], int low, int high);
-void mergeSort(Applicant a[], int l, int r);
+unsigned long long meritKey(int jeeRank, int marks);
+int sortMeritKeys(MeritKey k[], int n, SortAlgorithm algo, int threads);
+
+int selectionSort(Applicant a[], int n);
+int insertionSort(Applicant a[], int n);
+int quickSort(Applicant a[], int low, int high);
+int mergeSort(Applicant a[], int l, int r);
+int radixSort(Applicant a[], int n);
+
+int sortApplicants(Applicant a[], int n, SortAlgorithm algo, int threads);
+const char *sortAlgorithmName(SortAlgorithm algo);
+SortAlgorithm parseSortAlgorithm(const char *name);
+
+void sortStatsEnable(int on);
+void sortStatsReset(void);
+SortStats sortStatsGet(void);
+void sortStatsPrint(FILE *fp, const SortStats *s);
 
 #endif
@@ -0,0 +1,25 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+   INTERNED STRING ARENA
+   Names and passwords are kept once per distinct value in large
+   append-only blocks and referred to by a 32-bit handle. Blocks
+   never move, so a handle stays valid for the life of the process
+   and reading it takes no lock; interning takes a mutex. Equal
+   strings always get the same handle.
+   ============================================================ */
+
+typedef uint32_t StrRef;            /* 0 = the empty string */
+
+#define STR_MAX_LEN 255             /* longer strings are truncated */
+
+StrRef arenaIntern(const char *s);
+StrRef arenaInternN(const char *s, size_t len);
+const char *arenaGet(StrRef ref);
+void arenaStats(size_t *strings, size_t *bytes);
+
+#endif
@@ -1,19 +1,52 @@
 #ifndef STUDENT_H
 #define STUDENT_H
 
+#include <stdint.h>
+#include "string_arena.h"
+
 #define MAX 1000
-#define PREF_COUNT 4   // CSE, IT, TT, APM
+#define PREF_COUNT 4   // ranked program choices per applicant
+
+#define NAME_LEN 50            // longest name + 1
+#define PASSWORD_LEN 20        // longest password + 1
+
+typedef enum {
+    CAT_GEN,
+    CAT_OBC,
+    CAT_SC,
+    CAT_ST,
+    CAT_COUNT
+} Category;
+
+/* Departments (programs) are ids into the program registry
+   (department.h), 0..programCount()-1 */
+#define MAX_PROGRAMS 254
+#define DEPT_NONE 255          // no preference / not allotted ("NA")
 
+/* Codes are small integers and the name and password are handles
+   into the string arena; the text forms only appear when reading
+   or writing CSV, JSON and the console. */
 typedef struct {
     int id;
-    char name[50];
-    char password[20];
-    char category[5];          // GEN/OBC/SC/ST
-    char pref[PREF_COUNT][5];  // Preferences: pref[0] highest
-    char department[5];        // ALLOTTED department
     int marks;
     int jee_rank;              // FIXED NAME (no space)
-    int allocated;             // 1 = Selected, 0 = Waiting
+    StrRef name;
+    StrRef password;
+    uint8_t category;          // Category
+    uint8_t pref[PREF_COUNT];  // department id; pref[0] highest
+    uint8_t department;        // ALLOTTED department or DEPT_NONE
+    uint8_t allocated;         // 1 = Selected, 0 = Waiting
 } Applicant;
 
+const char *categoryCode(int category);
+int parseCategory(const char *code);
+
+static inline const char *applicantName(const Applicant *a) {
+    return arenaGet(a->name);
+}
+
+static inline const char *applicantPassword(const Applicant *a) {
+    return arenaGet(a->password);
+}
+
 #endif
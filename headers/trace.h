@@ -0,0 +1,36 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* ============================================================
+   PHASE TRACING
+   traceBegin/traceEnd bracket a phase on the calling thread. The
+   clock is always read so callers can use the returned duration
+   for their own timings; spans are only recorded while tracing is
+   enabled. Recorded spans go to a fixed ring (oldest overwritten)
+   and can be exported as Chrome trace-event JSON (chrome://tracing,
+   Perfetto) or summarised as a table.
+   ============================================================ */
+
+#define TRACE_CAPACITY 16384        /* spans kept; power of two */
+
+typedef struct {
+    const char *name;               /* string literal, not copied */
+    uint64_t startUs;
+    long long n;                    /* items processed, -1 = not shown */
+} TraceSpan;
+
+void traceEnable(int on);
+int traceEnabled(void);
+
+TraceSpan traceBegin(const char *name);
+double traceEnd(TraceSpan *span);   /* returns the span length in ms */
+
+/* Position to export from; spans recorded later come after it */
+unsigned long traceMark(void);
+int traceWriteChrome(const char *path, unsigned long from);
+void tracePrintSummary(FILE *fp, unsigned long from);
+
+#endif
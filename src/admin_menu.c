@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "student.h"
+#include "department.h"
 #include "admin_menu.h"
 #include "applicant_ops.h"
 #include "csv_handler.h"
@@ -34,7 +35,8 @@ void adminMenu() {
         printf("4. View Waiting List\n");
         printf("5. View Category-wise Merit List\n");
         printf("6. View Department-wise Merit List\n");
-        printf("7. Logout\n");
+        printf("7. View Admission Statistics\n");
+        printf("8. Logout\n");
         printf("-------------------------------------------------\n");
         printf("Enter your choice: ");
         scanf("%d", &ch);
@@ -85,22 +87,23 @@ void adminMenu() {
                 break;
 
             case 6:
-                printf("\n1 CSE\n");
-                printf("2 IT\n");
-                printf("3 TT\n");
-                printf("4 APM\n");
-                printf("Enter sub-choice: ");
-                scanf("%d", &sub);
+                listDepartments();
+                printf("Enter department (number or code): ");
+                sub = readDepartmentChoice();
                 getchar();
 
-                if (sub >= 1 && sub <= 4) {
-                    viewDepartmentWiseMeritList(sub);
+                if (sub >= 0) {
+                    viewDepartmentWiseMeritList(sub + 1);
                 } else {
                     printError("Invalid choice!");
                 }
                 break;
 
             case 7:
+                viewAdmissionStats();
+                break;
+
+            case 8:
                 printf("Logging out from admin menu...\n");
                 return;
 
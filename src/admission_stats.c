@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <string.h>
+#include "student.h"
+#include "department.h"
+#include "json_request.h"
+#include "admission_stats.h"
+
+#define DIRTY_BIT(d) (1ull << ((d) % 64))
+
+static int isDirty(const AdmissionStats *s, int d) {
+    return (s->dirty[d / 64] & DIRTY_BIT(d)) != 0;
+}
+
+static void markDirty(AdmissionStats *s, int d) {
+    s->dirty[d / 64] |= DIRTY_BIT(d);
+    s->anyDirty = 1;
+}
+
+/* ============ CELL UPDATES ============ */
+static void allotCell(StatsCell *c, int rank) {
+    if (c->filled == 0 || rank < c->openRank) c->openRank = rank;
+    if (c->filled == 0 || rank > c->closeRank) c->closeRank = rank;
+    c->filled++;
+}
+
+/* Returns 1 when the rank was one of the bounds, which are then
+   unknown until the program is rescanned */
+static int releaseCell(StatsCell *c, int rank) {
+    if (--c->filled == 0) {
+        c->openRank = c->closeRank = 0;
+        return 0;
+    }
+    return rank == c->openRank || rank == c->closeRank;
+}
+
+static void countRow(AdmissionStats *s, const Applicant *a, int delta) {
+    int first = a->pref[0];
+
+    s->applicants += delta;
+    s->categories[a->category] += delta;
+    if (first < s->programs) {
+        s->program[first].total.demand += delta;
+        s->program[first].cat[a->category].demand += delta;
+    }
+
+    if (!a->allocated || a->department >= s->programs) return;
+    ProgramStats *p = &s->program[a->department];
+    if (delta > 0) {
+        allotCell(&p->total, a->jee_rank);
+        allotCell(&p->cat[a->category], a->jee_rank);
+    } else if (releaseCell(&p->total, a->jee_rank) |
+               releaseCell(&p->cat[a->category], a->jee_rank)) {
+        markDirty(s, a->department);
+    }
+}
+
+/* Do two versions of a row count the same everywhere? */
+static int sameCounts(const Applicant *x, const Applicant *y) {
+    return x->category == y->category && x->pref[0] == y->pref[0] &&
+           x->allocated == y->allocated && x->department == y->department &&
+           x->jee_rank == y->jee_rank;
+}
+
+/* ============ FULL BUILD ============ */
+void statsRebuild(AdmissionStats *s, const Applicant a[], int n) {
+    memset(s, 0, sizeof(*s));
+    s->programs = programCount();
+    for (int d = 0; d < s->programs; d++)
+        s->program[d].seats = programSeats(d);
+    for (int i = 0; i < n; i++)
+        countRow(s, &a[i], 1);
+}
+
+/* ============ ONE ROW CHANGED ============ */
+/* before is NULL for an inserted row, after for a removed one */
+void statsApply(AdmissionStats *s, const Applicant *before, const Applicant *after) {
+    if (before && after && sameCounts(before, after)) return;
+    if (before) countRow(s, before, -1);
+    if (after) countRow(s, after, 1);
+}
+
+/* ============ RESCAN STALE PROGRAMS ============ */
+/* Recounts the allotted seats of the programs marked dirty from
+   the rows they now hold; a no-op when nothing is dirty */
+void statsSettle(AdmissionStats *s, const Applicant a[], int n) {
+    if (!s->anyDirty) return;
+
+    for (int d = 0; d < s->programs; d++) {
+        if (!isDirty(s, d)) continue;
+        ProgramStats *p = &s->program[d];
+        p->total.filled = p->total.openRank = p->total.closeRank = 0;
+        for (int c = 0; c < CAT_COUNT; c++)
+            p->cat[c].filled = p->cat[c].openRank = p->cat[c].closeRank = 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int d = a[i].department;
+        if (!a[i].allocated || d >= s->programs || !isDirty(s, d)) continue;
+        allotCell(&s->program[d].total, a[i].jee_rank);
+        allotCell(&s->program[d].cat[a[i].category], a[i].jee_rank);
+    }
+    memset(s->dirty, 0, sizeof(s->dirty));
+    s->anyDirty = 0;
+}
+
+/* ============ SEATS REALLOCATED ============ */
+/* After a merit run every allotment may have moved; demand and
+   category counts stay, the seat counts are rebuilt */
+void statsReallocate(AdmissionStats *s, const Applicant a[], int n) {
+    for (int d = 0; d < s->programs; d++)
+        markDirty(s, d);
+    statsSettle(s, a, n);
+}
+
+int statsAllocated(const AdmissionStats *s) {
+    int allocated = 0;
+    for (int d = 0; d < s->programs; d++)
+        allocated += s->program[d].total.filled;
+    return allocated;
+}
+
+/* ============ JSON ============ */
+static void appendCell(char *buf, size_t size, size_t *len, const StatsCell *c) {
+    jsonAppend(buf, size, len, "\"filled\":%d,\"demand\":%d,", c->filled, c->demand);
+    if (c->filled == 0)
+        jsonAppend(buf, size, len, "\"opening_rank\":null,\"closing_rank\":null");
+    else
+        jsonAppend(buf, size, len, "\"opening_rank\":%d,\"closing_rank\":%d", c->openRank, c->closeRank);
+}
+
+/* {"applicants":N,"allocated":A,"waiting":W,"categories":{"GEN":..},
+   "programs":[{"program":"CSE","seats":..,"vacant":..,<cell>,
+   "categories":{"GEN":{<cell>},..}},..]} where a cell is filled,
+   demand, opening_rank and closing_rank (null with no seat filled).
+   Expects settled stats. Returns the length, or -1 if buf is too small. */
+int statsFormatJson(const AdmissionStats *s, char *buf, size_t size) {
+    size_t len = 0;
+    int allocated = statsAllocated(s);
+
+    jsonAppend(buf, size, &len, "{\"applicants\":%d,\"allocated\":%d,\"waiting\":%d,\"categories\":{",
+           s->applicants, allocated, s->applicants - allocated);
+    for (int c = 0; c < CAT_COUNT; c++)
+        jsonAppend(buf, size, &len, "%s\"%s\":%d", c ? "," : "", categoryCode(c), s->categories[c]);
+    jsonAppend(buf, size, &len, "},\"programs\":[");
+
+    for (int d = 0; d < s->programs; d++) {
+        const ProgramStats *p = &s->program[d];
+        int vacant = p->seats - p->total.filled;
+        jsonAppend(buf, size, &len, "%s{\"program\":\"%s\",\"seats\":%d,\"vacant\":%d,",
+               d ? "," : "", getDeptCode(d), p->seats, vacant > 0 ? vacant : 0);
+        appendCell(buf, size, &len, &p->total);
+        jsonAppend(buf, size, &len, ",\"categories\":{");
+        for (int c = 0; c < CAT_COUNT; c++) {
+            jsonAppend(buf, size, &len, "%s\"%s\":{", c ? "," : "", categoryCode(c));
+            appendCell(buf, size, &len, &p->cat[c]);
+            jsonAppend(buf, size, &len, "}");
+        }
+        jsonAppend(buf, size, &len, "}}");
+    }
+    jsonAppend(buf, size, &len, "]}");
+    return len < size ? (int) len : -1;
+}
@@ -7,77 +7,144 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
-#include <sys/stat.h>
+#include <stdint.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "../mongoose/mongoose.h"
 #include "../headers/student.h"
 #include "../headers/csv_handler.h"
+#include "../headers/department.h"
 #include "../headers/sorting.h"
+#include "../headers/applicant_table.h"
+#include "../headers/query.h"
+#include "../headers/predictor.h"
+#include "../headers/merit_engine.h"
+#include "../headers/dataset.h"
+#include "../headers/admission_stats.h"
+#include "../headers/json_request.h"
+#include "../headers/bulk_import.h"
+#include "../headers/capture.h"
+#include "../headers/metrics.h"
+#include "../headers/async_log.h"
+#include "../headers/trace.h"
+#include "../headers/session.h"
+#include "../headers/rate_limit.h"
 
 #define HTTP_PORT "8080"
-#define LOG_FILE "logs/api_server.log"
+#define LOG_DIR "logs"
+#define LOG_NAME "api_server.log"
+#define LOG_FILE LOG_DIR "/" LOG_NAME
+#define LOG_MAX_BYTES (16 * 1024 * 1024)
+#define LOG_MAX_AGE (24 * 60 * 60)
+#define LOG_KEEP 5
+#define MAX_JOBS 32
+#define MERIT_RETRIES 3
+#define JOB_RESULT_LEN (64 + MAX_PROGRAMS * (PROGRAM_CODE_LEN + 12))  // seats of every program
+#define DATA_FILE "applicants_full.csv"
+#define ADMIN_FILE "admin_credentials.csv"
+#define METRICS_DUMP_MS 10000
+#define MAX_EXPENSIVE_IN_FLIGHT 2           // merit jobs + bulk imports
+#define EXPENSIVE_BUDGET_US 600000          // event-loop time per second
 
-// Log file pointer
-static FILE *log_fp = NULL;
+// Merit job phases, in pipeline order
+typedef enum {
+    PHASE_QUEUED,
+    PHASE_LOAD,
+    PHASE_SORT,
+    PHASE_ALLOCATE,
+    PHASE_PERSIST,
+    PHASE_DONE,
+    PHASE_FAILED
+} JobPhase;
+
+static const char *phase_names[] = {
+    "queued", "load", "sort", "allocate", "persist", "done", "failed"
+};
+
+// Background merit generation job
+typedef struct {
+    int id;                 // 0 = unused slot
+    JobPhase phase;
+    int percent;
+    double phase_ms[4];     // load, sort, allocate, persist
+    double total_ms;
+    char result[JOB_RESULT_LEN]; // JSON summary once done
+    char error[100];
+    unsigned long trace_from; // first trace span of this job
+} MeritJob;
+
+// Job table: slot = id % MAX_JOBS, older jobs are overwritten
+static MeritJob jobs[MAX_JOBS];
+static int next_job_id = 1;
+static int active_job_id = 0;       // queued/running job, 0 when idle
+static int last_done_job_id = 0;    // most recent successful job
+static unsigned long last_done_version = 0; // dataset version it published
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+static const char *trace_path = NULL;  // --trace: Chrome trace of the last job
+
+// Bulk imports handed to worker threads (see handle_api_bulk_register)
+typedef struct BulkJob {
+    unsigned long conn_id;
+    int detached;               // replied, or the client went away
+    BulkFormat format;
+    char *body;
+    size_t body_len;
+    uint64_t arrival;           // metrics and capture are taken at reply time
+    char method[16];
+    char *uri;
+    int status;                 // set by the worker
+    char *response;
+    atomic_int done;
+    struct BulkJob *next;
+} BulkJob;
+
+static BulkJob *bulk_jobs = NULL;   // event loop only
 
 // Forward declarations
 static void handle_api_applicants(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_api_login_student(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_api_login_admin(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_api_session(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_api_logout(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_api_register(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_api_generate_merit(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_api_update_applicant(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_api_job_status(struct mg_connection *c, struct mg_http_message *hm);
+static BulkJob *handle_api_bulk_register(struct mg_connection *c, struct mg_http_message *hm);
+static void bulk_poll(struct mg_connection *c, int closing);
+static void handle_api_query(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_api_stats(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_api_predict(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_api_programs(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_metrics(struct mg_connection *c, struct mg_http_message *hm);
 
-// Initialize logging
+// Initialize logging: requests are written by a background thread
 static void init_logging(void) {
-    // Create logs directory if it doesn't exist
-    mkdir("logs", 0755);
-    
-    log_fp = fopen(LOG_FILE, "a");
-    if (log_fp) {
-        time_t now = time(NULL);
-        char timestamp[64];
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        fprintf(log_fp, "\n========================================\n");
-        fprintf(log_fp, "Server started at %s\n", timestamp);
-        fprintf(log_fp, "========================================\n");
-        fflush(log_fp);
-    }
+    LogRotation rotation = {LOG_MAX_BYTES, LOG_MAX_AGE, LOG_KEEP};
+    if (asyncLogOpen(LOG_DIR, LOG_NAME, &rotation) < 0)
+        printf("Warning: Cannot open %s, requests will not be logged\n", LOG_FILE);
 }
 
-// Log an API request
+// Log an API request (copies into the log ring, never blocks)
 static void log_request(const char *method, const char *uri, int status, const char *details) {
-    if (!log_fp) return;
-    
-    time_t now = time(NULL);
-    char timestamp[64];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-    
-    fprintf(log_fp, "[%s] %s %s -> %d", timestamp, method, uri, status);
-    if (details && strlen(details) > 0) {
-        fprintf(log_fp, " | %s", details);
-    }
-    fprintf(log_fp, "\n");
-    fflush(log_fp);
+    asyncLogWrite(method, uri, status, details);
 }
 
 // Close logging
 static void close_logging(void) {
-    if (log_fp) {
-        time_t now = time(NULL);
-        char timestamp[64];
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-        fprintf(log_fp, "Server stopped at %s\n", timestamp);
-        fclose(log_fp);
-        log_fp = NULL;
-    }
+    asyncLogClose();
 }
 
 // CORS headers for all API responses
 static const char *cors_headers = 
     "Access-Control-Allow-Origin: *\r\n"
     "Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\n"
-    "Access-Control-Allow-Headers: Content-Type\r\n";
+    "Access-Control-Allow-Headers: Content-Type, Authorization\r\n";
 
 // JSON helper - escape string for JSON
 static void json_escape(char *dest, const char *src, size_t max) {
@@ -91,93 +158,389 @@ static void json_escape(char *dest, const char *src, size_t max) {
     dest[j] = '\0';
 }
 
+// Request schemas: field name, type, required, max length, max items
+static const JsonField login_student_schema[] = {
+    {"name",     JSON_STRING, 1, 49, 0},
+    {"id",       JSON_INT,    1, 0,  0},
+    {"password", JSON_STRING, 1, 19, 0},
+};
+enum { LS_NAME, LS_ID, LS_PASSWORD, LS_FIELDS };
+
+static const JsonField login_admin_schema[] = {
+    {"empId",    JSON_INT,    1, 0,  0},
+    {"username", JSON_STRING, 1, 99, 0},
+    {"password", JSON_STRING, 1, 99, 0},
+};
+enum { LA_EMPID, LA_USERNAME, LA_PASSWORD, LA_FIELDS };
+
+static const JsonField register_schema[] = {
+    {"name",     JSON_STRING,       1, 49, 0},
+    {"password", JSON_STRING,       1, 19, 0},
+    {"category", JSON_STRING,       0, 4,  0},
+    {"jee_rank", JSON_INT,          0, 0,  0},
+    {"marks",    JSON_INT,          0, 0,  0},
+    {"pref",     JSON_STRING_ARRAY, 0, PROGRAM_CODE_LEN - 1, PREF_COUNT},
+};
+enum { RG_NAME, RG_PASSWORD, RG_CATEGORY, RG_JEE_RANK, RG_MARKS, RG_PREF, RG_FIELDS };
+
+static const JsonField update_schema[] = {
+    {"password", JSON_STRING,       0, 19, 0},
+    {"pref",     JSON_STRING_ARRAY, 0, PROGRAM_CODE_LEN - 1, PREF_COUNT},
+};
+enum { UP_PASSWORD, UP_PREF, UP_FIELDS };
+
+static const JsonField query_schema[] = {
+    {"query", JSON_STRING, 1, 511, 0},
+};
+enum { QR_QUERY, QR_FIELDS };
+
+static const JsonField predict_schema[] = {
+    {"jee_rank", JSON_INT,          1, 0, 0},
+    {"marks",    JSON_INT,          1, 0, 0},
+    {"category", JSON_STRING,       0, 4, 0},
+    {"pref",     JSON_STRING_ARRAY, 1, PROGRAM_CODE_LEN - 1, PREF_COUNT},
+};
+enum { PR_JEE_RANK, PR_MARKS, PR_CATEGORY, PR_PREF, PR_FIELDS };
+
+// Reply 400 with a parser/validation message
+static void reply_bad_request(struct mg_connection *c, const char *err) {
+    mg_http_reply(c, 400,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"error\":\"%s\"}", err);
+}
+
+// Reply 429/503 telling the client when to come back
+static void reply_limited(struct mg_connection *c, int status, int retry_after, const char *error) {
+    char headers[300];
+    snprintf(headers, sizeof(headers), "%sContent-Type: application/json\r\nRetry-After: %d\r\n",
+             cors_headers, retry_after);
+    mg_http_reply(c, status, headers, "{\"error\":\"%s\",\"retry_after\":%d}", error, retry_after);
+}
+
+// Values stored in the CSV must not contain separators
+static int csv_safe(const char *s) {
+    return strpbrk(s, ",\r\n") == NULL;
+}
+
+// Convert a parsed preference list; it must name all PREF_COUNT choices
+// (department codes or "NA")
+static int copy_prefs(uint8_t pref[PREF_COUNT], const JsonValue *v) {
+    if (v->count != PREF_COUNT) return -1;
+    for (int i = 0; i < PREF_COUNT; i++) {
+        char code[PROGRAM_CODE_LEN];
+        if (jsonCopyString(code, sizeof(code), v->items[i]) < 0) return -1;
+        int dept = parseDepartment(code);
+        if (dept < 0) return -1;
+        pref[i] = (uint8_t) dept;
+    }
+    return 0;
+}
+
+// Integer field checked against lo..hi before it is narrowed to an int
+static int int_field(const JsonValue *v, long lo, long hi, int *out) {
+    if (v->num < lo || v->num > hi) return -1;
+    *out = (int) v->num;
+    return 0;
+}
+
+// Bearer token of the request, or an empty string when there is none
+static struct mg_str bearer_token(struct mg_http_message *hm) {
+    struct mg_str *h = mg_http_get_header(hm, "Authorization");
+    if (!h || h->len < 7 || strncasecmp(h->buf, "Bearer ", 7) != 0) return mg_str_n("", 0);
+    return mg_str_n(h->buf + 7, h->len - 7);
+}
+
+// Session named by the Authorization header; NULL if absent or expired
+static const Session *request_session(struct mg_http_message *hm) {
+    struct mg_str token = bearer_token(hm);
+    return token.len > 0 ? sessionLookup(token.buf, token.len) : NULL;
+}
+
+// Numeric ID after a fixed URI prefix, e.g. /api/jobs/17; -1 if malformed
+static long uri_trailing_id(struct mg_str uri, size_t prefix_len) {
+    long id = 0;
+    if (uri.len <= prefix_len || uri.len - prefix_len > 9) return -1;
+    for (size_t i = prefix_len; i < uri.len; i++) {
+        if (uri.buf[i] < '0' || uri.buf[i] > '9') return -1;
+        id = id * 10 + (uri.buf[i] - '0');
+    }
+    return id;
+}
+
 // Convert applicant to JSON
-static void applicant_to_json(char *buf, size_t size, Applicant *a) {
-    char name_escaped[100], dept_escaped[20];
-    json_escape(name_escaped, a->name, sizeof(name_escaped));
-    json_escape(dept_escaped, a->department, sizeof(dept_escaped));
+static void applicant_to_json(char *buf, size_t size, const Applicant *a) {
+    char name_escaped[100];
+    json_escape(name_escaped, applicantName(a), sizeof(name_escaped));
     
     snprintf(buf, size,
         "{\"id\":%d,\"name\":\"%s\",\"category\":\"%s\","
         "\"pref\":[\"%s\",\"%s\",\"%s\",\"%s\"],"
         "\"department\":\"%s\",\"marks\":%d,\"jee_rank\":%d,\"allocated\":%d}",
-        a->id, name_escaped, a->category,
-        a->pref[0], a->pref[1], a->pref[2], a->pref[3],
-        dept_escaped, a->marks, a->jee_rank, a->allocated);
+        a->id, name_escaped, categoryCode(a->category),
+        getDeptCode(a->pref[0]), getDeptCode(a->pref[1]),
+        getDeptCode(a->pref[2]), getDeptCode(a->pref[3]),
+        getDeptCode(a->department), a->marks, a->jee_rank, a->allocated);
 }
 
-// HTTP event handler
-static void ev_handler(struct mg_connection *c, int ev, void *ev_data) {
-    if (ev == MG_EV_HTTP_MSG) {
-        struct mg_http_message *hm = (struct mg_http_message *) ev_data;
-        
-        // Extract method and URI for logging
-        char method[10] = {0};
-        char uri[256] = {0};
-        snprintf(method, sizeof(method), "%.*s", (int)hm->method.len, hm->method.buf);
-        snprintf(uri, sizeof(uri), "%.*s", (int)hm->uri.len, hm->uri.buf);
-        
-        // Handle CORS preflight
-        if (mg_match(hm->method, mg_str("OPTIONS"), NULL)) {
-            mg_http_reply(c, 204, cors_headers, "");
-            return;
+// Status code of the reply queued since send_before, 0 if none yet
+static int reply_status(struct mg_connection *c, size_t send_before) {
+    int status = 0;
+    if (c->send.len > send_before + 12 &&
+        memcmp(c->send.buf + send_before, "HTTP/1.", 7) == 0) {
+        for (int i = 9; i < 12; i++) {
+            char d = (char) c->send.buf[send_before + i];
+            if (d < '0' || d > '9') return 0;
+            status = status * 10 + (d - '0');
         }
-        
-        // API Routes
-        if (mg_match(hm->uri, mg_str("/api/applicants"), NULL)) {
-            log_request(method, uri, 200, "Fetching applicants");
+    }
+    return status;
+}
+
+// Which route a request is for; the same order route_request() dispatches in
+static MetricRoute match_route(struct mg_http_message *hm) {
+    if (mg_match(hm->method, mg_str("OPTIONS"), NULL)) return METRIC_ROUTE_PREFLIGHT;
+    if (mg_match(hm->uri, mg_str("/api/applicants"), NULL)) return METRIC_ROUTE_APPLICANTS;
+    if (mg_match(hm->uri, mg_str("/api/applicants/bulk"), NULL)) return METRIC_ROUTE_BULK;
+    if (mg_match(hm->uri, mg_str("/api/applicants/*"), NULL)) return METRIC_ROUTE_UPDATE;
+    if (mg_match(hm->uri, mg_str("/api/login/student"), NULL)) return METRIC_ROUTE_LOGIN_STUDENT;
+    if (mg_match(hm->uri, mg_str("/api/login/admin"), NULL)) return METRIC_ROUTE_LOGIN_ADMIN;
+    if (mg_match(hm->uri, mg_str("/api/session"), NULL)) return METRIC_ROUTE_SESSION;
+    if (mg_match(hm->uri, mg_str("/api/logout"), NULL)) return METRIC_ROUTE_LOGOUT;
+    if (mg_match(hm->uri, mg_str("/api/register"), NULL)) return METRIC_ROUTE_REGISTER;
+    if (mg_match(hm->uri, mg_str("/api/generate-merit"), NULL)) return METRIC_ROUTE_GENERATE_MERIT;
+    if (mg_match(hm->uri, mg_str("/api/jobs/*"), NULL)) return METRIC_ROUTE_JOB_STATUS;
+    if (mg_match(hm->uri, mg_str("/api/query"), NULL)) return METRIC_ROUTE_QUERY;
+    if (mg_match(hm->uri, mg_str("/api/stats"), NULL)) return METRIC_ROUTE_STATS;
+    if (mg_match(hm->uri, mg_str("/api/predict"), NULL)) return METRIC_ROUTE_PREDICT;
+    if (mg_match(hm->uri, mg_str("/api/programs"), NULL)) return METRIC_ROUTE_PROGRAMS;
+    if (mg_match(hm->uri, mg_str("/metrics"), NULL)) return METRIC_ROUTE_METRICS;
+    return METRIC_ROUTE_STATIC;
+}
+
+// What the request log says about each route, with the status the
+// handler actually replied (NULL = not logged)
+static const char *const route_log[METRIC_ROUTE_COUNT] = {
+    [METRIC_ROUTE_APPLICANTS]     = "Fetching applicants",
+    [METRIC_ROUTE_BULK]           = "Bulk registration",
+    [METRIC_ROUTE_UPDATE]         = "Updating applicant",
+    [METRIC_ROUTE_LOGIN_STUDENT]  = "Student login attempt",
+    [METRIC_ROUTE_LOGIN_ADMIN]    = "Admin login attempt",
+    [METRIC_ROUTE_LOGOUT]         = "Logout",
+    [METRIC_ROUTE_REGISTER]       = "New student registration",
+    [METRIC_ROUTE_GENERATE_MERIT] = "Merit job requested",
+    [METRIC_ROUTE_JOB_STATUS]     = "Job status",
+    [METRIC_ROUTE_QUERY]          = "Applicant query",
+    [METRIC_ROUTE_PREDICT]        = "Allocation prediction",
+};
+
+// Logs one answered request
+static void log_reply(struct mg_str method, struct mg_str uri, MetricRoute route, int status) {
+    char m[10], u[256];
+    if (!route_log[route]) return;
+    snprintf(m, sizeof(m), "%.*s", (int) method.len, method.buf);
+    snprintf(u, sizeof(u), "%.*s", (int) uri.len, uri.buf);
+    log_request(m, u, status, route_log[route]);
+}
+
+// Dispatch one request to its handler; returns the bulk import it
+// handed to a worker, if any (that request is answered later)
+static BulkJob *route_request(struct mg_connection *c, struct mg_http_message *hm, MetricRoute route) {
+    BulkJob *bulk = NULL;
+    
+    switch (route) {
+        case METRIC_ROUTE_PREFLIGHT:
+            // Handle CORS preflight
+            mg_http_reply(c, 204, cors_headers, "");
+            break;
+        case METRIC_ROUTE_APPLICANTS:
             handle_api_applicants(c, hm);
-        }
-        else if (mg_match(hm->uri, mg_str("/api/applicants/*"), NULL)) {
-            log_request(method, uri, 200, "Updating applicant");
+            break;
+        case METRIC_ROUTE_BULK:
+            bulk = handle_api_bulk_register(c, hm);
+            break;
+        case METRIC_ROUTE_UPDATE:
             handle_api_update_applicant(c, hm);
-        }
-        else if (mg_match(hm->uri, mg_str("/api/login/student"), NULL)) {
-            log_request(method, uri, 200, "Student login attempt");
+            break;
+        case METRIC_ROUTE_LOGIN_STUDENT:
             handle_api_login_student(c, hm);
-        }
-        else if (mg_match(hm->uri, mg_str("/api/login/admin"), NULL)) {
-            log_request(method, uri, 200, "Admin login attempt");
+            break;
+        case METRIC_ROUTE_LOGIN_ADMIN:
             handle_api_login_admin(c, hm);
-        }
-        else if (mg_match(hm->uri, mg_str("/api/register"), NULL)) {
-            log_request(method, uri, 201, "New student registration");
+            break;
+        case METRIC_ROUTE_SESSION:
+            handle_api_session(c, hm);
+            break;
+        case METRIC_ROUTE_LOGOUT:
+            handle_api_logout(c, hm);
+            break;
+        case METRIC_ROUTE_REGISTER:
             handle_api_register(c, hm);
-        }
-        else if (mg_match(hm->uri, mg_str("/api/generate-merit"), NULL)) {
-            log_request(method, uri, 200, "Generating merit list");
+            break;
+        case METRIC_ROUTE_GENERATE_MERIT: {
+            TraceSpan span = traceBegin("merit.request");
             handle_api_generate_merit(c, hm);
+            traceEnd(&span);
+            break;
         }
-        else {
+        case METRIC_ROUTE_JOB_STATUS:
+            handle_api_job_status(c, hm);
+            break;
+        case METRIC_ROUTE_QUERY:
+            handle_api_query(c, hm);
+            break;
+        case METRIC_ROUTE_STATS:
+            handle_api_stats(c, hm);
+            break;
+        case METRIC_ROUTE_PREDICT:
+            handle_api_predict(c, hm);
+            break;
+        case METRIC_ROUTE_PROGRAMS:
+            handle_api_programs(c, hm);
+            break;
+        case METRIC_ROUTE_METRICS:
+            handle_metrics(c, hm);
+            break;
+        default: {
             // Serve static files from current directory
             struct mg_http_serve_opts opts = {.root_dir = "."};
             mg_http_serve_dir(c, hm, &opts);
+            break;
+        }
+    }
+    return bulk;
+}
+
+// Request limits per route: each client's bucket, the bucket shared by
+// all clients (rate 0 = unlimited), and whether the handler is
+// expensive. Expensive routes are shed first under load; cheap reads
+// are never subject to admission control.
+typedef struct {
+    RateLimit client;
+    RateLimit route;
+    int expensive;
+} RoutePolicy;
+
+static const RoutePolicy route_policies[METRIC_ROUTE_COUNT] = {
+    [METRIC_ROUTE_APPLICANTS]     = {{20, 40},   {0, 0},     0},
+    [METRIC_ROUTE_BULK]           = {{0.2, 2},   {1, 2},     1},
+    [METRIC_ROUTE_UPDATE]         = {{2, 10},    {100, 200}, 1},
+    [METRIC_ROUTE_LOGIN_STUDENT]  = {{1, 5},     {500, 1000}, 0},
+    [METRIC_ROUTE_LOGIN_ADMIN]    = {{0.5, 5},   {20, 40},   0},
+    [METRIC_ROUTE_SESSION]        = {{20, 40},   {0, 0},     0},
+    [METRIC_ROUTE_LOGOUT]         = {{5, 10},    {0, 0},     0},
+    [METRIC_ROUTE_REGISTER]       = {{1, 5},     {100, 200}, 1},
+    [METRIC_ROUTE_GENERATE_MERIT] = {{0.2, 3},   {2, 5},     1},
+    [METRIC_ROUTE_JOB_STATUS]     = {{20, 40},   {0, 0},     0},
+    [METRIC_ROUTE_QUERY]          = {{5, 20},    {100, 200}, 1},
+    [METRIC_ROUTE_STATS]          = {{20, 40},   {0, 0},     0},
+    [METRIC_ROUTE_PREDICT]        = {{5, 20},    {0, 0},     0},
+    [METRIC_ROUTE_PROGRAMS]       = {{20, 40},   {0, 0},     0},
+    [METRIC_ROUTE_METRICS]        = {{0, 0},     {0, 0},     0},
+    [METRIC_ROUTE_PREFLIGHT]      = {{0, 0},     {0, 0},     0},
+    [METRIC_ROUTE_STATIC]         = {{50, 100},  {0, 0},     0},
+};
+
+_Static_assert(METRIC_ROUTE_COUNT <= RATE_MAX_ROUTES, "client buckets need one per route");
+
+static TokenBucket route_buckets[METRIC_ROUTE_COUNT];
+static int rate_limits_enabled = 1;
+
+// Front door: returns 0 after replying 429/503 if the request must
+// not run. Bulk imports also take an admission slot the caller frees.
+static int admit_request(struct mg_connection *c, MetricRoute route, uint64_t now) {
+    const RoutePolicy *p = &route_policies[route];
+    int retry_after = 1;
+    
+    if (rate_limits_enabled) {
+        TokenBucket *b = rateClientBucket(c->rem.ip, c->rem.is_ip6 ? 16 : 4, route, now);
+        if (!tokenBucketTake(b, &p->client, now, &retry_after)) {
+            metricsCount(METRIC_RATE_LIMITED, 1);
+            reply_limited(c, 429, retry_after, "Too many requests");
+            return 0;
+        }
+        if (!tokenBucketTake(&route_buckets[route], &p->route, now, &retry_after)) {
+            tokenBucketRefund(b, &p->client);   // rejected: costs the client nothing
+            metricsCount(METRIC_RATE_LIMITED, 1);
+            reply_limited(c, 429, retry_after, "Too many requests");
+            return 0;
         }
     }
+    
+    if (p->expensive) {
+        if (admissionOverBudget(now) ||
+            (route == METRIC_ROUTE_BULK && !admissionTryEnter())) {
+            metricsCount(METRIC_SHED, 1);
+            reply_limited(c, 503, 1, "Server busy, retry shortly");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// HTTP event handler
+static void ev_handler(struct mg_connection *c, int ev, void *ev_data) {
+    if (ev == MG_EV_HTTP_MSG) {
+        struct mg_http_message *hm = (struct mg_http_message *) ev_data;
+        uint64_t arrival = captureNowUs();
+        size_t send_before = c->send.len;
+        
+        MetricRoute route = match_route(hm);
+        BulkJob *bulk = NULL;
+        if (admit_request(c, route, arrival)) {
+            bulk = route_request(c, hm, route);
+            if (route == METRIC_ROUTE_BULK && !bulk) admissionLeave();
+        }
+        
+        uint64_t latency = captureNowUs() - arrival;
+        if (route_policies[route].expensive)
+            admissionCharge(latency, arrival + latency);
+        if (bulk) {
+            bulk->arrival = arrival;   // replied, measured and captured by bulk_poll()
+            return;
+        }
+        int status = reply_status(c, send_before);
+        log_reply(hm->method, hm->uri, route, status);
+        metricsObserveRequest(route, status, latency);
+        metricsCount(METRIC_REQUEST_BYTES, hm->body.len);
+        
+        // Capture mode: record the full request for later replay
+        if (captureEnabled()) {
+            captureWrite(arrival, (uint32_t) latency, status,
+                         hm->method.buf, hm->method.len,
+                         hm->uri.buf, hm->uri.len,
+                         hm->body.buf, hm->body.len);
+        }
+    } else if (ev == MG_EV_POLL || ev == MG_EV_CLOSE) {
+        if (bulk_jobs) bulk_poll(c, ev == MG_EV_CLOSE);
+    }
 }
 
 // GET /api/applicants - Get all applicants
 // POST /api/applicants - Add new applicant
 static void handle_api_applicants(struct mg_connection *c, struct mg_http_message *hm) {
-    Applicant applicants[MAX];
-    int n = loadApplicants(applicants);
-    
     if (mg_match(hm->method, mg_str("GET"), NULL)) {
+        const DatasetVersion *snap = datasetAcquire();
+        int n = snap->count;
+        
         // Build JSON array
-        char *response = malloc(n * 300 + 100);
+        char *response = malloc((size_t) n * 300 + 100);
         if (!response) {
+            datasetRelease(snap);
             mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
             return;
         }
         
-        strcpy(response, "[");
+        size_t len = 0;
+        response[len++] = '[';
         for (int i = 0; i < n; i++) {
-            char applicant_json[300];
-            applicant_to_json(applicant_json, sizeof(applicant_json), &applicants[i]);
-            strcat(response, applicant_json);
-            if (i < n - 1) strcat(response, ",");
+            applicant_to_json(response + len, 300, &snap->rows[i]);
+            len += strlen(response + len);
+            if (i < n - 1) response[len++] = ',';
         }
-        strcat(response, "]");
+        response[len++] = ']';
+        response[len] = '\0';
+        datasetRelease(snap);
         
         mg_http_reply(c, 200, 
             "Content-Type: application/json\r\n"
@@ -197,80 +560,43 @@ static void handle_api_login_student(struct mg_connection *c, struct mg_http_mes
         return;
     }
     
-    // Parse JSON body
-    char name[50] = "", password[20] = "";
-    int id = 0;
-    
-    struct mg_str body = hm->body;
-    
-    // Simple JSON parsing
-    char *name_start = strstr(body.buf, "\"name\"");
-    char *id_start = strstr(body.buf, "\"id\"");
-    char *pass_start = strstr(body.buf, "\"password\"");
-    
-    if (name_start) {
-        name_start = strchr(name_start, ':');
-        if (name_start) {
-            name_start = strchr(name_start, '"');
-            if (name_start) {
-                name_start++;
-                char *name_end = strchr(name_start, '"');
-                if (name_end) {
-                    size_t len = name_end - name_start;
-                    if (len < sizeof(name)) {
-                        strncpy(name, name_start, len);
-                        name[len] = '\0';
-                    }
-                }
-            }
-        }
+    JsonValue f[LS_FIELDS];
+    char err[100];
+    if (jsonParseRequest(hm->body.buf, hm->body.len, login_student_schema, LS_FIELDS,
+                         f, err, sizeof(err)) < 0) {
+        reply_bad_request(c, err);
+        return;
     }
     
-    if (id_start) {
-        id_start = strchr(id_start, ':');
-        if (id_start) {
-            id = atoi(id_start + 1);
-        }
-    }
+    char name[NAME_LEN], password[PASSWORD_LEN];
+    long id = f[LS_ID].num;
+    jsonCopyString(name, sizeof(name), f[LS_NAME].str);
+    jsonCopyString(password, sizeof(password), f[LS_PASSWORD].str);
     
-    if (pass_start) {
-        pass_start = strchr(pass_start, ':');
-        if (pass_start) {
-            pass_start = strchr(pass_start, '"');
-            if (pass_start) {
-                pass_start++;
-                char *pass_end = strchr(pass_start, '"');
-                if (pass_end) {
-                    size_t len = pass_end - pass_start;
-                    if (len < sizeof(password)) {
-                        strncpy(password, pass_start, len);
-                        password[len] = '\0';
-                    }
-                }
-            }
-        }
-    }
+    // Validate against a snapshot of the resident dataset (O(1) by ID)
+    const DatasetVersion *snap = datasetAcquire();
+    const Applicant *a = datasetFindById(snap, id);
     
-    // Validate
-    Applicant applicants[MAX];
-    int n = loadApplicants(applicants);
-    
-    for (int i = 0; i < n; i++) {
-        if (applicants[i].id == id && 
-            strcmp(applicants[i].name, name) == 0 &&
-            strcmp(applicants[i].password, password) == 0) {
-            
-            char response[500];
-            applicant_to_json(response, sizeof(response), &applicants[i]);
-            
-            mg_http_reply(c, 200,
-                "Content-Type: application/json\r\n"
-                "Access-Control-Allow-Origin: *\r\n",
-                "{\"success\":true,\"student\":%s}", response);
+    if (a && strcmp(applicantName(a), name) == 0 && strcmp(applicantPassword(a), password) == 0) {
+        char response[500];
+        applicant_to_json(response, sizeof(response), a);
+        datasetRelease(snap);
+        
+        const Session *s = sessionCreate(SESSION_STUDENT, id, NULL);
+        if (!s) {
+            metricsCount(METRIC_SHED, 1);
+            reply_limited(c, 503, 60, "Too many active sessions, retry later");
             return;
         }
+        mg_http_reply(c, 200,
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n",
+            "{\"success\":true,\"token\":\"%s\",\"expires_in\":%d,\"student\":%s}",
+            s->token, SESSION_TTL_SECONDS, response);
+        return;
     }
     
+    datasetRelease(snap);
     mg_http_reply(c, 401,
         "Content-Type: application/json\r\n"
         "Access-Control-Allow-Origin: *\r\n",
@@ -284,204 +610,171 @@ static void handle_api_login_admin(struct mg_connection *c, struct mg_http_messa
         return;
     }
     
-    // Parse JSON body
-    char username[100] = "", password[100] = "";
-    int empId = 0;
-    
-    struct mg_str body = hm->body;
-    
-    char *emp_start = strstr(body.buf, "\"empId\"");
-    char *user_start = strstr(body.buf, "\"username\"");
-    char *pass_start = strstr(body.buf, "\"password\"");
-    
-    if (emp_start) {
-        emp_start = strchr(emp_start, ':');
-        if (emp_start) empId = atoi(emp_start + 1);
-    }
-    
-    if (user_start) {
-        user_start = strchr(user_start, ':');
-        if (user_start) {
-            user_start = strchr(user_start, '"');
-            if (user_start) {
-                user_start++;
-                char *end = strchr(user_start, '"');
-                if (end) {
-                    size_t len = end - user_start;
-                    if (len < sizeof(username)) {
-                        strncpy(username, user_start, len);
-                        username[len] = '\0';
-                    }
-                }
-            }
-        }
+    JsonValue f[LA_FIELDS];
+    char err[100];
+    if (jsonParseRequest(hm->body.buf, hm->body.len, login_admin_schema, LA_FIELDS,
+                         f, err, sizeof(err)) < 0) {
+        reply_bad_request(c, err);
+        return;
     }
     
-    if (pass_start) {
-        pass_start = strchr(pass_start, ':');
-        if (pass_start) {
-            pass_start = strchr(pass_start, '"');
-            if (pass_start) {
-                pass_start++;
-                char *end = strchr(pass_start, '"');
-                if (end) {
-                    size_t len = end - pass_start;
-                    if (len < sizeof(password)) {
-                        strncpy(password, pass_start, len);
-                        password[len] = '\0';
-                    }
-                }
-            }
-        }
-    }
+    char username[100], password[100];
+    long empId = f[LA_EMPID].num;
+    jsonCopyString(username, sizeof(username), f[LA_USERNAME].str);
+    jsonCopyString(password, sizeof(password), f[LA_PASSWORD].str);
     
-    // Check admin credentials from CSV
-    FILE *fp = fopen("admin_credentials.csv", "r");
-    if (!fp) {
+    // Check against the cached admin credential table
+    int match = credentialsCheckAdmin(empId, username, password);
+    if (match < 0) {
         mg_http_reply(c, 500, cors_headers, "{\"error\":\"Cannot read admin credentials\"}");
         return;
     }
     
-    char line[256];
-    fgets(line, sizeof(line), fp); // Skip header
-    
-    while (fgets(line, sizeof(line), fp)) {
-        int fileEmpId;
-        char fileUsername[100], filePassword[100];
-        
-        if (sscanf(line, "%d,%99[^,],%99[^\n\r]", &fileEmpId, fileUsername, filePassword) == 3) {
-            if (empId == fileEmpId && 
-                strcmp(username, fileUsername) == 0 && 
-                strcmp(password, filePassword) == 0) {
-                fclose(fp);
-                mg_http_reply(c, 200,
-                    "Content-Type: application/json\r\n"
-                    "Access-Control-Allow-Origin: *\r\n",
-                    "{\"success\":true,\"admin\":{\"empId\":%d,\"username\":\"%s\"}}",
-                    empId, username);
-                return;
-            }
+    if (match) {
+        char username_escaped[200];
+        json_escape(username_escaped, username, sizeof(username_escaped));
+        const Session *s = sessionCreate(SESSION_ADMIN, empId, username);
+        if (!s) {
+            metricsCount(METRIC_SHED, 1);
+            reply_limited(c, 503, 60, "Too many active sessions, retry later");
+            return;
         }
+        mg_http_reply(c, 200,
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n",
+            "{\"success\":true,\"token\":\"%s\",\"expires_in\":%d,"
+            "\"admin\":{\"empId\":%ld,\"username\":\"%s\"}}",
+            s->token, SESSION_TTL_SECONDS, empId, username_escaped);
+        return;
     }
     
-    fclose(fp);
     mg_http_reply(c, 401,
         "Content-Type: application/json\r\n"
         "Access-Control-Allow-Origin: *\r\n",
         "{\"success\":false,\"error\":\"Invalid credentials\"}");
 }
 
-// POST /api/register - Register new student
-static void handle_api_register(struct mg_connection *c, struct mg_http_message *hm) {
-    if (!mg_match(hm->method, mg_str("POST"), NULL)) {
+// GET /api/session - Who the bearer token belongs to; no credential checks
+static void handle_api_session(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("GET"), NULL)) {
         mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
         return;
     }
     
-    Applicant applicants[MAX];
-    int n = loadApplicants(applicants);
-    
-    if (n >= MAX) {
-        mg_http_reply(c, 400, cors_headers, "{\"error\":\"Database full\"}");
+    const Session *s = request_session(hm);
+    if (!s) {
+        mg_http_reply(c, 401, cors_headers, "{\"success\":false,\"error\":\"Not logged in\"}");
         return;
     }
     
-    // Parse JSON body (simplified parsing)
-    Applicant newStudent = {0};
-    struct mg_str body = hm->body;
-    
-    // Find max ID and increment
-    int maxId = 999;
-    for (int i = 0; i < n; i++) {
-        if (applicants[i].id > maxId) maxId = applicants[i].id;
+    if (s->role == SESSION_ADMIN) {
+        char username_escaped[200];
+        json_escape(username_escaped, s->name, sizeof(username_escaped));
+        mg_http_reply(c, 200,
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n",
+            "{\"success\":true,\"role\":\"admin\",\"admin\":{\"empId\":%ld,\"username\":\"%s\"}}",
+            s->subjectId, username_escaped);
+        return;
     }
-    newStudent.id = maxId + 1;
     
-    // Parse fields from JSON (simplified)
-    char *ptr;
-    
-    if ((ptr = strstr(body.buf, "\"name\""))) {
-        ptr = strchr(ptr, ':');
-        if (ptr) {
-            ptr = strchr(ptr, '"');
-            if (ptr) {
-                ptr++;
-                char *end = strchr(ptr, '"');
-                if (end && (end - ptr) < 50) {
-                    strncpy(newStudent.name, ptr, end - ptr);
-                }
-            }
-        }
+    const DatasetVersion *snap = datasetAcquire();
+    const Applicant *a = datasetFindById(snap, s->subjectId);
+    if (!a) {
+        datasetRelease(snap);
+        mg_http_reply(c, 404, cors_headers, "{\"error\":\"Applicant not found\"}");
+        return;
     }
+    char response[500];
+    applicant_to_json(response, sizeof(response), a);
+    datasetRelease(snap);
     
-    if ((ptr = strstr(body.buf, "\"password\""))) {
-        ptr = strchr(ptr, ':');
-        if (ptr) {
-            ptr = strchr(ptr, '"');
-            if (ptr) {
-                ptr++;
-                char *end = strchr(ptr, '"');
-                if (end && (end - ptr) < 20) {
-                    strncpy(newStudent.password, ptr, end - ptr);
-                }
-            }
-        }
+    mg_http_reply(c, 200,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"success\":true,\"role\":\"student\",\"student\":%s}", response);
+}
+
+// POST /api/logout - End the bearer token's session
+static void handle_api_logout(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("POST"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
     }
     
-    if ((ptr = strstr(body.buf, "\"category\""))) {
-        ptr = strchr(ptr, ':');
-        if (ptr) {
-            ptr = strchr(ptr, '"');
-            if (ptr) {
-                ptr++;
-                char *end = strchr(ptr, '"');
-                if (end && (end - ptr) < 5) {
-                    strncpy(newStudent.category, ptr, end - ptr);
-                }
-            }
-        }
+    struct mg_str token = bearer_token(hm);
+    int ended = token.len > 0 && sessionRevoke(token.buf, token.len);
+    mg_http_reply(c, 200,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"success\":true,\"ended\":%s}", ended ? "true" : "false");
+}
+
+// POST /api/register - Register new student
+static void handle_api_register(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("POST"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
     }
     
-    if ((ptr = strstr(body.buf, "\"jee_rank\""))) {
-        ptr = strchr(ptr, ':');
-        if (ptr) newStudent.jee_rank = atoi(ptr + 1);
+    JsonValue f[RG_FIELDS];
+    char err[100];
+    if (jsonParseRequest(hm->body.buf, hm->body.len, register_schema, RG_FIELDS,
+                         f, err, sizeof(err)) < 0) {
+        reply_bad_request(c, err);
+        return;
     }
     
-    if ((ptr = strstr(body.buf, "\"marks\""))) {
-        ptr = strchr(ptr, ':');
-        if (ptr) newStudent.marks = atoi(ptr + 1);
+    Applicant newStudent = {0};
+    char name[NAME_LEN], password[PASSWORD_LEN], category[5] = "GEN";
+    jsonCopyString(name, sizeof(name), f[RG_NAME].str);
+    jsonCopyString(password, sizeof(password), f[RG_PASSWORD].str);
+    if (f[RG_CATEGORY].present)
+        jsonCopyString(category, sizeof(category), f[RG_CATEGORY].str);
+    // Absent numbers stay 0, as before
+    if (int_field(&f[RG_JEE_RANK], 0, INT_MAX, &newStudent.jee_rank) < 0 ||
+        int_field(&f[RG_MARKS], 0, 100, &newStudent.marks) < 0) {
+        mg_http_reply(c, 400, cors_headers, "{\"error\":\"Invalid data\"}");
+        return;
     }
     
-    // Parse preferences array
-    if ((ptr = strstr(body.buf, "\"pref\""))) {
-        ptr = strchr(ptr, '[');
-        if (ptr) {
-            for (int i = 0; i < 4; i++) {
-                ptr = strchr(ptr, '"');
-                if (ptr) {
-                    ptr++;
-                    char *end = strchr(ptr, '"');
-                    if (end && (end - ptr) < 5) {
-                        strncpy(newStudent.pref[i], ptr, end - ptr);
-                        ptr = end + 1;
-                    }
-                }
-            }
-        }
+    memset(newStudent.pref, DEPT_NONE, sizeof(newStudent.pref));
+    if (f[RG_PREF].present && copy_prefs(newStudent.pref, &f[RG_PREF]) < 0) {
+        reply_bad_request(c, "pref must list 4 departments");
+        return;
     }
     
-    strcpy(newStudent.department, "N/A");
+    newStudent.department = DEPT_NONE;
     newStudent.allocated = 0;
     
     // Validate
-    if (strlen(newStudent.name) == 0 || strlen(newStudent.password) < 3) {
+    int cat = parseCategory(category);
+    if (strlen(name) == 0 || strlen(password) < 3 || cat < 0 ||
+        !csv_safe(name) || !csv_safe(password)) {
         mg_http_reply(c, 400, cors_headers, "{\"error\":\"Invalid data\"}");
         return;
     }
+    newStudent.category = (uint8_t) cat;
+    newStudent.name = arenaIntern(name);
+    newStudent.password = arenaIntern(password);
+    
+    // Copy-on-write: append to a new version, then publish it
+    DatasetVersion *v = datasetBeginWrite(1);
+    if (!v) {
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
+    }
     
-    // Save
-    applicants[n] = newStudent;
-    saveApplicants(applicants, n + 1);
+    // Find max ID and increment
+    int maxId = 999;
+    for (int i = 0; i < v->count; i++) {
+        if (v->rows[i].id > maxId) maxId = v->rows[i].id;
+    }
+    newStudent.id = maxId + 1;
+    
+    v->rows[v->count++] = newStudent;
+    statsApply(&v->stats, NULL, &newStudent);
+    datasetPublish(v);
     
     char response[300];
     applicant_to_json(response, sizeof(response), &newStudent);
@@ -493,6 +786,8 @@ static void handle_api_register(struct mg_connection *c, struct mg_http_message
 }
 
 // PUT /api/applicants/:id - Update applicant
+// Preferences may still be changed without a token; the password needs
+// the student's own session or an admin's.
 static void handle_api_update_applicant(struct mg_connection *c, struct mg_http_message *hm) {
     if (!mg_match(hm->method, mg_str("PUT"), NULL)) {
         mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
@@ -500,17 +795,63 @@ static void handle_api_update_applicant(struct mg_connection *c, struct mg_http_
     }
     
     // Extract ID from URL
-    int id = 0;
-    char *id_start = strrchr(hm->uri.buf, '/');
-    if (id_start) {
-        id = atoi(id_start + 1);
+    long id = uri_trailing_id(hm->uri, sizeof("/api/applicants/") - 1);
+    if (id < 0) {
+        mg_http_reply(c, 404, cors_headers, "{\"error\":\"Applicant not found\"}");
+        return;
+    }
+    
+    // A token, when sent, must belong to this student or an admin
+    const Session *session = NULL;
+    if (bearer_token(hm).len > 0) {
+        session = request_session(hm);
+        if (!session) {
+            mg_http_reply(c, 401, cors_headers, "{\"error\":\"Session expired\"}");
+            return;
+        }
+        if (session->role == SESSION_STUDENT && session->subjectId != id) {
+            mg_http_reply(c, 403, cors_headers, "{\"error\":\"Not your application\"}");
+            return;
+        }
+    }
+    
+    // Parse and validate the body before taking the writer lock
+    JsonValue f[UP_FIELDS];
+    char err[100];
+    if (jsonParseRequest(hm->body.buf, hm->body.len, update_schema, UP_FIELDS,
+                         f, err, sizeof(err)) < 0) {
+        reply_bad_request(c, err);
+        return;
+    }
+    
+    char password[PASSWORD_LEN];
+    uint8_t pref[PREF_COUNT];
+    if (f[UP_PASSWORD].present) {
+        // Only the student or an admin may set a password
+        if (!session) {
+            mg_http_reply(c, 401, cors_headers, "{\"error\":\"Login required to change the password\"}");
+            return;
+        }
+        jsonCopyString(password, sizeof(password), f[UP_PASSWORD].str);
+        if (!csv_safe(password)) {
+            reply_bad_request(c, "Invalid password");
+            return;
+        }
+    }
+    if (f[UP_PREF].present && copy_prefs(pref, &f[UP_PREF]) < 0) {
+        reply_bad_request(c, "pref must list 4 departments");
+        return;
     }
     
-    Applicant applicants[MAX];
-    int n = loadApplicants(applicants);
+    DatasetVersion *v = datasetBeginWrite(0);
+    if (!v) {
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
+    }
+    Applicant *applicants = v->rows;
     
     int found = -1;
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < v->count; i++) {
         if (applicants[i].id == id) {
             found = i;
             break;
@@ -518,136 +859,883 @@ static void handle_api_update_applicant(struct mg_connection *c, struct mg_http_
     }
     
     if (found == -1) {
+        datasetAbortWrite(v);
         mg_http_reply(c, 404, cors_headers, "{\"error\":\"Applicant not found\"}");
         return;
     }
     
-    struct mg_str body = hm->body;
-    char *ptr;
+    Applicant before = applicants[found];
     
-    // Update password if provided
-    if ((ptr = strstr(body.buf, "\"password\""))) {
-        ptr = strchr(ptr, ':');
-        if (ptr) {
-            ptr = strchr(ptr, '"');
-            if (ptr) {
-                ptr++;
-                char *end = strchr(ptr, '"');
-                if (end && (end - ptr) < 20) {
-                    strncpy(applicants[found].password, ptr, end - ptr);
-                    applicants[found].password[end - ptr] = '\0';
-                }
+    // Update password if provided; other logins of this student end
+    if (f[UP_PASSWORD].present) {
+        applicants[found].password = arenaIntern(password);
+        sessionRevokeSubject(SESSION_STUDENT, id, session);
+    }
+    
+    // Update preferences if provided
+    if (f[UP_PREF].present) {
+        memcpy(applicants[found].pref, pref, sizeof(pref));
+    }
+    statsApply(&v->stats, &before, &applicants[found]);
+    
+    char response[300];
+    applicant_to_json(response, sizeof(response), &applicants[found]);
+    datasetPublish(v);
+    
+    mg_http_reply(c, 200,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"success\":true,\"student\":%s}", response);
+}
+
+// Does a header value mention the given token (e.g. "csv")?
+static int header_contains(struct mg_str *value, const char *token) {
+    size_t n = strlen(token);
+    if (!value || value->len < n) return 0;
+    for (size_t i = 0; i + n <= value->len; i++) {
+        if (strncasecmp(value->buf + i, token, n) == 0) return 1;
+    }
+    return 0;
+}
+
+static void bulk_job_free(BulkJob *job) {
+    free(job->body);
+    free(job->uri);
+    free(job->response);
+    free(job);
+}
+
+// Parses the whole body, checking IDs against rows[0..n)
+static int bulk_parse(BulkImport *import, const BulkJob *job, const Applicant *rows, int n) {
+    if (bulkBegin(import, job->format, rows, n) < 0) return -1;
+    bulkFeed(import, job->body, job->body_len);
+    bulkFinish(import);
+    return 0;
+}
+
+// Per-row error report; NULL when out of memory
+static char *bulk_report(const BulkImport *import, int firstId) {
+    size_t size = 256 + (size_t) import->nerrors * (2 * BULK_ERROR_LEN + 32);
+    char *response = malloc(size);
+    if (!response) return NULL;
+    
+    size_t len = snprintf(response, size,
+        "{\"success\":%s,\"accepted\":%d,\"rejected\":%d,\"first_id\":%d,"
+        "\"errors_truncated\":%s,\"errors\":[",
+        import->count > 0 ? "true" : "false", import->count, import->rejected, firstId,
+        import->rejected > import->nerrors ? "true" : "false");
+    for (int i = 0; i < import->nerrors; i++) {
+        char error[2 * BULK_ERROR_LEN];
+        json_escape(error, import->errors[i].error, sizeof(error));
+        len += snprintf(response + len, size - len, "%s{\"line\":%d,\"error\":\"%s\"}",
+                        i > 0 ? "," : "", import->errors[i].line, error);
+    }
+    snprintf(response + len, size - len, "]}");
+    return response;
+}
+
+static void bulk_fail(BulkJob *job, const char *error) {
+    job->status = 500;
+    job->response = malloc(strlen(error) + 16);
+    if (job->response) sprintf(job->response, "{\"error\":\"%s\"}", error);
+}
+
+// Worker thread: parse against a snapshot, then commit under the writer
+// lock (other writers wait only for the commit). A register since the
+// snapshot may have taken one of the IDs, so the body is parsed again
+// on the locked copy in that case.
+static void *bulk_worker(void *arg) {
+    BulkJob *job = (BulkJob *) arg;
+    BulkImport *import = malloc(sizeof(BulkImport));   // large error/carry buffers
+    
+    const DatasetVersion *snap = datasetAcquire();
+    unsigned long base = snap->version;
+    int rc = import ? bulk_parse(import, job, snap->rows, snap->count) : -1;
+    datasetRelease(snap);
+    
+    DatasetVersion *v = NULL;
+    if (rc == 0 && import->count > 0) {
+        v = datasetBeginWrite(import->count);
+        if (v && datasetCurrentVersion() != base) {
+            bulkFree(import);
+            rc = bulk_parse(import, job, v->rows, v->count);
+            if (rc == 0 && import->count == 0) {
+                datasetAbortWrite(v);
+                v = NULL;
             }
         }
     }
     
-    // Update preferences if provided
-    if ((ptr = strstr(body.buf, "\"pref\""))) {
-        ptr = strchr(ptr, '[');
-        if (ptr) {
-            for (int i = 0; i < 4; i++) {
-                ptr = strchr(ptr, '"');
-                if (ptr) {
-                    ptr++;
-                    char *end = strchr(ptr, '"');
-                    if (end && (end - ptr) < 5) {
-                        strncpy(applicants[found].pref[i], ptr, end - ptr);
-                        applicants[found].pref[i][end - ptr] = '\0';
-                        ptr = end + 1;
-                    }
+    if (rc < 0 || (import->count > 0 && !v)) {
+        if (v) datasetAbortWrite(v);
+        bulk_fail(job, "Memory allocation failed");
+    } else {
+        // Commit every accepted record in one durable batch
+        int firstId = import->count > 0 ? import->rows[0].id : 0;
+        if (v) {
+            memcpy(v->rows + v->count, import->rows, import->count * sizeof(Applicant));
+            v->count += import->count;
+            for (int i = 0; i < import->count; i++)
+                statsApply(&v->stats, NULL, &import->rows[i]);
+            rc = datasetPublishDurable(v);
+        }
+        if (rc < 0) {
+            bulk_fail(job, "Cannot write applicants file");
+        } else {
+            job->status = import->count > 0 ? 201 : 400;
+            job->response = bulk_report(import, firstId);
+            if (!job->response) bulk_fail(job, "Memory allocation failed");
+        }
+    }
+    if (import) bulkFree(import);
+    free(import);
+    
+    // Release the reader slot, metrics shard and admission slot, then
+    // hand the job back; the event loop may free it from here on
+    datasetThreadExit();
+    metricsThreadExit();
+    admissionLeave();
+    atomic_store(&job->done, 1);
+    return NULL;
+}
+
+// Poll/close event: reply once the worker is done; a job whose client
+// has gone is freed when it finishes
+static void bulk_poll(struct mg_connection *c, int closing) {
+    for (BulkJob **p = &bulk_jobs; *p; ) {
+        BulkJob *job = *p;
+        int done = atomic_load(&job->done);
+        
+        if (!job->detached && job->conn_id == c->id) {
+            if (closing) job->detached = 1;
+            else if (done) {
+                int status = job->response ? job->status : 500;
+                if (!job->response)
+                    mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+                else if (status == 500)
+                    mg_http_reply(c, 500, cors_headers, "%s", job->response);
+                else
+                    mg_http_reply(c, status,
+                        "Content-Type: application/json\r\n"
+                        "Access-Control-Allow-Origin: *\r\n",
+                        "%s", job->response);
+                
+                uint64_t latency = captureNowUs() - job->arrival;
+                log_reply(mg_str(job->method), mg_str(job->uri), METRIC_ROUTE_BULK, status);
+                metricsObserveRequest(METRIC_ROUTE_BULK, status, latency);
+                metricsCount(METRIC_REQUEST_BYTES, job->body_len);
+                if (captureEnabled()) {
+                    captureWrite(job->arrival, (uint32_t) latency, status,
+                                 job->method, strlen(job->method),
+                                 job->uri, strlen(job->uri),
+                                 job->body, job->body_len);
                 }
+                job->detached = 1;   // replied: free below
+                c->is_full = 0;      // read the next request
             }
         }
+        
+        if (job->detached && done) {
+            *p = job->next;
+            bulk_job_free(job);
+        } else {
+            p = &job->next;
+        }
+    }
+}
+
+// POST /api/applicants/bulk - Register a batch of applicants
+// Body: NDJSON (one register-style object per line) or CSV with a
+// header row (Content-Type: text/csv). Mongoose buffers the body (up
+// to MG_MAX_RECV_SIZE); a worker thread then validates the records and
+// commits every accepted row in one fsync'ed batch, so the event loop
+// keeps serving other requests meanwhile. The reply is sent from the
+// connection's poll event once the worker is done.
+// Until then the connection reads no further requests, so replies
+// stay in request order. Returns the job, or NULL if it replied at
+// once; the admission slot taken by admit_request() goes with the job.
+static BulkJob *handle_api_bulk_register(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("POST"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return NULL;
     }
     
-    saveApplicants(applicants, n);
+    BulkJob *job = calloc(1, sizeof(BulkJob));
+    if (job) {
+        job->body = malloc(hm->body.len + 1);
+        job->uri = malloc(hm->uri.len + 1);
+    }
+    if (!job || !job->body || !job->uri) {
+        if (job) bulk_job_free(job);
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return NULL;
+    }
+    job->conn_id = c->id;
+    job->format = header_contains(mg_http_get_header(hm, "Content-Type"), "csv")
+                  ? BULK_CSV : BULK_NDJSON;
+    memcpy(job->body, hm->body.buf, hm->body.len);
+    job->body_len = hm->body.len;
+    memcpy(job->uri, hm->uri.buf, hm->uri.len);
+    job->uri[hm->uri.len] = '\0';
+    snprintf(job->method, sizeof(job->method), "%.*s", (int) hm->method.len, hm->method.buf);
+    atomic_init(&job->done, 0);
+    
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, bulk_worker, job) != 0) {
+        bulk_job_free(job);
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Cannot start bulk import\"}");
+        return NULL;
+    }
+    pthread_detach(tid);
+    job->next = bulk_jobs;
+    bulk_jobs = job;
     
-    char response[300];
-    applicant_to_json(response, sizeof(response), &applicants[found]);
+    c->is_resp = 1;   // hold requests already buffered behind this one
+    c->is_full = 1;   // and read no more until bulk_poll() replies
+    return job;
+}
+
+// Milliseconds on the monotonic clock
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void job_set_phase(MeritJob *job, JobPhase phase, int percent) {
+    pthread_mutex_lock(&job_lock);
+    job->phase = phase;
+    job->percent = percent;
+    pthread_mutex_unlock(&job_lock);
+}
+
+static void job_record(MeritJob *job, int phase_index, double ms) {
+    pthread_mutex_lock(&job_lock);
+    job->phase_ms[phase_index] = ms;
+    pthread_mutex_unlock(&job_lock);
+}
+
+// Allocation progress maps onto 50..70 percent of the whole job
+static void job_allocate_progress(void *ctx, int done, int n) {
+    MeritJob *job = (MeritJob *) ctx;
+    pthread_mutex_lock(&job_lock);
+    job->percent = 50 + (int)(20L * done / n);
+    pthread_mutex_unlock(&job_lock);
+}
+
+static void job_fail(MeritJob *job, const char *error) {
+    metricsCount(METRIC_MERIT_FAILED, 1);
+    pthread_mutex_lock(&job_lock);
+    job->phase = PHASE_FAILED;
+    snprintf(job->error, sizeof(job->error), "%s", error);
+    active_job_id = 0;
+    pthread_mutex_unlock(&job_lock);
+}
+
+// Release what the worker thread held: reader slot, metrics shard and
+// its admission slot
+static void job_thread_exit(void) {
+    datasetThreadExit();
+    metricsThreadExit();
+    admissionLeave();
+}
+
+// Worker thread: load -> sort -> allocate -> persist
+// Works on a private copy of a snapshot so readers and writers never
+// wait for it. If the dataset changed meanwhile the run is retried;
+// after MERIT_RETRIES it is redone on the locked copy instead.
+static void *merit_job_worker(void *arg) {
+    MeritJob *job = (MeritJob *) arg;
+    double start = now_ms();
+    TraceSpan total = traceBegin("merit.job"), span;
+    ApplicantTable table = {0};
+    int seatAlloc[MAX_PROGRAMS];
+    int allocated = 0, n = 0;
+    
+    for (int attempt = 0; ; attempt++) {
+        job_set_phase(job, PHASE_LOAD, 0);
+        span = traceBegin("merit.load");
+        const DatasetVersion *snap = datasetAcquire();
+        unsigned long base = snap->version;
+        n = snap->count;
+        tableFree(&table);
+        int loaded = tableFromRows(&table, snap->rows, n) == 0;
+        datasetRelease(snap);
+        span.n = n;
+        job_record(job, 0, traceEnd(&span));
+        
+        if (!loaded || n <= 0) {
+            tableFree(&table);
+            job_fail(job, n <= 0 ? "No applicants found" : "Memory allocation failed");
+            job_thread_exit();
+            return NULL;
+        }
+        
+        // Sort by JEE rank on the columnar copy (merge sort from sorting.c)
+        job_set_phase(job, PHASE_SORT, 20);
+        span = traceBegin("merit.sort");
+        span.n = n;
+        if (tableSort(&table, SORT_MERGE, 1) != 0) {
+            traceEnd(&span);
+            tableFree(&table);
+            job_fail(job, "Memory allocation failed");
+            job_thread_exit();
+            return NULL;
+        }
+        job_record(job, 1, traceEnd(&span));
+        
+        job_set_phase(job, PHASE_ALLOCATE, 50);
+        span = traceBegin("merit.allocate");
+        allocated = allocateTableSeats(&table, seatAlloc, job_allocate_progress, job);
+        span.n = allocated;
+        job_record(job, 2, traceEnd(&span));
+        
+        job_set_phase(job, PHASE_PERSIST, 70);
+        TraceSpan persist = traceBegin("merit.persist");
+        DatasetVersion *v = datasetBeginWrite(0);
+        if (!v) {
+            tableFree(&table);
+            job_fail(job, "Memory allocation failed");
+            job_thread_exit();
+            return NULL;
+        }
+        
+        if (v->version != base + 1) {
+            if (attempt < MERIT_RETRIES) {
+                // A writer published since our snapshot: start over
+                datasetAbortWrite(v);
+                metricsCount(METRIC_MERIT_RETRIES, 1);
+                continue;
+            }
+            // Writers keep racing us: redo the work on the locked copy
+            n = v->count;
+            if (mergeSort(v->rows, 0, n - 1) != 0) {
+                datasetAbortWrite(v);
+                tableFree(&table);
+                job_fail(job, "Memory allocation failed");
+                job_thread_exit();
+                return NULL;
+            }
+            allocated = allocateSeats(v->rows, n, seatAlloc, NULL, NULL);
+        } else {
+            tableToRows(&table, v->rows);
+        }
+        statsReallocate(&v->stats, v->rows, n);
+        
+        unsigned long published = v->version;
+        span = traceBegin("merit.write_merit_list");
+        writeMeritList("merit_list.csv", v->rows, n);
+        traceEnd(&span);
+        span = traceBegin("merit.save_applicants");
+        datasetPublish(v);
+        traceEnd(&span);
+        job_record(job, 3, traceEnd(&persist));
+        
+        pthread_mutex_lock(&job_lock);
+        last_done_version = published;
+        pthread_mutex_unlock(&job_lock);
+        break;
+    }
+    tableFree(&table);
+    total.n = n;
+    traceEnd(&total);
+    if (trace_path && traceWriteChrome(trace_path, job->trace_from) != 0)
+        log_request("-", trace_path, 500, "Cannot write trace");
+    
+    pthread_mutex_lock(&job_lock);
+    int len = snprintf(job->result, sizeof(job->result),
+        "{\"allocated\":%d,\"total\":%d,\"seats\":{", allocated, n);
+    for (int d = 0; d < programCount(); d++)
+        len += snprintf(job->result + len, sizeof(job->result) - len,
+            "%s\"%s\":%d", d ? "," : "", getDeptCode(d), seatAlloc[d]);
+    snprintf(job->result + len, sizeof(job->result) - len, "}}");
+    job->total_ms = now_ms() - start;
+    job->phase = PHASE_DONE;
+    job->percent = 100;
+    last_done_job_id = job->id;
+    active_job_id = 0;
+    for (int p = 0; p < METRIC_PHASE_COUNT; p++)
+        metricsObservePhase((MetricPhase) p, (uint64_t) (job->phase_ms[p] * 1000.0));
+    pthread_mutex_unlock(&job_lock);
+    job_thread_exit();
+    return NULL;
+}
+
+// Render a job as JSON (caller holds job_lock)
+static void job_to_json(char *buf, size_t size, const MeritJob *job) {
+    int len = snprintf(buf, size,
+        "{\"id\":%d,\"phase\":\"%s\",\"percent\":%d,"
+        "\"timings_ms\":{\"load\":%.3f,\"sort\":%.3f,\"allocate\":%.3f,"
+        "\"persist\":%.3f,\"total\":%.3f}",
+        job->id, phase_names[job->phase], job->percent,
+        job->phase_ms[0], job->phase_ms[1], job->phase_ms[2], job->phase_ms[3],
+        job->total_ms);
+    
+    if (job->phase == PHASE_DONE) {
+        snprintf(buf + len, size - len, ",\"result\":%s}", job->result);
+    } else if (job->phase == PHASE_FAILED) {
+        snprintf(buf + len, size - len, ",\"error\":\"%s\"}", job->error);
+    } else {
+        snprintf(buf + len, size - len, "}");
+    }
+}
+
+// POST /api/generate-merit - Start a merit job, returns its ID immediately
+static void handle_api_generate_merit(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("POST"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
+    }
+    
+    pthread_mutex_lock(&job_lock);
+    
+    // A job is already queued or running: hand back its ID
+    if (active_job_id != 0) {
+        int id = active_job_id;
+        pthread_mutex_unlock(&job_lock);
+        metricsCount(METRIC_MERIT_JOINED, 1);
+        mg_http_reply(c, 202,
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n",
+            "{\"success\":true,\"job_id\":%d,\"status\":\"running\"}", id);
+        return;
+    }
+    
+    // Data unchanged since the last run: its result is still current
+    MeritJob *last = &jobs[last_done_job_id % MAX_JOBS];
+    if (last_done_job_id != 0 && last->id == last_done_job_id &&
+        datasetCurrentVersion() == last_done_version) {
+        int id = last_done_job_id;
+        pthread_mutex_unlock(&job_lock);
+        metricsCount(METRIC_MERIT_CACHE_HIT, 1);
+        mg_http_reply(c, 200,
+            "Content-Type: application/json\r\n"
+            "Access-Control-Allow-Origin: *\r\n",
+            "{\"success\":true,\"job_id\":%d,\"status\":\"done\",\"cached\":true}", id);
+        return;
+    }
+    
+    // New job: it holds an admission slot until the worker exits
+    if (!admissionTryEnter()) {
+        pthread_mutex_unlock(&job_lock);
+        metricsCount(METRIC_SHED, 1);
+        reply_limited(c, 503, 1, "Server busy, retry shortly");
+        return;
+    }
+    
+    int id = next_job_id++;
+    MeritJob *job = &jobs[id % MAX_JOBS];
+    memset(job, 0, sizeof(*job));
+    job->id = id;
+    job->phase = PHASE_QUEUED;
+    job->trace_from = traceMark();
+    active_job_id = id;
+    
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, merit_job_worker, job) != 0) {
+        job->phase = PHASE_FAILED;
+        snprintf(job->error, sizeof(job->error), "Cannot start worker");
+        active_job_id = 0;
+        admissionLeave();
+        pthread_mutex_unlock(&job_lock);
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Cannot start merit job\"}");
+        return;
+    }
+    pthread_detach(tid);
+    pthread_mutex_unlock(&job_lock);
+    metricsCount(METRIC_MERIT_CACHE_MISS, 1);
+    
+    mg_http_reply(c, 202,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"success\":true,\"job_id\":%d,\"status\":\"queued\"}", id);
+}
+
+// GET /api/jobs/:id - Merit job phase, progress, timings and result
+static void handle_api_job_status(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("GET"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
+    }
+    
+    long id = uri_trailing_id(hm->uri, sizeof("/api/jobs/") - 1);
+    
+    char response[JOB_RESULT_LEN + 512];
+    pthread_mutex_lock(&job_lock);
+    MeritJob *job = &jobs[id % MAX_JOBS];
+    int found = id > 0 && job->id == id;
+    if (found) job_to_json(response, sizeof(response), job);
+    pthread_mutex_unlock(&job_lock);
+    
+    if (!found) {
+        mg_http_reply(c, 404, cors_headers, "{\"error\":\"Job not found\"}");
+        return;
+    }
     
     mg_http_reply(c, 200,
         "Content-Type: application/json\r\n"
         "Access-Control-Allow-Origin: *\r\n",
-        "{\"success\":true,\"student\":%s}", response);
+        "%s", response);
 }
 
-// POST /api/generate-merit - Generate merit list
-static void handle_api_generate_merit(struct mg_connection *c, struct mg_http_message *hm) {
+// GET /api/stats - Seat fill, opening/closing ranks and first-preference
+// demand per program; maintained by the writers, so this is a copy-out
+static void handle_api_stats(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("GET"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
+    }
+    
+    char *stats = malloc(STATS_JSON_LEN);
+    if (!stats) {
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
+    }
+    const DatasetVersion *snap = datasetAcquire();
+    unsigned long version = snap->version;
+    int len = statsFormatJson(&snap->stats, stats, STATS_JSON_LEN);
+    datasetRelease(snap);
+    if (len < 0) {
+        free(stats);
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Stats too large\"}");
+        return;
+    }
+    
+    mg_http_reply(c, 200,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"version\":%lu,\"stats\":%s}", version, stats);
+    free(stats);
+}
+
+// Merit index of the allocation that predictions are made from, rebuilt
+// when a new version has been published. Event loop thread only.
+static Predictor predictor;
+static unsigned long predictor_version;
+
+// POST /api/predict - Likely department for a hypothetical applicant
+// Body: {"jee_rank":..,"marks":..,"category":"OBC","pref":["CSE",..]}
+// Answered from the current allocation in O(prefs log n); the allocator
+// is never run. With a student's token, their own row is left out.
+static void handle_api_predict(struct mg_connection *c, struct mg_http_message *hm) {
     if (!mg_match(hm->method, mg_str("POST"), NULL)) {
         mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
         return;
     }
     
-    Applicant applicants[MAX];
-    int n = loadApplicants(applicants);
+    JsonValue f[PR_FIELDS];
+    char err[100], category[5] = "GEN";
+    if (jsonParseRequest(hm->body.buf, hm->body.len, predict_schema, PR_FIELDS,
+                         f, err, sizeof(err)) < 0) {
+        reply_bad_request(c, err);
+        return;
+    }
     
-    if (n <= 0) {
-        mg_http_reply(c, 400, cors_headers, "{\"error\":\"No applicants found\"}");
+    uint8_t pref[PREF_COUNT];
+    if (copy_prefs(pref, &f[PR_PREF]) < 0) {
+        reply_bad_request(c, "pref must list 4 departments");
+        return;
+    }
+    if (f[PR_CATEGORY].present)
+        jsonCopyString(category, sizeof(category), f[PR_CATEGORY].str);
+    int cat = parseCategory(category);
+    int rank, marks;
+    if (cat < 0 || int_field(&f[PR_JEE_RANK], 1, INT_MAX, &rank) < 0 ||
+        int_field(&f[PR_MARKS], 0, 100, &marks) < 0) {
+        reply_bad_request(c, "Invalid jee_rank, marks or category");
         return;
     }
     
-    // Sort by JEE rank (using merge sort from sorting.c)
-    mergeSort(applicants, 0, n - 1);
+    const Session *session = request_session(hm);
+    const DatasetVersion *snap = datasetAcquire();
+    if (!predictor.keys || predictor_version != snap->version) {
+        predictorFree(&predictor);
+        if (predictorBuild(&predictor, snap->rows, snap->count) == 0)
+            predictor_version = snap->version;
+    }
+    if (!predictor.keys) {
+        datasetRelease(snap);
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
+    }
     
-    // Allocate departments (10 seats each)
-    int seatAlloc[4] = {0}; // CSE, IT, TT, APM
-    char deptList[4][5] = {"CSE", "IT", "TT", "APM"};
-    int maxSeats = 10;
+    Applicant self;
+    const Applicant *found = session && session->role == SESSION_STUDENT
+                             ? datasetFindById(snap, session->subjectId) : NULL;
+    if (found) self = *found;
+    unsigned long version = snap->version;
+    datasetRelease(snap);
+    
+    Prediction pr;
+    predictAllocation(&predictor, rank, marks, pref, found ? &self : NULL, &pr);
+    
+    char prefs[800];
+    size_t len = 0;
+    for (int i = 0; i < PREF_COUNT; i++) {
+        int d = pref[i];
+        if (d >= predictor.programs) continue;
+        char catClose[16] = "null";
+        if (predictor.closeRank[d][cat] > 0)
+            snprintf(catClose, sizeof(catClose), "%d", predictor.closeRank[d][cat]);
+        len += snprintf(prefs + len, sizeof(prefs) - len,
+            "%s{\"department\":\"%s\",\"seats\":%d,\"admitted_ahead\":%d,\"available\":%s,"
+            "\"closing_rank\":%d,\"category_closing_rank\":%s}",
+            len ? "," : "", getDeptCode(d), predictor.seats[d], pr.ahead[i],
+            pr.ahead[i] < predictor.seats[d] ? "true" : "false",
+            predictor.closeRank[d][CAT_COUNT], catClose);
+    }
     
-    for (int i = 0; i < n; i++) {
-        applicants[i].allocated = 0;
-        strcpy(applicants[i].department, "NA");
+    char department[16] = "null";
+    if (pr.department != DEPT_NONE)
+        snprintf(department, sizeof(department), "\"%s\"", getDeptCode(pr.department));
+    mg_http_reply(c, 200,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "{\"department\":%s,\"preference\":%d,\"merit_position\":%d,\"applicants\":%d,"
+        "\"preferences\":[%s],\"version\":%lu}",
+        department, pr.preference, pr.meritPosition, predictor.count, prefs, version);
+}
+
+// GET /api/programs - The program registry in id order, for the
+// preference and department selectors
+static void handle_api_programs(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("GET"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
     }
     
-    for (int i = 0; i < n; i++) {
-        for (int p = 0; p < PREF_COUNT && !applicants[i].allocated; p++) {
-            for (int d = 0; d < 4; d++) {
-                if (strcmp(applicants[i].pref[p], deptList[d]) == 0 && seatAlloc[d] < maxSeats) {
-                    seatAlloc[d]++;
-                    applicants[i].allocated = 1;
-                    strcpy(applicants[i].department, deptList[d]);
-                    break;
-                }
-            }
-        }
+    size_t size = 32 + (size_t) programCount() * (PROGRAM_CODE_LEN + 2 * PROGRAM_NAME_LEN + 48);
+    char *body = malloc(size);
+    if (!body) {
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
     }
     
-    // Save to CSV
-    saveApplicants(applicants, n);
+    size_t len = snprintf(body, size, "{\"programs\":[");
+    for (int d = 0; d < programCount(); d++) {
+        char name[2 * PROGRAM_NAME_LEN];
+        json_escape(name, getDeptName(d), sizeof(name));
+        len += snprintf(body + len, size - len, "%s{\"code\":\"%s\",\"name\":\"%s\",\"seats\":%d}",
+                        d ? "," : "", getDeptCode(d), name, programSeats(d));
+    }
+    snprintf(body + len, size - len, "]}");
     
-    // Also save merit list
-    FILE *fp = fopen("merit_list.csv", "w");
-    if (fp) {
-        fprintf(fp, "JEE_Rank,ID,Name,Category,Department,Marks,Status\n");
-        for (int i = 0; i < n; i++) {
-            fprintf(fp, "%d,%d,%s,%s,%s,%d,%s\n",
-                applicants[i].jee_rank, applicants[i].id, applicants[i].name,
-                applicants[i].category, applicants[i].department, applicants[i].marks,
-                applicants[i].allocated ? "SELECTED" : "WAITING");
+    mg_http_reply(c, 200,
+        "Content-Type: application/json\r\n"
+        "Access-Control-Allow-Origin: *\r\n",
+        "%s", body);
+    free(body);
+}
+
+// Columnar copy of the dataset that queries run on, rebuilt when a
+// new version has been published. Only used on the event loop thread;
+// queries never read the name/password columns, so those may outlive
+// the version they came from.
+static ApplicantTable query_table;
+static unsigned long query_table_version;
+
+// GET /api/query?q=... or POST {"query":"..."} - Ad-hoc count/min/max/avg
+// over the applicants, e.g. "count where category = OBC group by department"
+static void handle_api_query(struct mg_connection *c, struct mg_http_message *hm) {
+    char text[512], err[128];
+    
+    if (mg_match(hm->method, mg_str("GET"), NULL)) {
+        if (mg_http_get_var(&hm->query, "q", text, sizeof(text)) < 0) {
+            reply_bad_request(c, "Missing q parameter");
+            return;
+        }
+    } else if (mg_match(hm->method, mg_str("POST"), NULL)) {
+        JsonValue f[QR_FIELDS];
+        if (jsonParseRequest(hm->body.buf, hm->body.len, query_schema, QR_FIELDS,
+                             f, err, sizeof(err)) < 0) {
+            reply_bad_request(c, err);
+            return;
         }
-        fclose(fp);
+        jsonCopyString(text, sizeof(text), f[QR_QUERY].str);
+    } else {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
     }
     
-    int allocated = 0;
-    for (int i = 0; i < n; i++) {
-        if (applicants[i].allocated) allocated++;
+    Query q;
+    if (queryParse(text, &q, err, sizeof(err)) < 0) {
+        char escaped[256];
+        json_escape(escaped, err, sizeof(escaped));
+        reply_bad_request(c, escaped);
+        return;
+    }
+    
+    double start = now_ms();
+    const DatasetVersion *snap = datasetAcquire();
+    if (!query_table.id || query_table_version != snap->version) {
+        tableFree(&query_table);
+        if (tableFromRows(&query_table, snap->rows, snap->count) == 0)
+            query_table_version = snap->version;
+    }
+    unsigned long version = query_table_version;
+    datasetRelease(snap);
+    
+    QueryResult r;
+    char *result = malloc(QUERY_JSON_LEN);
+    if (!result || !query_table.id || queryRun(&q, &query_table, &r) != 0 ||
+        queryFormatJson(&q, &r, result, QUERY_JSON_LEN) < 0) {
+        free(result);
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
     }
     
     mg_http_reply(c, 200,
         "Content-Type: application/json\r\n"
         "Access-Control-Allow-Origin: *\r\n",
-        "{\"success\":true,\"message\":\"Merit list generated\",\"allocated\":%d,\"total\":%d,"
-        "\"seats\":{\"CSE\":%d,\"IT\":%d,\"TT\":%d,\"APM\":%d}}",
-        allocated, n, seatAlloc[0], seatAlloc[1], seatAlloc[2], seatAlloc[3]);
+        "{\"result\":%s,\"version\":%lu,\"query_ms\":%.3f}", result, version, now_ms() - start);
+    free(result);
 }
 
-int main(void) {
+// Point-in-time gauges: dataset size, reclamation backlog, job and
+// connection queues
+static int collect_gauges(struct mg_mgr *mgr, MetricGauge *g) {
+    int n = 0, conns = 0, active;
+    size_t send_bytes = 0, recv_bytes = 0;
+    
+    const DatasetVersion *snap = datasetAcquire();
+    g[n++] = (MetricGauge) {"adm_dataset_rows", "Applicants in the current dataset version", snap->count};
+    g[n++] = (MetricGauge) {"adm_dataset_version", "Current dataset version", (double) snap->version};
+    datasetRelease(snap);
+    g[n++] = (MetricGauge) {"adm_dataset_retired_versions", "Replaced versions awaiting reclamation",
+                            datasetRetiredCount()};
+    
+    pthread_mutex_lock(&job_lock);
+    active = active_job_id != 0;
+    pthread_mutex_unlock(&job_lock);
+    g[n++] = (MetricGauge) {"adm_merit_jobs_active", "Merit jobs queued or running", active};
+    
+    for (struct mg_connection *x = mgr->conns; x; x = x->next) {
+        if (x->is_listening) continue;
+        conns++;
+        send_bytes += x->send.len;
+        recv_bytes += x->recv.len;
+    }
+    g[n++] = (MetricGauge) {"adm_http_connections", "Open client connections", conns};
+    g[n++] = (MetricGauge) {"adm_http_send_queue_bytes", "Response bytes queued but not yet sent",
+                            (double) send_bytes};
+    g[n++] = (MetricGauge) {"adm_http_recv_queue_bytes", "Request bytes buffered but not yet handled",
+                            (double) recv_bytes};
+    g[n++] = (MetricGauge) {"adm_expensive_in_flight", "Merit jobs and bulk imports holding an admission slot",
+                            admissionInFlight()};
+    g[n++] = (MetricGauge) {"adm_sessions_active", "Login sessions that have not expired",
+                            sessionCount()};
+    g[n++] = (MetricGauge) {"adm_log_records_dropped", "Log records dropped because the log ring was full",
+                            (double) asyncLogDropped()};
+    return n;
+}
+
+// GET /metrics - Prometheus text exposition
+static void handle_metrics(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!mg_match(hm->method, mg_str("GET"), NULL)) {
+        mg_http_reply(c, 405, cors_headers, "{\"error\":\"Method not allowed\"}");
+        return;
+    }
+    
+    MetricGauge gauges[16];
+    int ngauges = collect_gauges(c->mgr, gauges);
+    size_t len;
+    char *text = metricsRender(gauges, ngauges, &len);
+    if (!text) {
+        mg_http_reply(c, 500, cors_headers, "{\"error\":\"Memory allocation failed\"}");
+        return;
+    }
+    mg_http_reply(c, 200, "Content-Type: text/plain; version=0.0.4\r\n", "%s", text);
+    free(text);
+}
+
+// Periodic metrics dump for offline inspection (admission_system metrics)
+static const char *metrics_path = NULL;
+
+static void metrics_timer(void *arg) {
+    MetricGauge gauges[16];
+    int ngauges = collect_gauges((struct mg_mgr *) arg, gauges);
+    if (metricsDumpFile(metrics_path, gauges, ngauges) < 0)
+        log_request("-", metrics_path, 500, "Cannot write metrics dump");
+}
+
+// Periodic maintenance: pick up external CSV edits, free old versions
+static void dataset_timer(void *arg) {
+    (void) arg;
+    datasetRefreshIfChanged();
+    datasetReclaim();
+    credentialsRefreshIfChanged();
+    captureFlush();
+}
+
+// SIGINT/SIGTERM end the poll loop so the capture and log rings are
+// flushed on the way out; a second signal kills the server outright
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_stop_signal(int sig) {
+    stop_requested = 1;
+    signal(sig, SIG_DFL);
+}
+
+// Merit jobs and bulk imports still running may log and read the
+// dataset; each holds an admission slot until its thread is done with
+// both, so wait for the slots before the log ring is drained and the
+// dataset freed
+static void wait_for_workers(void) {
+    while (admissionInFlight() > 0)
+        usleep(50 * 1000);
+}
+
+int main(int argc, char *argv[]) {
     struct mg_mgr mgr;
+    const char *capture_path = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--capture=", 10) == 0) {
+            capture_path = argv[i] + 10;
+        } else if (strncmp(argv[i], "--metrics-file=", 15) == 0) {
+            metrics_path = argv[i] + 15;
+        } else if (strcmp(argv[i], "--no-rate-limit") == 0) {
+            rate_limits_enabled = 0;
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_path = argv[i] + 8;
+            traceEnable(1);
+        } else {
+            printf("Usage: %s [--capture=FILE] [--metrics-file=FILE] [--trace=FILE] [--no-rate-limit]\n",
+                   argv[0]);
+            return 2;
+        }
+    }
+    
+    // Programs first: loading the dataset maps their codes to ids
+    if (programsInit() < 0) return 1;
     
     // Initialize logging
     init_logging();
     
+    // Capture mode: bodies (including passwords) are written verbatim
+    if (capture_path && captureOpen(capture_path) < 0) {
+        printf("Error: Cannot create capture file %s\n", capture_path);
+        close_logging();
+        return 1;
+    }
+    
+    admissionInit(MAX_EXPENSIVE_IN_FLIGHT, EXPENSIVE_BUDGET_US);
+    
+    // Admin logins are checked against a cached copy of this file
+    if (credentialsLoad(ADMIN_FILE) < 0)
+        printf("Warning: Cannot read %s, admin login unavailable until it exists\n", ADMIN_FILE);
+    
+    // Load the resident dataset once; requests read snapshots of it
+    if (datasetInit(DATA_FILE) < 0) {
+        printf("Error: Cannot load %s\n", DATA_FILE);
+        close_logging();
+        return 1;
+    }
+    
     mg_mgr_init(&mgr);
+    mg_timer_add(&mgr, 2000, MG_TIMER_REPEAT, dataset_timer, NULL);
+    if (metrics_path)
+        mg_timer_add(&mgr, METRICS_DUMP_MS, MG_TIMER_REPEAT, metrics_timer, &mgr);
     
     printf("==============================================\n");
     printf("  ADMISSION MANAGEMENT SYSTEM - API SERVER\n");
@@ -662,22 +1750,46 @@ int main(void) {
     }
     
     printf("Server started at http://localhost:%s\n", HTTP_PORT);
+    printf("Programs: %d\n", programCount());
     printf("Frontend available at http://localhost:%s/index.html\n\n", HTTP_PORT);
-    printf("Logs written to: %s\n\n", LOG_FILE);
+    printf("Logs written to: %s (rotated at %d MB or daily, %d kept)\n",
+           LOG_FILE, LOG_MAX_BYTES / (1024 * 1024), LOG_KEEP);
+    if (capture_path) printf("Capturing requests to: %s\n", capture_path);
+    if (metrics_path) printf("Metrics dumped every %ds to: %s\n", METRICS_DUMP_MS / 1000, metrics_path);
+    if (trace_path) printf("Merit job traces written to: %s\n", trace_path);
+    if (!rate_limits_enabled) printf("Rate limits disabled (admission control still applies)\n");
+    printf("\n");
     printf("API Endpoints:\n");
     printf("  GET  /api/applicants      - Get all applicants\n");
     printf("  POST /api/login/student   - Student login\n");
     printf("  POST /api/login/admin     - Admin login\n");
+    printf("  GET  /api/session         - Current login (Bearer token)\n");
+    printf("  POST /api/logout          - End the session\n");
     printf("  POST /api/register        - Register new student\n");
     printf("  PUT  /api/applicants/:id  - Update applicant\n");
-    printf("  POST /api/generate-merit  - Generate merit list\n\n");
+    printf("  POST /api/applicants/bulk - Bulk register (NDJSON/CSV)\n");
+    printf("  POST /api/generate-merit  - Start merit list job\n");
+    printf("  GET  /api/jobs/:id        - Merit job status/result\n");
+    printf("  GET  /api/query?q=...     - Ad-hoc query (also POST {\"query\"})\n");
+    printf("  GET  /api/stats           - Seat fill, cutoff ranks, demand\n");
+    printf("  POST /api/predict         - Likely department for a rank\n");
+    printf("  GET  /api/programs        - Program codes, names and seats\n");
+    printf("  GET  /metrics             - Prometheus metrics\n\n");
     printf("Press Ctrl+C to stop the server\n\n");
     
-    for (;;) {
+    signal(SIGINT, on_stop_signal);
+    signal(SIGTERM, on_stop_signal);
+    while (!stop_requested) {
         mg_mgr_poll(&mgr, 1000);
     }
     
-    close_logging();
+    printf("Stopping server...\n");
     mg_mgr_free(&mgr);
+    captureClose();
+    wait_for_workers();
+    close_logging();
+    tableFree(&query_table);
+    predictorFree(&predictor);
+    datasetShutdown();
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "student.h"
+#include "department.h"
 #include "applicant_ops.h"
 #include "csv_handler.h"
 #include "utils.h"
@@ -11,11 +12,14 @@ void addApplicant() {
     Applicant a[MAX];
     int n = loadApplicants(a);
 
+    if (n < 0) return;
     if (n >= MAX) {
         printError("Cannot add more applicants. Database is full.");
         return;
     }
 
+    char name[NAME_LEN], password[PASSWORD_LEN];
+
     printf("\n--- ADD APPLICANT ---\n");
 
     printf("Enter ID: ");
@@ -23,12 +27,14 @@ void addApplicant() {
     getchar();
 
     printf("Enter Name: ");
-    scanf(" %49[^\n]", a[n].name);
+    scanf(" %49[^\n]", name);
     getchar();
+    a[n].name = arenaIntern(name);
 
     printf("Set Password (3-9 chars): ");
-    scanf("%19s", a[n].password);
+    scanf("%19s", password);
     getchar();
+    a[n].password = arenaIntern(password);
 
     printf("Enter Category:\n");
     printf("1. GEN\n");
@@ -39,11 +45,10 @@ void addApplicant() {
     int catChoice;
     scanf(" %d", &catChoice);
     getchar();
-    const char *categories[] = {"GEN", "OBC", "SC", "ST"};
-    if (catChoice >= 1 && catChoice <= 4) {
-        strcpy(a[n].category, categories[catChoice - 1]);
+    if (catChoice >= 1 && catChoice <= CAT_COUNT) {
+        a[n].category = (uint8_t) (catChoice - 1);
     } else {
-        strcpy(a[n].category, "GEN");
+        a[n].category = CAT_GEN;
     }
 
     printf("Enter JEE Rank: ");
@@ -54,25 +59,17 @@ void addApplicant() {
     scanf("%d", &a[n].marks);
     clearInputBuffer();
 
-    printf("Enter Preferences (1-4 for CSE/IT/TT/APM):\n");
-    printf("1. CSE\n");
-    printf("2. IT\n");
-    printf("3. TT\n");
-    printf("4. APM\n");
-    const char *depts[] = {"CSE", "IT", "TT", "APM"};
+    printf("Enter Preferences (number or code):");
+    listDepartments();
     for (int i = 0; i < PREF_COUNT; i++) {
-        int deptChoice;
-        printf("Preference %d [1-4]: ", i + 1);
-        scanf("%d", &deptChoice);
+        printf("Preference %d: ", i + 1);
+        int dept = readDepartmentChoice();
         clearInputBuffer();
-        if (deptChoice >= 1 && deptChoice <= 4) {
-            strcpy(a[n].pref[i], depts[deptChoice - 1]);
-        } else {
-            strcpy(a[n].pref[i], "CSE");
-        }
+        // Unknown choices fall back to the first department
+        a[n].pref[i] = (uint8_t) (dept >= 0 ? dept : 0);
     }
 
-    strcpy(a[n].department, "N/A");
+    a[n].department = DEPT_NONE;
     a[n].allocated = 0;
 
     saveApplicants(a, n + 1);
@@ -85,6 +82,7 @@ void editApplicant() {
     int n = loadApplicants(a);
     int id, found = -1;
 
+    if (n < 0) return;
     printf("\nEnter Applicant ID to Edit: ");
     scanf("%d", &id);
     getchar();
@@ -101,15 +99,24 @@ void editApplicant() {
         return;
     }
 
+    char name[NAME_LEN], code[PROGRAM_CODE_LEN];
+
     printf("\n--- EDIT APPLICANT ---\n");
 
-    printf("New Name (current: %s): ", a[found].name);
-    scanf(" %49[^\n]", a[found].name);
+    printf("New Name (current: %s): ", applicantName(&a[found]));
+    scanf(" %49[^\n]", name);
     getchar();
+    a[found].name = arenaIntern(name);
 
-    printf("New Category (current: %s): ", a[found].category);
-    scanf(" %s", a[found].category);
+    printf("New Category (current: %s): ", categoryCode(a[found].category));
+    scanf(" %7s", code);
     getchar();
+    int category = parseCategory(code);
+    if (category >= 0) {
+        a[found].category = (uint8_t) category;
+    } else {
+        printWarning("Unknown category, keeping the current one.");
+    }
 
     printf("New JEE Rank (current: %d): ", a[found].jee_rank);
     scanf("%d", &a[found].jee_rank);
@@ -121,12 +128,18 @@ void editApplicant() {
 
     printf("Update Preferences:\n");
     for (int i = 0; i < PREF_COUNT; i++) {
-        printf("Preference %d (current: %s): ", i + 1, a[found].pref[i]);
-        scanf("%s", a[found].pref[i]);
+        printf("Preference %d (current: %s): ", i + 1, getDeptCode(a[found].pref[i]));
+        scanf("%11s", code);
         clearInputBuffer();
+        int dept = parseDepartment(code);
+        if (dept >= 0) {
+            a[found].pref[i] = (uint8_t) dept;
+        } else {
+            printWarning("Unknown department, keeping the current one.");
+        }
     }
 
-    strcpy(a[found].department, "NA");
+    a[found].department = DEPT_NONE;
     a[found].allocated = 0;
 
     saveApplicants(a, n);
@@ -139,6 +152,7 @@ void deleteApplicant() {
     int n = loadApplicants(a);
     int id, found = -1;
 
+    if (n < 0) return;
     printf("\nEnter Applicant ID to Delete: ");
     scanf("%d", &id);
     getchar();
@@ -178,9 +192,10 @@ void searchApplicantByID() {
     for (int i = 0; i < n; i++) {
         if (a[i].id == target) {
             printSuccess("--- RECORD FOUND ---");
-            printf("ID: %d | Name: %s | Category: %s\n", a[i].id, a[i].name, a[i].category);
+            printf("ID: %d | Name: %s | Category: %s\n", a[i].id, applicantName(&a[i]),
+                   categoryCode(a[i].category));
             printf("Marks: %d | JEE Rank: %d\n", a[i].marks, a[i].jee_rank);
-            printf("Department: %s | Status: %s\n", a[i].department,
+            printf("Department: %s | Status: %s\n", getDeptCode(a[i].department),
                    a[i].allocated ? "SELECTED" : "WAITING/NOT ALLOTTED");
             found = 1;
             break;
@@ -204,9 +219,10 @@ void searchApplicantByName() {
 
     printSuccess("\n--- MATCHING RECORDS ---\n");
     for (int i = 0; i < n; i++) {
-        if (strstr(a[i].name, key) != NULL) {
+        if (strstr(applicantName(&a[i]), key) != NULL) {
             printf("ID: %d | Name: %s | Category: %s | Marks: %d | JEE Rank: %d | Dept: %s\n",
-                   a[i].id, a[i].name, a[i].category, a[i].marks, a[i].jee_rank, a[i].department);
+                   a[i].id, applicantName(&a[i]), categoryCode(a[i].category), a[i].marks,
+                   a[i].jee_rank, getDeptCode(a[i].department));
             found = 1;
         }
     }
@@ -229,15 +245,15 @@ void viewSingleApplicant() {
         if (a[i].id == id) {
             printf("\n========== FULL APPLICANT DETAILS ==========\n");
             printf("Application ID: %d\n", a[i].id);
-            printf("Name: %s\n", a[i].name);
-            printf("Category: %s\n", a[i].category);
+            printf("Name: %s\n", applicantName(&a[i]));
+            printf("Category: %s\n", categoryCode(a[i].category));
             printf("HS Marks: %d\n", a[i].marks);
             printf("JEE Rank: %d\n", a[i].jee_rank);
             printf("Department Preferences:\n");
             for (int j = 0; j < PREF_COUNT; j++) {
-                printf("  Preference %d: %s\n", j + 1, a[i].pref[j]);
+                printf("  Preference %d: %s\n", j + 1, getDeptCode(a[i].pref[j]));
             }
-            printf("Allotted Department: %s\n", a[i].department);
+            printf("Allotted Department: %s\n", getDeptCode(a[i].department));
             printf("Allocation Status: %s\n", a[i].allocated ? "SELECTED" : "WAITING/NOT ALLOTTED");
             printf("==========================================\n");
             return;
@@ -262,11 +278,11 @@ void listAllApplicants() {
         printf("%d. ID: %d | %s | Cat: %s | Marks: %d | Rank: %d | Dept: %s | Status: %s\n",
                i + 1,
                a[i].id,
-               a[i].name,
-               a[i].category,
+               applicantName(&a[i]),
+               categoryCode(a[i].category),
                a[i].marks,
                a[i].jee_rank,
-               a[i].department,
+               getDeptCode(a[i].department),
                a[i].allocated ? "SELECTED" : "WAITING");
     }
     printf("====================================\n");
@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include <string.h>
+#include "student.h"
+#include "sorting.h"
+#include "applicant_table.h"
+#include "scan_kernels.h"
+
+/* Bytes per row across all columns */
+#define ROW_BYTES (5 * sizeof(int) + PREF_COUNT + 3)
+
+/* ============ CREATE / FREE ============ */
+/* Carves the columns out of one block, widest first so every
+   column stays aligned; the byte columns are category, department,
+   allocated and then one per preference. Returns 0, or -1 when
+   out of memory. */
+int tableInit(ApplicantTable *t, int capacity) {
+    size_t cap = capacity > 0 ? (size_t) capacity : 1;
+    char *block = malloc(cap * ROW_BYTES);
+
+    memset(t, 0, sizeof(*t));
+    if (!block) return -1;
+
+    t->capacity = (int) cap;
+    t->id = (int *) block;
+    t->marks = t->id + cap;
+    t->jee_rank = t->marks + cap;
+    t->name = (StrRef *) (t->jee_rank + cap);
+    t->password = t->name + cap;
+    t->category = (uint8_t *) (t->password + cap);
+    t->department = t->category + cap;
+    t->allocated = t->department + cap;
+    for (int p = 0; p < PREF_COUNT; p++)
+        t->pref[p] = t->allocated + cap * (p + 1);
+    return 0;
+}
+
+void tableFree(ApplicantTable *t) {
+    free(t->id);
+    memset(t, 0, sizeof(*t));
+}
+
+/* ============ ROW CONVERSION ============ */
+int tableFromRows(ApplicantTable *t, const Applicant a[], int n) {
+    if (tableInit(t, n) != 0) return -1;
+
+    for (int i = 0; i < n; i++) {
+        t->id[i] = a[i].id;
+        t->marks[i] = a[i].marks;
+        t->jee_rank[i] = a[i].jee_rank;
+        t->name[i] = a[i].name;
+        t->password[i] = a[i].password;
+        for (int p = 0; p < PREF_COUNT; p++)
+            t->pref[p][i] = a[i].pref[p];
+        t->category[i] = a[i].category;
+        t->department[i] = a[i].department;
+        t->allocated[i] = a[i].allocated;
+    }
+    t->count = n;
+    return 0;
+}
+
+Applicant tableRow(const ApplicantTable *t, int i) {
+    Applicant a;
+
+    a.id = t->id[i];
+    a.marks = t->marks[i];
+    a.jee_rank = t->jee_rank[i];
+    a.name = t->name[i];
+    a.password = t->password[i];
+    for (int p = 0; p < PREF_COUNT; p++)
+        a.pref[p] = t->pref[p][i];
+    a.category = t->category[i];
+    a.department = t->department[i];
+    a.allocated = t->allocated[i];
+    return a;
+}
+
+/* a[] must hold t->count rows */
+void tableToRows(const ApplicantTable *t, Applicant a[]) {
+    for (int i = 0; i < t->count; i++)
+        a[i] = tableRow(t, i);
+}
+
+/* ============ SORT BY MERIT ============ */
+/* Sorts (key, index) pairs built from the rank and marks columns,
+   then gathers every column into merit order. Same order as
+   sortApplicants() with the same algorithm. Returns -1, leaving
+   the table unchanged, when out of memory. */
+int tableSort(ApplicantTable *t, SortAlgorithm algo, int threads) {
+    int n = t->count;
+    if (n < 2) return 0;
+
+    ApplicantTable sorted;
+    MeritKey *k = malloc(n * sizeof(MeritKey));
+    if (!k || tableInit(&sorted, n) != 0) {
+        free(k);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        k[i].key = meritKey(t->jee_rank[i], t->marks[i]);
+        k[i].index = i;
+    }
+    if (sortMeritKeys(k, n, algo, threads) != 0) {
+        free(k);
+        tableFree(&sorted);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) sorted.id[i] = t->id[k[i].index];
+    for (int i = 0; i < n; i++) sorted.marks[i] = t->marks[k[i].index];
+    for (int i = 0; i < n; i++) sorted.jee_rank[i] = t->jee_rank[k[i].index];
+    for (int i = 0; i < n; i++) sorted.name[i] = t->name[k[i].index];
+    for (int i = 0; i < n; i++) sorted.password[i] = t->password[k[i].index];
+    for (int p = 0; p < PREF_COUNT; p++)
+        for (int i = 0; i < n; i++) sorted.pref[p][i] = t->pref[p][k[i].index];
+    for (int i = 0; i < n; i++) sorted.category[i] = t->category[k[i].index];
+    for (int i = 0; i < n; i++) sorted.department[i] = t->department[k[i].index];
+    for (int i = 0; i < n; i++) sorted.allocated[i] = t->allocated[k[i].index];
+
+    sorted.count = n;
+    free(k);
+    tableFree(t);
+    *t = sorted;
+    return 0;
+}
+
+/* ============ FILTER ============ */
+/* Selection bitmap of the rows matching f, or NULL when out of
+   memory. Each predicate is one kernel pass over its column. */
+static uint64_t *selectRows(const ApplicantTable *t, const TableFilter *f) {
+    int n = t->count;
+    size_t words = BITMAP_WORDS(n > 0 ? n : 1);
+    uint64_t *sel = malloc(words * sizeof(uint64_t));
+    uint64_t *pass = malloc(words * sizeof(uint64_t));
+    if (!sel || !pass) {
+        free(sel);
+        free(pass);
+        return NULL;
+    }
+
+    bitmapFill(sel, n);
+    if (f->category >= 0) {
+        scanEqU8(t->category, n, (uint8_t) f->category, pass);
+        bitmapAnd(sel, pass, n);
+    }
+    if (f->department >= 0) {
+        scanEqU8(t->department, n, (uint8_t) f->department, pass);
+        bitmapAnd(sel, pass, n);
+    }
+    if (f->allocated >= 0) {
+        scanEqU8(t->allocated, n, (uint8_t) f->allocated, pass);
+        bitmapAnd(sel, pass, n);
+    }
+    if (f->rankMin > INT_MIN || f->rankMax < INT_MAX) {
+        scanRangeI32(t->jee_rank, n, f->rankMin, f->rankMax, pass);
+        bitmapAnd(sel, pass, n);
+    }
+    if (f->marksMin > INT_MIN || f->marksMax < INT_MAX) {
+        scanRangeI32(t->marks, n, f->marksMin, f->marksMax, pass);
+        bitmapAnd(sel, pass, n);
+    }
+    free(pass);
+    return sel;
+}
+
+/* Writes the indexes of matching rows, in table order, to out[]
+   (room for t->count) and returns how many matched, or -1 when
+   out of memory. */
+int tableFilter(const ApplicantTable *t, const TableFilter *f, int out[]) {
+    uint64_t *sel = selectRows(t, f);
+    if (!sel) return -1;
+
+    int m = bitmapRows(sel, t->count, out);
+    free(sel);
+    return m;
+}
+
+/* Number of rows matching f, or -1 when out of memory */
+int tableCount(const ApplicantTable *t, const TableFilter *f) {
+    uint64_t *sel = selectRows(t, f);
+    if (!sel) return -1;
+
+    int m = bitmapCount(sel, t->count);
+    free(sel);
+    return m;
+}
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "async_log.h"
+
+#define LOG_BATCH_BYTES (64 * 1024)
+
+typedef struct {
+    time_t when;
+    int status;
+    char method[12];
+    char uri[168];
+    char details[64];
+} LogRecord;
+
+/* Bounded multi-producer ring: a slot is free for position p when its
+   sequence equals p and holds a record when it equals p + 1. */
+typedef struct {
+    _Atomic size_t seq;
+    LogRecord rec;
+} LogSlot;
+
+static LogSlot *ring = NULL;
+static _Atomic size_t tail;         /* next position producers claim */
+static size_t head;                 /* next position the writer reads */
+static atomic_ullong dropped;
+
+static FILE *logFp = NULL;
+static char logPath[512];
+static LogRotation rotation;
+static size_t fileBytes;
+static time_t fileOpened;
+
+static pthread_t writer;
+static pthread_mutex_t wakeLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+static atomic_int stopping;
+
+static void stamp(time_t when, char *out, size_t size) {
+    struct tm tm;
+    localtime_r(&when, &tm);
+    strftime(out, size, "%Y-%m-%d %H:%M:%S", &tm);
+}
+
+/* ============ ROTATION ============ */
+static int openFile(void) {
+    struct stat st;
+    logFp = fopen(logPath, "a");
+    if (!logFp) return -1;
+    setvbuf(logFp, NULL, _IOFBF, LOG_BATCH_BYTES);
+    fileBytes = stat(logPath, &st) == 0 ? (size_t) st.st_size : 0;
+    fileOpened = time(NULL);
+    return 0;
+}
+
+/* NAME.<keep-1> -> NAME.<keep>, ..., NAME -> NAME.1 */
+static void rotate(void) {
+    char from[540], to[540];
+
+    fclose(logFp);
+    logFp = NULL;
+    for (int i = rotation.keep - 1; i >= 0; i--) {
+        if (i == 0) snprintf(from, sizeof(from), "%s", logPath);
+        else snprintf(from, sizeof(from), "%s.%d", logPath, i);
+        snprintf(to, sizeof(to), "%s.%d", logPath, i + 1);
+        rename(from, to);
+    }
+    if (rotation.keep < 1) remove(logPath);
+    openFile();
+}
+
+static int rotationDue(time_t now) {
+    return (rotation.maxBytes > 0 && fileBytes >= rotation.maxBytes) ||
+           (rotation.maxAgeSeconds > 0 && now - fileOpened >= rotation.maxAgeSeconds);
+}
+
+/* ============ WRITER THREAD ============ */
+/* Formats everything queued into one buffer per batch and writes it
+   with a single flush. The timestamp text is reused while the second
+   does not change. */
+static void drain(void) {
+    static char batch[LOG_BATCH_BYTES];
+    static time_t stampedAt = -1;
+    static char timestamp[32];
+    static unsigned long long reported = 0;
+    size_t len = 0;
+
+    for (;;) {
+        LogSlot *slot = &ring[head & (LOG_RING_SIZE - 1)];
+        int more = atomic_load_explicit(&slot->seq, memory_order_acquire) == head + 1;
+
+        if (len > 0 && (!more || len > sizeof(batch) - 512)) {
+            if (logFp) {
+                fwrite(batch, 1, len, logFp);
+                fflush(logFp);
+                fileBytes += len;
+                if (rotationDue(time(NULL))) rotate();
+            }
+            len = 0;
+        }
+        if (!more) break;
+
+        LogRecord *r = &slot->rec;
+        if (r->when != stampedAt) {
+            stamp(r->when, timestamp, sizeof(timestamp));
+            stampedAt = r->when;
+        }
+        int n = snprintf(batch + len, sizeof(batch) - len, "[%s] %s %s -> %d%s%s\n",
+                         timestamp, r->method, r->uri, r->status,
+                         r->details[0] ? " | " : "", r->details);
+        len += n > 0 ? (size_t) n : 0;
+
+        atomic_store_explicit(&slot->seq, head + LOG_RING_SIZE, memory_order_release);
+        head++;
+    }
+
+    unsigned long long lost = atomic_load(&dropped);
+    if (lost != reported && logFp) {
+        stamp(time(NULL), timestamp, sizeof(timestamp));
+        stampedAt = -1;
+        fileBytes += (size_t) fprintf(logFp, "[%s] log buffer full: %llu records dropped\n",
+                                      timestamp, lost - reported);
+        fflush(logFp);
+        reported = lost;
+    }
+    if (logFp && rotationDue(time(NULL))) rotate();
+}
+
+static void *writerMain(void *arg) {
+    (void) arg;
+    while (!atomic_load(&stopping)) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += LOG_FLUSH_MS * 1000000L;
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&wakeLock);
+        if (!atomic_load(&stopping))
+            pthread_cond_timedwait(&wake, &wakeLock, &until);
+        pthread_mutex_unlock(&wakeLock);
+        drain();
+    }
+    drain();
+    return NULL;
+}
+
+/* ============ OPEN / CLOSE ============ */
+/* Creates dir if needed, appends to dir/name and writes the start
+   banner. Returns 0, or -1 if the file or writer cannot be set up. */
+int asyncLogOpen(const char *dir, const char *name, const LogRotation *rot) {
+    char timestamp[32];
+
+    mkdir(dir, 0755);
+    snprintf(logPath, sizeof(logPath), "%s/%s", dir, name);
+    rotation = *rot;
+    if (openFile() < 0) return -1;
+
+    ring = malloc(LOG_RING_SIZE * sizeof(LogSlot));
+    if (!ring) {
+        fclose(logFp);
+        logFp = NULL;
+        return -1;
+    }
+    for (size_t i = 0; i < LOG_RING_SIZE; i++)
+        atomic_init(&ring[i].seq, i);
+    atomic_store(&tail, 0);
+    head = 0;
+    atomic_store(&dropped, 0);
+    atomic_store(&stopping, 0);
+
+    stamp(time(NULL), timestamp, sizeof(timestamp));
+    fprintf(logFp, "\n========================================\n");
+    fprintf(logFp, "Server started at %s\n", timestamp);
+    fprintf(logFp, "========================================\n");
+    fflush(logFp);
+
+    if (pthread_create(&writer, NULL, writerMain, NULL) != 0) {
+        fclose(logFp);
+        logFp = NULL;
+        free(ring);
+        ring = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/* Drains what is queued, then writes the stop line */
+void asyncLogClose(void) {
+    char timestamp[32];
+    if (!ring) return;
+
+    pthread_mutex_lock(&wakeLock);
+    atomic_store(&stopping, 1);
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&wakeLock);
+    pthread_join(writer, NULL);
+
+    if (logFp) {
+        stamp(time(NULL), timestamp, sizeof(timestamp));
+        fprintf(logFp, "Server stopped at %s\n", timestamp);
+        fclose(logFp);
+        logFp = NULL;
+    }
+    free(ring);
+    ring = NULL;
+}
+
+/* ============ ENQUEUE ============ */
+/* Copies the record and returns; never blocks and never touches the file */
+void asyncLogWrite(const char *method, const char *uri, int status, const char *details) {
+    if (!ring) return;
+
+    size_t pos = atomic_load_explicit(&tail, memory_order_relaxed);
+    LogSlot *slot;
+    for (;;) {
+        slot = &ring[pos & (LOG_RING_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&tail, memory_order_relaxed);
+        }
+    }
+
+    LogRecord *r = &slot->rec;
+    r->when = time(NULL);
+    r->status = status;
+    snprintf(r->method, sizeof(r->method), "%s", method);
+    snprintf(r->uri, sizeof(r->uri), "%s", uri);
+    snprintf(r->details, sizeof(r->details), "%s", details ? details : "");
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+    // Half the ring queued: wake the writer early instead of waiting
+    if ((pos & (LOG_RING_SIZE / 2 - 1)) == LOG_RING_SIZE / 2 - 1)
+        pthread_cond_signal(&wake);
+}
+
+unsigned long long asyncLogDropped(void) {
+    return atomic_load(&dropped);
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "student.h"
+#include "department.h"
 #include "auth.h"
 #include "csv_handler.h"
 #include "admin_menu.h"
@@ -114,8 +115,8 @@ void adminLogin() {
 /* ============ STUDENT LOGIN ============ */
 void studentLogin() {
     int id;
-    char name[50];
-    char password[20];
+    char name[NAME_LEN];
+    char password[PASSWORD_LEN];
     int attempts = 3;
 
     printf("\n------------- STUDENT LOGIN -----------\n");
@@ -131,7 +132,7 @@ void studentLogin() {
         int nameIndex = -1;
 
         for (int i = 0; i < n; i++) {
-            if (strcmp(a[i].name, name) == 0) {
+            if (strcmp(applicantName(&a[i]), name) == 0) {
                 nameIndex = i;
                 break;
             }
@@ -202,7 +203,7 @@ void studentLogin() {
         getchar();
 
         // Check password
-        if (strcmp(a[idIndex].password, password) == 0) {
+        if (strcmp(applicantPassword(&a[idIndex]), password) == 0) {
             printf("\n");
             printSuccess("Student Login Successful!");
             printf("\n");
@@ -228,6 +229,8 @@ void studentRegistration() {
     int n = loadApplicants(a);
     int nextId = 1000;
 
+    if (n < 0) return;
+
     // Calculate next available ID starting from 1000
     if (n > 0) {
         int maxId = 999;
@@ -244,19 +247,23 @@ void studentRegistration() {
     newStudent.id = nextId;
     printf("\nYour Application ID: %d\n", newStudent.id);
 
+    char name[NAME_LEN], password[PASSWORD_LEN];
+
     printf("Enter Name: ");
-    scanf(" %49[^\n]", newStudent.name);
+    scanf(" %49[^\n]", name);
     getchar();
+    newStudent.name = arenaIntern(name);
 
     printf("Enter Password (3-9 characters): ");
-    scanf("%19s", newStudent.password);
+    scanf("%19s", password);
     getchar();
 
-    while (strlen(newStudent.password) < 3 || strlen(newStudent.password) > 9) {
+    while (strlen(password) < 3 || strlen(password) > 9) {
         printf("Password must be 3-9 characters. Enter again: ");
-        scanf("%19s", newStudent.password);
+        scanf("%19s", password);
         getchar();
     }
+    newStudent.password = arenaIntern(password);
 
     printf("Enter Category:\n");
     printf("1. GEN\n");
@@ -267,11 +274,10 @@ void studentRegistration() {
     int catChoice;
     scanf(" %d", &catChoice);
     getchar();
-    const char *categories[] = {"GEN", "OBC", "SC", "ST"};
-    if (catChoice >= 1 && catChoice <= 4) {
-        strcpy(newStudent.category, categories[catChoice - 1]);
+    if (catChoice >= 1 && catChoice <= CAT_COUNT) {
+        newStudent.category = (uint8_t) (catChoice - 1);
     } else {
-        strcpy(newStudent.category, "GEN");
+        newStudent.category = CAT_GEN;
     }
 
     printf("Enter JEE Rank: ");
@@ -282,28 +288,18 @@ void studentRegistration() {
     scanf("%d", &newStudent.marks);
     clearInputBuffer();
 
-    printf("\nNow choose department preferences:\n\n");
-    printf("Available Departments:\n");
-    printf("1. CSE\n");
-    printf("2. IT\n");
-    printf("3. TT\n");
-    printf("4. APM\n\n");
-    printf("Enter preference order (numbers 1-4, one per line):\n");
+    printf("\nNow choose department preferences:\n");
+    listDepartments();
+    printf("Enter preference order (numbers or codes, one per line):\n");
 
-    const char *depts[] = {"CSE", "IT", "TT", "APM"};
     for (int i = 0; i < PREF_COUNT; i++) {
-        int choice;
         printf("Preference %d: ", i + 1);
-        scanf("%d", &choice);
+        int dept = readDepartmentChoice();
         getchar();
-        if (choice >= 1 && choice <= 4) {
-            strcpy(newStudent.pref[i], depts[choice - 1]);
-        } else {
-            strcpy(newStudent.pref[i], "CSE");
-        }
+        newStudent.pref[i] = (uint8_t) (dept >= 0 ? dept : 0);
     }
 
-    strcpy(newStudent.department, "N/A");
+    newStudent.department = DEPT_NONE;
     newStudent.allocated = 0;
 
     // Save to CSV
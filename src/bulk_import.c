@@ -0,0 +1,405 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include "student.h"
+#include "department.h"
+#include "json_request.h"
+#include "bulk_import.h"
+
+enum {
+    COL_IGNORE, COL_ID, COL_NAME, COL_PASSWORD, COL_CATEGORY,
+    COL_PREF1, COL_PREF2, COL_PREF3, COL_PREF4, COL_MARKS, COL_RANK
+};
+
+static const char *columnNames[] = {
+    "", "ID", "Name", "Password", "Category",
+    "Pref1", "Pref2", "Pref3", "Pref4", "Marks", "JEE_Rank"
+};
+#define COLUMN_COUNT (int) (sizeof(columnNames) / sizeof(columnNames[0]))
+
+/* One input record as text, before it is validated and converted.
+   Numbers are kept wide so acceptRecord() range-checks them before
+   they are narrowed, whichever format they came from. */
+typedef struct {
+    long id;
+    char name[NAME_LEN];
+    char password[PASSWORD_LEN];
+    char category[5];
+    char pref[PREF_COUNT][PROGRAM_CODE_LEN];
+    long marks;
+    long jee_rank;
+} RecordText;
+
+/* NDJSON record schema: same fields as POST /api/register plus an optional ID */
+static const JsonField recordSchema[] = {
+    {"id",       JSON_INT,          0, 0,  0},
+    {"name",     JSON_STRING,       1, 49, 0},
+    {"password", JSON_STRING,       1, 19, 0},
+    {"category", JSON_STRING,       1, 4,  0},
+    {"jee_rank", JSON_INT,          1, 0,  0},
+    {"marks",    JSON_INT,          1, 0,  0},
+    {"pref",     JSON_STRING_ARRAY, 1, PROGRAM_CODE_LEN - 1, PREF_COUNT},
+};
+enum { RF_ID, RF_NAME, RF_PASSWORD, RF_CATEGORY, RF_RANK, RF_MARKS, RF_PREF, RF_FIELDS };
+
+/* ============ ID SET (OPEN ADDRESSING, 0 = EMPTY) ============ */
+static int idSlot(const int *ids, int slots, int id) {
+    unsigned h = (unsigned) id * 2654435761u;
+    int i = (int) (h & (unsigned) (slots - 1));
+    while (ids[i] != 0 && ids[i] != id)
+        i = (i + 1) & (slots - 1);
+    return i;
+}
+
+static int idGrow(BulkImport *b) {
+    int slots = b->idSlots * 2;
+    int *ids = calloc(slots, sizeof(int));
+    if (!ids) return -1;
+
+    for (int i = 0; i < b->idSlots; i++) {
+        if (b->ids[i] != 0)
+            ids[idSlot(ids, slots, b->ids[i])] = b->ids[i];
+    }
+    free(b->ids);
+    b->ids = ids;
+    b->idSlots = slots;
+    return 0;
+}
+
+/* Returns 1 if added, 0 if already present, -1 on allocation failure */
+static int idInsert(BulkImport *b, int id) {
+    if (2 * (b->idCount + 1) > b->idSlots && idGrow(b) < 0)
+        return -1;
+
+    int i = idSlot(b->ids, b->idSlots, id);
+    if (b->ids[i] == id) return 0;
+    b->ids[i] = id;
+    b->idCount++;
+    return 1;
+}
+
+/* ============ RECORD ERRORS ============ */
+static void reject(BulkImport *b, const char *error) {
+    if (b->nerrors < BULK_MAX_ERRORS) {
+        b->errors[b->nerrors].line = b->line;
+        snprintf(b->errors[b->nerrors].error, sizeof(b->errors[0].error), "%s", error);
+        b->nerrors++;
+    }
+    b->rejected++;
+}
+
+/* ============ FIELD HELPERS ============ */
+static int copyField(char *dst, size_t size, const char *s, size_t len) {
+    if (len >= size) return -1;
+    memcpy(dst, s, len);
+    dst[len] = '\0';
+    return 0;
+}
+
+static int parseIntField(const char *s, size_t len, long *out) {
+    long v = 0;
+    size_t i = 0;
+    int neg = 0;
+
+    while (len > 0 && (s[len - 1] == ' ' || s[len - 1] == '\r')) len--;
+    while (i < len && s[i] == ' ') i++;
+    if (i < len && s[i] == '-') {
+        neg = 1;
+        i++;
+    }
+    if (i == len) return -1;
+    for (; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9' || v > (LONG_MAX - (s[i] - '0')) / 10) return -1;
+        v = v * 10 + (s[i] - '0');
+    }
+    *out = neg ? -v : v;
+    return 0;
+}
+
+/* ============ VALIDATE AND ACCEPT ONE RECORD ============ */
+static void acceptRecord(BulkImport *b, RecordText *t) {
+    Applicant a = {0};
+
+    if (t->name[0] == '\0' || strpbrk(t->name, ",\r\n")) {
+        reject(b, "Invalid name");
+        return;
+    }
+    if (strlen(t->password) < 3 || strpbrk(t->password, ",\r\n")) {
+        reject(b, "Password must be 3-19 characters without commas");
+        return;
+    }
+    int category = parseCategory(t->category);
+    if (category < 0) {
+        reject(b, "Category must be GEN, OBC, SC or ST");
+        return;
+    }
+    for (int i = 0; i < PREF_COUNT; i++) {
+        int dept = parseDepartment(t->pref[i]);
+        if (dept < 0 || dept == DEPT_NONE) {
+            reject(b, "Unknown department in preferences");
+            return;
+        }
+        a.pref[i] = (uint8_t) dept;
+    }
+    if (t->marks < 0 || t->marks > 100) {
+        reject(b, "Marks must be 0-100");
+        return;
+    }
+    if (t->jee_rank < 1 || t->jee_rank > INT_MAX) {
+        reject(b, "JEE rank must be positive");
+        return;
+    }
+
+    // Assign or check the ID against everything seen so far
+    if (t->id == 0) {
+        while (b->nextId <= INT_MAX && b->ids &&
+               b->ids[idSlot(b->ids, b->idSlots, (int) b->nextId)] == b->nextId)
+            b->nextId++;
+        if (b->nextId > INT_MAX) {
+            reject(b, "No free ID left");
+            return;
+        }
+        t->id = b->nextId++;
+    } else if (t->id < 0 || t->id > INT_MAX) {
+        reject(b, "Invalid ID");
+        return;
+    }
+
+    int added = idInsert(b, (int) t->id);
+    if (added <= 0) {
+        reject(b, added == 0 ? "Duplicate ID" : "Out of memory");
+        return;
+    }
+
+    if (b->count == b->capacity) {
+        int cap = b->capacity ? b->capacity * 2 : 1024;
+        Applicant *rows = realloc(b->rows, cap * sizeof(Applicant));
+        if (!rows) {
+            reject(b, "Out of memory");
+            return;
+        }
+        b->rows = rows;
+        b->capacity = cap;
+    }
+
+    a.id = (int) t->id;
+    a.name = arenaIntern(t->name);
+    a.password = arenaIntern(t->password);
+    a.category = (uint8_t) category;
+    a.department = DEPT_NONE;
+    a.marks = (int) t->marks;
+    a.jee_rank = (int) t->jee_rank;
+    b->rows[b->count++] = a;
+}
+
+/* ============ NDJSON LINE ============ */
+static void parseJsonLine(BulkImport *b, const char *s, size_t len) {
+    JsonValue f[RF_FIELDS];
+    char err[BULK_ERROR_LEN];
+    RecordText a = {0};
+
+    if (jsonParseRequest(s, len, recordSchema, RF_FIELDS, f, err, sizeof(err)) < 0) {
+        reject(b, err);
+        return;
+    }
+    if (f[RF_PREF].count != PREF_COUNT) {
+        reject(b, "pref must list 4 departments");
+        return;
+    }
+
+    jsonCopyString(a.name, sizeof(a.name), f[RF_NAME].str);
+    jsonCopyString(a.password, sizeof(a.password), f[RF_PASSWORD].str);
+    jsonCopyString(a.category, sizeof(a.category), f[RF_CATEGORY].str);
+    for (int i = 0; i < PREF_COUNT; i++)
+        jsonCopyString(a.pref[i], sizeof(a.pref[i]), f[RF_PREF].items[i]);
+    a.id = f[RF_ID].present ? f[RF_ID].num : 0;
+    a.jee_rank = f[RF_RANK].num;
+    a.marks = f[RF_MARKS].num;
+
+    acceptRecord(b, &a);
+}
+
+/* ============ CSV HEADER: MAP COLUMNS BY NAME ============ */
+static void parseCsvHeader(BulkImport *b, const char *s, size_t len) {
+    const char *end = s + len;
+    int seen[COLUMN_COUNT] = {0};
+
+    b->ncolumns = 0;
+    while (s <= end && b->ncolumns < BULK_MAX_COLUMNS) {
+        const char *comma = memchr(s, ',', end - s);
+        size_t n = (comma ? comma : end) - s;
+        int col = COL_IGNORE;
+
+        while (n > 0 && (s[n - 1] == ' ' || s[n - 1] == '\r')) n--;
+        for (int c = 1; c < COLUMN_COUNT; c++) {
+            if (strlen(columnNames[c]) == n && strncasecmp(s, columnNames[c], n) == 0)
+                col = c;
+        }
+        seen[col] = 1;
+        b->columns[b->ncolumns++] = col;
+        if (!comma) break;
+        s = comma + 1;
+    }
+
+    b->headerSeen = 1;
+    for (int c = COL_NAME; c < COLUMN_COUNT; c++) {
+        if (!seen[c]) {
+            char msg[BULK_ERROR_LEN];
+            snprintf(msg, sizeof(msg), "Header is missing column %s", columnNames[c]);
+            reject(b, msg);
+            b->ncolumns = 0;   // every following row is rejected
+            return;
+        }
+    }
+}
+
+/* ============ CSV DATA ROW ============ */
+static void parseCsvLine(BulkImport *b, const char *s, size_t len) {
+    const char *end = s + len;
+    RecordText a = {0};
+    int ok = 0;
+
+    if (b->ncolumns == 0) {
+        reject(b, "No usable CSV header");
+        return;
+    }
+
+    for (int c = 0; c < b->ncolumns; c++) {
+        const char *comma = memchr(s, ',', end - s);
+        size_t n = (comma ? comma : end) - s;
+        int rc = 0;
+
+        if (!comma && c < b->ncolumns - 1) {
+            reject(b, "Too few columns");
+            return;
+        }
+        if (n > 0 && s[n - 1] == '\r') n--;
+
+        switch (b->columns[c]) {
+            case COL_ID:       rc = n == 0 ? 0 : parseIntField(s, n, &a.id); break;
+            case COL_NAME:     rc = copyField(a.name, sizeof(a.name), s, n); break;
+            case COL_PASSWORD: rc = copyField(a.password, sizeof(a.password), s, n); break;
+            case COL_CATEGORY: rc = copyField(a.category, sizeof(a.category), s, n); break;
+            case COL_PREF1:
+            case COL_PREF2:
+            case COL_PREF3:
+            case COL_PREF4:
+                rc = copyField(a.pref[b->columns[c] - COL_PREF1], sizeof(a.pref[0]), s, n);
+                break;
+            case COL_MARKS:    rc = parseIntField(s, n, &a.marks); break;
+            case COL_RANK:     rc = parseIntField(s, n, &a.jee_rank); break;
+            default:           break;
+        }
+        if (rc < 0) {
+            char msg[BULK_ERROR_LEN];
+            snprintf(msg, sizeof(msg), "Invalid %s", columnNames[b->columns[c]]);
+            reject(b, msg);
+            return;
+        }
+        if (!comma) {
+            ok = c == b->ncolumns - 1;
+            break;
+        }
+        s = comma + 1;
+    }
+
+    if (!ok) {
+        reject(b, "Too many columns");
+        return;
+    }
+    acceptRecord(b, &a);
+}
+
+/* ============ DISPATCH ONE COMPLETE LINE ============ */
+static void processLine(BulkImport *b, const char *s, size_t len) {
+    b->line++;
+
+    // Blank lines are allowed anywhere
+    size_t i = 0;
+    while (i < len && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r')) i++;
+    if (i == len) return;
+
+    if (b->format == BULK_NDJSON)
+        parseJsonLine(b, s, len);
+    else if (!b->headerSeen)
+        parseCsvHeader(b, s, len);
+    else
+        parseCsvLine(b, s, len);
+}
+
+/* ============ START AN IMPORT ============ */
+/* existing[] are the records already stored; their IDs are reserved
+   and new IDs continue after the largest one. */
+int bulkBegin(BulkImport *b, BulkFormat format, const Applicant *existing, int n) {
+    memset(b, 0, sizeof(*b));
+    b->format = format;
+    b->idSlots = 1024;
+    while (b->idSlots < 2 * (n + 1)) b->idSlots *= 2;
+    b->ids = calloc(b->idSlots, sizeof(int));
+    if (!b->ids) return -1;
+
+    int maxId = 999;
+    for (int i = 0; i < n; i++) {
+        if (existing[i].id > 0 && idInsert(b, existing[i].id) < 0) return -1;
+        if (existing[i].id > maxId) maxId = existing[i].id;
+    }
+    b->nextId = (long) maxId + 1;
+    return 0;
+}
+
+/* ============ FEED A CHUNK OF INPUT ============ */
+void bulkFeed(BulkImport *b, const char *buf, size_t len) {
+    const char *end = buf + len;
+
+    while (buf < end) {
+        const char *nl = memchr(buf, '\n', end - buf);
+        size_t n = (nl ? nl : end) - buf;
+
+        if (b->carryLen > 0 || b->carryOverflow || !nl) {
+            // Line spans chunks: stitch it together in the carry buffer
+            if (b->carryLen + n > sizeof(b->carry)) {
+                b->carryOverflow = 1;
+            } else {
+                memcpy(b->carry + b->carryLen, buf, n);
+                b->carryLen += n;
+            }
+            if (nl) {
+                if (b->carryOverflow) {
+                    b->line++;
+                    reject(b, "Line too long");
+                } else {
+                    processLine(b, b->carry, b->carryLen);
+                }
+                b->carryLen = 0;
+                b->carryOverflow = 0;
+            }
+        } else {
+            processLine(b, buf, n);
+        }
+
+        if (!nl) break;
+        buf = nl + 1;
+    }
+}
+
+/* ============ END OF INPUT ============ */
+void bulkFinish(BulkImport *b) {
+    if (b->carryOverflow) {
+        b->line++;
+        reject(b, "Line too long");
+    } else if (b->carryLen > 0) {
+        processLine(b, b->carry, b->carryLen);
+    }
+    b->carryLen = 0;
+    b->carryOverflow = 0;
+}
+
+/* ============ RELEASE AN IMPORT ============ */
+void bulkFree(BulkImport *b) {
+    free(b->rows);
+    free(b->ids);
+    b->rows = NULL;
+    b->ids = NULL;
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "capture.h"
+
+static FILE *captureFp = NULL;
+static uint64_t captureStartUs = 0;
+
+uint64_t captureNowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+
+/* ============ OPEN FOR WRITING ============ */
+/* Truncates path. Returns 0, or -1 if it cannot be created. */
+int captureOpen(const char *path) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    setvbuf(fp, NULL, _IOFBF, 1 << 20);
+
+    CaptureHeader h;
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CAPTURE_MAGIC, sizeof(h.magic));
+    h.version = CAPTURE_VERSION;
+    h.startUnixUs = (uint64_t) wall.tv_sec * 1000000u + (uint64_t) wall.tv_nsec / 1000u;
+
+    if (fwrite(&h, sizeof(h), 1, fp) != 1) {
+        fclose(fp);
+        return -1;
+    }
+    captureFp = fp;
+    captureStartUs = captureNowUs();
+    return 0;
+}
+
+int captureEnabled(void) {
+    return captureFp != NULL;
+}
+
+/* ============ APPEND ONE REQUEST ============ */
+/* Buffered; the caller flushes periodically with captureFlush(). */
+void captureWrite(uint64_t arrivalUs, uint32_t latencyUs, int status,
+                  const char *method, size_t methodLen,
+                  const char *uri, size_t uriLen,
+                  const char *body, size_t bodyLen) {
+    if (!captureFp) return;
+
+    CaptureRecord r;
+    memset(&r, 0, sizeof(r));
+    r.offsetUs = arrivalUs > captureStartUs ? arrivalUs - captureStartUs : 0;
+    r.latencyUs = latencyUs;
+    r.status = (uint16_t) status;
+    r.methodLen = (uint8_t) (methodLen > 255 ? 255 : methodLen);
+    r.uriLen = (uint16_t) (uriLen > 65535 ? 65535 : uriLen);
+    r.bodyLen = (uint32_t) bodyLen;
+
+    fwrite(&r, sizeof(r), 1, captureFp);
+    fwrite(method, 1, r.methodLen, captureFp);
+    fwrite(uri, 1, r.uriLen, captureFp);
+    if (bodyLen > 0) fwrite(body, 1, bodyLen, captureFp);
+}
+
+void captureFlush(void) {
+    if (captureFp) fflush(captureFp);
+}
+
+void captureClose(void) {
+    if (captureFp) fclose(captureFp);
+    captureFp = NULL;
+}
+
+/* ============ READ BACK ============ */
+FILE *captureOpenRead(const char *path, CaptureHeader *h) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+
+    if (fread(h, sizeof(*h), 1, fp) != 1 ||
+        memcmp(h->magic, CAPTURE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != CAPTURE_VERSION) {
+        fclose(fp);
+        return NULL;
+    }
+    return fp;
+}
+
+/* Grow *buf to hold len bytes plus a terminator */
+static int reserve(char **buf, size_t *cap, size_t len) {
+    if (len + 1 <= *cap) return 0;
+    char *grown = realloc(*buf, len + 1);
+    if (!grown) return -1;
+    *buf = grown;
+    *cap = len + 1;
+    return 0;
+}
+
+/* Returns 1 with the next entry, 0 at end of file, -1 if truncated */
+int captureRead(FILE *fp, CaptureEntry *e) {
+    if (fread(&e->rec, sizeof(e->rec), 1, fp) != 1)
+        return feof(fp) ? 0 : -1;
+
+    if (reserve(&e->uri, &e->uriCap, e->rec.uriLen) < 0 ||
+        reserve(&e->body, &e->bodyCap, e->rec.bodyLen) < 0)
+        return -1;
+
+    if (fread(e->method, 1, e->rec.methodLen, fp) != e->rec.methodLen ||
+        fread(e->uri, 1, e->rec.uriLen, fp) != e->rec.uriLen ||
+        fread(e->body, 1, e->rec.bodyLen, fp) != e->rec.bodyLen)
+        return -1;
+
+    e->method[e->rec.methodLen] = '\0';
+    e->uri[e->rec.uriLen] = '\0';
+    e->body[e->rec.bodyLen] = '\0';
+    return 1;
+}
+
+void captureEntryFree(CaptureEntry *e) {
+    free(e->uri);
+    free(e->body);
+    e->uri = e->body = NULL;
+    e->uriCap = e->bodyCap = 0;
+}
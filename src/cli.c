@@ -0,0 +1,726 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "student.h"
+#include "csv_handler.h"
+#include "snapshot.h"
+#include "sorting.h"
+#include "department.h"
+#include "merit_engine.h"
+#include "applicant_table.h"
+#include "scan_kernels.h"
+#include "query.h"
+#include "scenario.h"
+#include "bulk_import.h"
+#include "cli.h"
+#include "trace.h"
+
+/* ============================================================
+   HEADLESS COMMAND-LINE MODE
+   admission_system <command> [--option=value ...]
+   Never prompts and never prints colour codes. Each command
+   prints one JSON object with its results and timings to stdout;
+   diagnostics go to stderr and failures return a non-zero status.
+   ============================================================ */
+
+#define DEFAULT_DATA_FILE "applicants_full.csv"
+#define DEFAULT_MERIT_FILE "merit_list.csv"
+#define DEFAULT_METRICS_FILE "logs/metrics.prom"
+#define MAX_METRIC_ROUTES 32
+
+typedef struct {
+    const char *in;
+    const char *out;
+    const char *meritOut;
+    const char *format;
+    const char *trace;
+    const char *query;
+    const char *scenarios;
+    SortAlgorithm sort;
+    int threads;               // 0 when not given
+    int sortStats;
+} CliOptions;
+
+/* ============ USAGE ============ */
+static void printUsage(void) {
+    fprintf(stderr,
+        "Usage: admission_system [command] [options]\n"
+        "Without a command the interactive menus are started.\n\n"
+        "Commands:\n"
+        "  merit   Sort, allocate seats and write the merit list\n"
+        "          --sort=selection|insertion|merge|quick|radix (default merge)\n"
+        "          --threads=N  sort N chunks in parallel (default 1)\n"
+        "          --in=FILE    applicants, CSV or snapshot (default " DEFAULT_DATA_FILE ")\n"
+        "          --out=FILE   where to save allocations (default: --in)\n"
+        "          --merit-out=FILE (default " DEFAULT_MERIT_FILE ")\n"
+        "          --sort-stats count comparisons, moves, bytes copied and\n"
+        "                       allocations made by the sort\n"
+        "          --trace=FILE write phase spans as Chrome trace JSON and\n"
+        "                       print a span summary table to stderr\n"
+        "  import  Validate and append applicants to the data file\n"
+        "          --in=FILE    NDJSON or CSV with a header row\n"
+        "          --format=csv|ndjson (default from extension)\n"
+        "          --out=FILE   data file to append to (default " DEFAULT_DATA_FILE ")\n"
+        "          exits with status 1 if any row was rejected\n"
+        "  export  Convert the data file\n"
+        "          --in=FILE --out=FILE --format=csv|json|bin (default from extension)\n"
+        "  stats   Print dataset statistics\n"
+        "          --in=FILE\n"
+        "  query   Answer an ad-hoc query without exporting, e.g.\n"
+        "          --q=\"count, avg(marks) where category = OBC and marks > 80\n"
+        "               and pref1 = TT group by department\"\n"
+        "          --in=FILE\n"
+        "  scenarios Allocate under many seat matrices and compare each\n"
+        "          with the default allocation (fill, cutoffs, displacement)\n"
+        "          --scenarios=FILE one per line:\n"
+        "                       name [CSE=20] [CSE.SC=3] [prefs=2]\n"
+        "          --threads=N  scenarios in parallel (default: one per core)\n"
+        "          --in=FILE --sort=...\n"
+        "  metrics Summarise an api_server --metrics-file dump per route\n"
+        "          --in=FILE (default " DEFAULT_METRICS_FILE ")\n");
+}
+
+/* ============ MONOTONIC CLOCK IN MILLISECONDS ============ */
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int hasSuffix(const char *s, const char *suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+/* ============ PARSE --key=value OPTIONS ============ */
+static int parseOptions(int argc, char *argv[], CliOptions *o) {
+    memset(o, 0, sizeof(*o));
+    o->sort = SORT_MERGE;
+
+    for (int i = 2; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *eq = strchr(arg, '=');
+        const char *val = eq ? eq + 1 : "";
+
+        if (strncmp(arg, "--in=", 5) == 0) {
+            o->in = val;
+        } else if (strncmp(arg, "--out=", 6) == 0) {
+            o->out = val;
+        } else if (strncmp(arg, "--merit-out=", 12) == 0) {
+            o->meritOut = val;
+        } else if (strncmp(arg, "--format=", 9) == 0) {
+            o->format = val;
+        } else if (strncmp(arg, "--trace=", 8) == 0) {
+            o->trace = val;
+        } else if (strncmp(arg, "--q=", 4) == 0) {
+            o->query = val;
+        } else if (strncmp(arg, "--scenarios=", 12) == 0) {
+            o->scenarios = val;
+        } else if (strcmp(arg, "--sort-stats") == 0) {
+            o->sortStats = 1;
+        } else if (strncmp(arg, "--sort=", 7) == 0) {
+            o->sort = parseSortAlgorithm(val);
+            if (o->sort == 0) {
+                fprintf(stderr, "Unknown sort algorithm: %s\n", val);
+                return -1;
+            }
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            o->threads = atoi(val);
+            if (o->threads < 1 || o->threads > MAX_SORT_THREADS) {
+                fprintf(stderr, "--threads must be 1-%d\n", MAX_SORT_THREADS);
+                return -1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ============ LOAD INPUT OR REPORT ============ */
+static int loadInput(const char *path, Applicant **a) {
+    int n = loadApplicantsAuto(path, a);
+    if (n == CSV_UNREADABLE)
+        fprintf(stderr, "Cannot read applicants from %s\n", path);   // invalid files are already reported
+    return n;
+}
+
+/* Save in the same format the file was read in (snapshot or CSV) */
+static int saveOutput(const char *path, int asSnapshot, Applicant a[], int n) {
+    int rc = asSnapshot ? saveSnapshot(path, a, n) : saveApplicantsTo(path, a, n);
+    if (rc != 0)
+        fprintf(stderr, "Cannot write %s\n", path);
+    return rc;
+}
+
+/* ============ JSON STRING WITH ESCAPES ============ */
+static void printJsonString(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', fp);
+        if ((unsigned char) *s < 0x20) fprintf(fp, "\\u%04x", *s);
+        else fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+/* ============ COMMAND: MERIT ============ */
+static int cmdMerit(const CliOptions *o) {
+    const char *in = o->in ? o->in : DEFAULT_DATA_FILE;
+    const char *out = o->out ? o->out : in;
+    const char *meritOut = o->meritOut ? o->meritOut : DEFAULT_MERIT_FILE;
+    int asSnapshot = isSnapshotFile(in);
+    int threads = o->threads > 0 ? o->threads : 1;
+    Applicant *a;
+    ApplicantTable table;
+    int seats[MAX_PROGRAMS];
+    double t0 = nowMs();
+
+    if (o->trace) traceEnable(1);
+    TraceSpan total = traceBegin("merit");
+    TraceSpan span = traceBegin("merit.load");
+    int n = loadInput(in, &a);
+    if (n < 0) return 1;
+    // Sort and allocation work on columns; rows come back for saving
+    if (tableFromRows(&table, a, n) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        free(a);
+        return 1;
+    }
+    span.n = n;
+    double loadMs = traceEnd(&span);
+
+    sortStatsEnable(o->sortStats);
+    sortStatsReset();
+    span = traceBegin("merit.sort");
+    span.n = n;
+    int sorted = tableSort(&table, o->sort, threads);
+    double sortMs = traceEnd(&span);
+    SortStats stats = sortStatsGet();
+    sortStatsEnable(0);
+    if (sorted != 0) {
+        fprintf(stderr, "Out of memory\n");
+        tableFree(&table);
+        free(a);
+        return 1;
+    }
+
+    span = traceBegin("merit.allocate");
+    int allocated = allocateTableSeats(&table, seats, NULL, NULL);
+    span.n = allocated;
+    double allocMs = traceEnd(&span);
+
+    span = traceBegin("merit.save_applicants");
+    tableToRows(&table, a);
+    tableFree(&table);
+    if (saveOutput(out, asSnapshot, a, n) != 0) {
+        free(a);
+        return 1;
+    }
+    double saveMs = traceEnd(&span);
+
+    span = traceBegin("merit.write_merit_list");
+    if (writeMeritList(meritOut, a, n) != 0) {
+        fprintf(stderr, "Cannot write %s\n", meritOut);
+        free(a);
+        return 1;
+    }
+    double meritMs = traceEnd(&span);
+    free(a);
+    total.n = n;
+    traceEnd(&total);
+
+    if (o->trace) {
+        tracePrintSummary(stderr, 0);
+        if (traceWriteChrome(o->trace, 0) != 0)
+            fprintf(stderr, "Cannot write %s\n", o->trace);
+    }
+
+    printf("{\"command\":\"merit\",\"sort\":\"%s\",\"threads\":%d,\"rows\":%d,"
+           "\"allocated\":%d,\"seats\":{",
+           sortAlgorithmName(o->sort), threads, n, allocated);
+    for (int d = 0; d < programCount(); d++)
+        printf("%s\"%s\":%d", d ? "," : "", getDeptCode(d), seats[d]);
+    if (o->sortStats)
+        printf("},\"sort_stats\":{\"comparisons\":%llu,\"moves\":%llu,\"bytes_copied\":%llu,"
+               "\"allocations\":%llu,\"bytes_allocated\":%llu",
+               stats.comparisons, stats.moves, stats.bytesCopied,
+               stats.allocations, stats.bytesAllocated);
+    printf("},\"load_ms\":%.3f,\"sort_ms\":%.3f,\"allocate_ms\":%.3f,"
+           "\"save_ms\":%.3f,\"merit_ms\":%.3f,\"total_ms\":%.3f}\n",
+           loadMs, sortMs, allocMs, saveMs, meritMs, nowMs() - t0);
+    return 0;
+}
+
+/* ============ COMMAND: IMPORT ============ */
+static int cmdImport(const CliOptions *o) {
+    const char *target = o->out ? o->out : DEFAULT_DATA_FILE;
+    BulkFormat format;
+    static BulkImport import;
+    Applicant *existing = NULL;
+    double t0 = nowMs(), t;
+
+    if (!o->in) {
+        fprintf(stderr, "import needs --in=FILE\n");
+        return 2;
+    }
+    if (o->format)
+        format = strcmp(o->format, "csv") == 0 ? BULK_CSV : BULK_NDJSON;
+    else
+        format = hasSuffix(o->in, ".csv") ? BULK_CSV : BULK_NDJSON;
+
+    FILE *fp = fopen(o->in, "rb");
+    if (!fp) {
+        fprintf(stderr, "Cannot read %s\n", o->in);
+        return 1;
+    }
+
+    // A missing data file just means we start empty
+    int asSnapshot = isSnapshotFile(target);
+    int n = loadApplicantsAuto(target, &existing);
+    if (n < 0 && access(target, F_OK) == 0) {
+        if (n == CSV_UNREADABLE) fprintf(stderr, "Cannot read applicants from %s\n", target);
+        fclose(fp);
+        return 1;
+    }
+    if (n < 0) n = 0;
+
+    if (bulkBegin(&import, format, existing, n) < 0) {
+        fprintf(stderr, "Out of memory\n");
+        fclose(fp);
+        free(existing);
+        return 1;
+    }
+
+    t = nowMs();
+    char *chunk = malloc(1 << 20);
+    size_t got;
+    while (chunk && (got = fread(chunk, 1, 1 << 20, fp)) > 0)
+        bulkFeed(&import, chunk, got);
+    bulkFinish(&import);
+    free(chunk);
+    fclose(fp);
+    double parseMs = nowMs() - t;
+
+    for (int i = 0; i < import.nerrors; i++)
+        fprintf(stderr, "%s:%d: %s\n", o->in, import.errors[i].line, import.errors[i].error);
+
+    t = nowMs();
+    int rc = 0;
+    if (import.count > 0) {
+        Applicant *all = realloc(existing, (size_t) (n + import.count) * sizeof(Applicant));
+        if (!all) {
+            fprintf(stderr, "Out of memory\n");
+            bulkFree(&import);
+            free(existing);
+            return 1;
+        }
+        existing = all;
+        memcpy(existing + n, import.rows, import.count * sizeof(Applicant));
+        rc = asSnapshot ? saveSnapshot(target, existing, n + import.count)
+                        : saveApplicantsDurable(target, existing, n + import.count);
+        if (rc != 0) fprintf(stderr, "Cannot write %s\n", target);
+    }
+    double saveMs = nowMs() - t;
+
+    printf("{\"command\":\"import\",\"format\":\"%s\",\"accepted\":%d,\"rejected\":%d,"
+           "\"rows\":%d,\"parse_ms\":%.3f,\"save_ms\":%.3f,\"total_ms\":%.3f}\n",
+           format == BULK_CSV ? "csv" : "ndjson", import.count, import.rejected,
+           n + (rc == 0 ? import.count : 0), parseMs, saveMs, nowMs() - t0);
+
+    int failed = rc != 0 || import.rejected > 0;
+    bulkFree(&import);
+    free(existing);
+    return failed ? 1 : 0;
+}
+
+/* ============ COMMAND: EXPORT ============ */
+static int cmdExport(const CliOptions *o) {
+    const char *in = o->in ? o->in : DEFAULT_DATA_FILE;
+    const char *format = o->format;
+    Applicant *a;
+    double t0 = nowMs();
+
+    if (!o->out) {
+        fprintf(stderr, "export needs --out=FILE\n");
+        return 2;
+    }
+    if (!format)
+        format = hasSuffix(o->out, ".json") ? "json" : hasSuffix(o->out, ".bin") ? "bin" : "csv";
+
+    int n = loadInput(in, &a);
+    if (n < 0) return 1;
+
+    int rc = 0;
+    if (strcmp(format, "csv") == 0) {
+        rc = saveApplicantsTo(o->out, a, n);
+    } else if (strcmp(format, "bin") == 0) {
+        rc = saveSnapshot(o->out, a, n);
+    } else if (strcmp(format, "json") == 0) {
+        FILE *fp = fopen(o->out, "w");
+        if (!fp) {
+            rc = -1;
+        } else {
+            // Same fields as GET /api/applicants (no passwords)
+            fputc('[', fp);
+            for (int i = 0; i < n; i++) {
+                fprintf(fp, "%s{\"id\":%d,\"name\":", i ? "," : "", a[i].id);
+                printJsonString(fp, applicantName(&a[i]));
+                fprintf(fp, ",\"category\":\"%s\",\"pref\":[", categoryCode(a[i].category));
+                for (int p = 0; p < PREF_COUNT; p++)
+                    fprintf(fp, "%s\"%s\"", p ? "," : "", getDeptCode(a[i].pref[p]));
+                fprintf(fp, "],\"department\":\"%s\"", getDeptCode(a[i].department));
+                fprintf(fp, ",\"marks\":%d,\"jee_rank\":%d,\"allocated\":%d}\n",
+                        a[i].marks, a[i].jee_rank, a[i].allocated);
+            }
+            fputs("]\n", fp);
+            rc = fclose(fp) == 0 ? 0 : -1;
+        }
+    } else {
+        fprintf(stderr, "Unknown export format: %s\n", format);
+        free(a);
+        return 2;
+    }
+    free(a);
+
+    if (rc != 0) {
+        fprintf(stderr, "Cannot write %s\n", o->out);
+        return 1;
+    }
+    printf("{\"command\":\"export\",\"format\":\"%s\",\"rows\":%d,\"total_ms\":%.3f}\n",
+           format, n, nowMs() - t0);
+    return 0;
+}
+
+/* ============ COMMAND: STATS ============ */
+static int cmdStats(const CliOptions *o) {
+    const char *in = o->in ? o->in : DEFAULT_DATA_FILE;
+    int catCount[CAT_COUNT] = {0}, deptFilled[DEPT_NONE + 1] = {0}, firstPref[DEPT_NONE + 1] = {0};
+    int allocated = 0, minRank = 0, maxRank = 0;
+    long long marksSum = 0;
+    Applicant *a;
+    ApplicantTable t;
+    double t0 = nowMs();
+
+    int n = loadInput(in, &a);
+    if (n < 0) return 1;
+    int loaded = tableFromRows(&t, a, n) == 0;
+    free(a);
+    if (!loaded) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || t.jee_rank[i] < minRank) minRank = t.jee_rank[i];
+        if (i == 0 || t.jee_rank[i] > maxRank) maxRank = t.jee_rank[i];
+        marksSum += t.marks[i];
+    }
+
+    // Counts are kernel passes over the code columns; departments
+    // can number in the hundreds, so theirs is one histogram pass
+    allocated = countEqU8(t.allocated, n, 1);
+    for (int c = 0; c < CAT_COUNT; c++)
+        catCount[c] = countEqU8(t.category, n, (uint8_t) c);
+    for (int i = 0; i < n; i++) {
+        firstPref[t.pref[0][i]]++;
+        if (t.allocated[i]) deptFilled[t.department[i]]++;
+    }
+    tableFree(&t);
+
+    printf("{\"command\":\"stats\",\"rows\":%d,\"allocated\":%d,\"waiting\":%d,"
+           "\"min_rank\":%d,\"max_rank\":%d,\"avg_marks\":%.2f,\"categories\":{",
+           n, allocated, n - allocated, minRank, maxRank, n ? (double) marksSum / n : 0.0);
+    for (int c = 0; c < CAT_COUNT; c++)
+        printf("%s\"%s\":%d", c ? "," : "", categoryCode(c), catCount[c]);
+    printf("},\"departments\":{");
+    for (int d = 0; d < programCount(); d++)
+        printf("%s\"%s\":{\"filled\":%d,\"seats\":%d,\"first_pref\":%d}",
+               d ? "," : "", getDeptCode(d), deptFilled[d], programSeats(d), firstPref[d]);
+    printf("},\"total_ms\":%.3f}\n", nowMs() - t0);
+    return 0;
+}
+
+/* ============ COMMAND: QUERY ============ */
+static int cmdQuery(const CliOptions *o) {
+    const char *in = o->in ? o->in : DEFAULT_DATA_FILE;
+    Query q;
+    QueryResult r;
+    ApplicantTable t;
+    Applicant *a;
+    char err[128], *json;
+    double t0 = nowMs();
+
+    if (queryParse(o->query ? o->query : "", &q, err, sizeof(err)) != 0) {
+        fprintf(stderr, "Bad query: %s\n", err);
+        return 2;
+    }
+
+    int n = loadInput(in, &a);
+    if (n < 0) return 1;
+    int loaded = tableFromRows(&t, a, n) == 0;
+    free(a);
+    if (!loaded) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    double loadMs = nowMs() - t0;
+
+    double q0 = nowMs();
+    int rc = queryRun(&q, &t, &r);
+    double queryMs = nowMs() - q0;
+    tableFree(&t);
+    json = malloc(QUERY_JSON_LEN);
+    if (rc != 0 || !json || queryFormatJson(&q, &r, json, QUERY_JSON_LEN) < 0) {
+        fprintf(stderr, "Out of memory\n");
+        free(json);
+        return 1;
+    }
+
+    printf("{\"command\":\"query\",\"simd\":\"%s\",\"result\":%s,"
+           "\"load_ms\":%.3f,\"query_ms\":%.3f,\"total_ms\":%.3f}\n",
+           scanLevelName(scanLevel()), json, loadMs, queryMs, nowMs() - t0);
+    free(json);
+    return 0;
+}
+
+/* ============ COMMAND: SCENARIOS ============ */
+/* Reads one scenario per line; blank lines and # comments are skipped.
+   Returns the count, or -1 after reporting the first bad line. */
+static int readScenarios(const char *path, Scenario **out) {
+    FILE *fp = fopen(path, "r");
+    Scenario *sc = NULL;
+    int count = 0, capacity = 0, lineNo = 0;
+    char line[512], err[100];
+
+    if (!fp) {
+        fprintf(stderr, "Cannot read scenarios from %s\n", path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        const char *p = line + strspn(line, " \t");
+        lineNo++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            Scenario *grown = realloc(sc, capacity * sizeof(Scenario));
+            if (!grown) {
+                fprintf(stderr, "Out of memory\n");
+                break;
+            }
+            sc = grown;
+        }
+        if (scenarioParse(p, &sc[count], err, sizeof(err)) != 0) {
+            fprintf(stderr, "%s:%d: %s\n", path, lineNo, err);
+            break;
+        }
+        count++;
+    }
+    int failed = !feof(fp);
+    fclose(fp);
+    if (failed) {
+        free(sc);
+        return -1;
+    }
+    *out = sc;
+    return count;
+}
+
+static void printScenario(const char *name, const Scenario *s, const ScenarioResult *r) {
+    int seats = 0;
+    for (int d = 0; d < programCount(); d++)
+        seats += s->seats[d];
+
+    printf("{\"name\":");
+    printJsonString(stdout, name);
+    printf(",\"prefs\":%d,\"seats\":%d,\"admitted\":%d,\"vacant\":%d,"
+           "\"gained\":%d,\"lost\":%d,\"moved\":%d,\"categories\":{",
+           s->prefs, seats, r->admitted, seats - r->admitted, r->gained, r->lost, r->moved);
+    for (int c = 0; c < CAT_COUNT; c++)
+        printf("%s\"%s\":%d", c ? "," : "", categoryCode(c), r->categoryAdmitted[c]);
+    printf("},\"programs\":{");
+    for (int d = 0; d < programCount(); d++) {
+        const ScenarioProgram *p = &r->program[d];
+        printf("%s\"%s\":{\"seats\":%d,\"filled\":%d,\"reserved_filled\":%d,",
+               d ? "," : "", getDeptCode(d), s->seats[d], p->filled, p->reservedFilled);
+        if (p->filled)
+            printf("\"opening_rank\":%d,\"closing_rank\":%d}", p->openRank, p->closeRank);
+        else
+            printf("\"opening_rank\":null,\"closing_rank\":null}");
+    }
+    printf("},\"ms\":%.3f}", r->ms);
+}
+
+static int cmdScenarios(const CliOptions *o) {
+    const char *in = o->in ? o->in : DEFAULT_DATA_FILE;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = o->threads > 0 ? o->threads : (cpus > 0 ? (int) cpus : 1);
+    Scenario *sc, def;
+    ScenarioResult *results, baseline;
+    ApplicantTable t;
+    Applicant *a;
+    double t0 = nowMs();
+
+    if (!o->scenarios) {
+        fprintf(stderr, "scenarios needs --scenarios=FILE\n");
+        return 2;
+    }
+    int count = readScenarios(o->scenarios, &sc);
+    if (count < 0) return 2;
+
+    int n = loadInput(in, &a);
+    if (n < 0) {
+        free(sc);
+        return 1;
+    }
+    int loaded = tableFromRows(&t, a, n) == 0;
+    free(a);
+    results = malloc((count > 0 ? count : 1) * sizeof(ScenarioResult));
+    if (!loaded || !results) {
+        fprintf(stderr, "Out of memory\n");
+        if (loaded) tableFree(&t);
+        free(results);
+        free(sc);
+        return 1;
+    }
+    double loadMs = nowMs() - t0;
+
+    // Every scenario shares this one merit order; sorted on one thread
+    // so ties fall as in a default merit run whatever --threads is
+    double s0 = nowMs();
+    int rc = tableSort(&t, o->sort, 1);
+    double sortMs = nowMs() - s0;
+    double r0 = nowMs();
+    if (rc == 0) rc = scenarioRunAll(&t, sc, count, &baseline, results, threads);
+    double runMs = nowMs() - r0;
+    tableFree(&t);
+    if (rc != 0) {
+        fprintf(stderr, "Out of memory\n");
+        free(results);
+        free(sc);
+        return 1;
+    }
+
+    scenarioDefault(&def, "baseline");
+    printf("{\"command\":\"scenarios\",\"rows\":%d,\"scenarios\":%d,\"threads\":%d,\"baseline\":",
+           n, count, threads);
+    printScenario(def.name, &def, &baseline);
+    printf(",\"results\":[");
+    for (int i = 0; i < count; i++) {
+        if (i) printf(",");
+        printScenario(sc[i].name, &sc[i], &results[i]);
+    }
+    printf("],\"load_ms\":%.3f,\"sort_ms\":%.3f,\"run_ms\":%.3f,\"total_ms\":%.3f}\n",
+           loadMs, sortMs, runMs, nowMs() - t0);
+    free(results);
+    free(sc);
+    return 0;
+}
+
+/* ============ COMMAND: METRICS ============ */
+typedef struct {
+    char route[32];
+    unsigned long long requests, errors;
+    double p50, p99, p999;
+} RouteSummary;
+
+/* Value of label="..." inside a sample line, copied into out */
+static int metricLabel(const char *line, const char *label, char *out, size_t size) {
+    char key[48];
+    snprintf(key, sizeof(key), "%s=\"", label);
+    const char *p = strstr(line, key);
+    if (!p) return -1;
+    p += strlen(key);
+    const char *end = strchr(p, '"');
+    if (!end || (size_t) (end - p) >= size) return -1;
+    memcpy(out, p, (size_t) (end - p));
+    out[end - p] = '\0';
+    return 0;
+}
+
+static RouteSummary *routeSummary(RouteSummary routes[], int *n, const char *route) {
+    for (int i = 0; i < *n; i++)
+        if (strcmp(routes[i].route, route) == 0) return &routes[i];
+    if (*n == MAX_METRIC_ROUTES) return NULL;
+    RouteSummary *r = &routes[(*n)++];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->route, sizeof(r->route), "%s", route);
+    return r;
+}
+
+static int cmdMetrics(const CliOptions *o) {
+    const char *in = o->in ? o->in : DEFAULT_METRICS_FILE;
+    RouteSummary routes[MAX_METRIC_ROUTES];
+    int nroutes = 0;
+    char line[512], route[32], label[16];
+
+    FILE *fp = fopen(in, "r");
+    if (!fp) {
+        fprintf(stderr, "Cannot read metrics from %s\n", in);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        const char *value = strrchr(line, ' ');
+        RouteSummary *r;
+        if (line[0] == '#' || !value || metricLabel(line, "route", route, sizeof(route)) < 0)
+            continue;
+        if (!(r = routeSummary(routes, &nroutes, route)))
+            continue;
+
+        if (strncmp(line, "adm_http_requests_total{", 24) == 0) {
+            unsigned long long v = strtoull(value + 1, NULL, 10);
+            r->requests += v;
+            if (metricLabel(line, "code", label, sizeof(label)) == 0 && label[0] == '5')
+                r->errors += v;
+        } else if (strncmp(line, "adm_http_request_duration_quantile_seconds{", 43) == 0 &&
+                   metricLabel(line, "quantile", label, sizeof(label)) == 0) {
+            double ms = atof(value + 1) * 1000.0;
+            if (strcmp(label, "0.5") == 0) r->p50 = ms;
+            else if (strcmp(label, "0.99") == 0) r->p99 = ms;
+            else if (strcmp(label, "0.999") == 0) r->p999 = ms;
+        }
+    }
+    fclose(fp);
+
+    printf("{\"command\":\"metrics\",\"in\":");
+    printJsonString(stdout, in);
+    printf(",\"routes\":{");
+    for (int i = 0; i < nroutes; i++)
+        printf("%s\"%s\":{\"requests\":%llu,\"errors_5xx\":%llu,\"p50_ms\":%.3f,"
+               "\"p99_ms\":%.3f,\"p999_ms\":%.3f}", i ? "," : "", routes[i].route,
+               routes[i].requests, routes[i].errors, routes[i].p50, routes[i].p99, routes[i].p999);
+    printf("}}\n");
+    return 0;
+}
+
+/* ============ DISPATCH ============ */
+int cliMain(int argc, char *argv[]) {
+    CliOptions o;
+    const char *cmd = argv[1];
+
+    if (strcmp(cmd, "--help") == 0 || strcmp(cmd, "-h") == 0 || strcmp(cmd, "help") == 0) {
+        printUsage();
+        return 0;
+    }
+    if (parseOptions(argc, argv, &o) < 0) {
+        printUsage();
+        return 2;
+    }
+
+    if (strcmp(cmd, "merit") == 0) return cmdMerit(&o);
+    if (strcmp(cmd, "import") == 0) return cmdImport(&o);
+    if (strcmp(cmd, "export") == 0) return cmdExport(&o);
+    if (strcmp(cmd, "stats") == 0) return cmdStats(&o);
+    if (strcmp(cmd, "query") == 0) return cmdQuery(&o);
+    if (strcmp(cmd, "scenarios") == 0) return cmdScenarios(&o);
+    if (strcmp(cmd, "metrics") == 0) return cmdMetrics(&o);
+
+    fprintf(stderr, "Unknown command: %s\n", cmd);
+    printUsage();
+    return 2;
+}
@@ -1,59 +1,215 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
 #include "student.h"
+#include "department.h"
 #include "csv_handler.h"
 #include "utils.h"
 
-/* ============ LOAD APPLICANTS FROM CSV ============ */
-int loadApplicants(Applicant a[]) {
-    FILE *fp = fopen("applicants_full.csv", "r");
-    if (!fp) return 0;
+#define APPLICANTS_FILE "applicants_full.csv"
 
-    int i = 0;
+/* ============ SKIP HEADER LINE IF PRESENT ============ */
+/* Returns the number of lines skipped */
+static int skipHeader(FILE *fp) {
     char line[500];
 
-    // Skip header if exists
     if (fgets(line, sizeof(line), fp)) {
         // Check if first line is header
         if (strstr(line, "ID,Name") != NULL || strstr(line, "id,name") != NULL) {
             // It's a header, skip it
+            return 1;
         } else {
             // Not a header, rewind
             rewind(fp);
         }
     }
+    return 0;
+}
 
-    while (fgets(line, sizeof(line), fp) && i < MAX) {
-        // Parse CSV: ID,Name,Password,Category,Pref1,Pref2,Pref3,Pref4,Department,Marks,JEE_Rank,Allocated
-        int fields = sscanf(line,
-            "%d,%49[^,],%19[^,],%4[^,],%4[^,],%4[^,],%4[^,],%4[^,],%4[^,],%d,%d,%d",
-            &a[i].id,
-            a[i].name,
-            a[i].password,
-            a[i].category,
-            a[i].pref[0],
-            a[i].pref[1],
-            a[i].pref[2],
-            a[i].pref[3],
-            a[i].department,
-            &a[i].marks,
-            &a[i].jee_rank,
-            &a[i].allocated
-        );
+/* ============ PARSE ONE CSV RECORD ============ */
+enum {
+    F_ID, F_NAME, F_PASSWORD, F_CATEGORY, F_PREF1, F_DEPARTMENT = F_PREF1 + PREF_COUNT,
+    F_MARKS, F_RANK, F_ALLOCATED, FIELD_COUNT
+};
+
+/* Leading integer of a field (spaces and trailing text ignored);
+   -1 if there is none or it does not fit in an int */
+static int fieldInt(const char *s, size_t len, int *out) {
+    size_t i = 0;
+    long long v = 0;
+    int neg = 0;
+
+    while (i < len && s[i] == ' ') i++;
+    if (i < len && (s[i] == '-' || s[i] == '+')) neg = s[i++] == '-';
+    if (i == len || s[i] < '0' || s[i] > '9') return -1;
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+        v = v * 10 + (s[i] - '0');
+        if (v > (long long) INT_MAX + neg) return -1;
+    }
+    *out = (int) (neg ? -v : v);
+    return 0;
+}
+
+/* Category or department code of a field; -1 if unknown */
+static int fieldCode(const char *s, size_t len, int isCategory) {
+    char code[PROGRAM_CODE_LEN];
+    if (len == 0 || len >= sizeof(code)) return -1;
+    memcpy(code, s, len);
+    code[len] = '\0';
+    return isCategory ? parseCategory(code) : parseDepartment(code);
+}
+
+/* Writes "what 'field'" to err (long fields cut short); returns -1 */
+static int fieldError(char *err, size_t errSize, const char *what, const char *s, size_t len) {
+    snprintf(err, errSize, "%s '%.*s'", what, (int) (len > 20 ? 20 : len), s);
+    return -1;
+}
+
+/* ID,Name,Password,Category,Pref1,Pref2,Pref3,Pref4,Department,Marks,JEE_Rank,Allocated
+   Codes are converted and text interned here. Returns 1, 0 for a
+   blank line, or -1 with the reason in err. Any row that cannot be
+   read fails the load: dropping it would erase it on the next save. */
+static int parseApplicantLine(const char *line, Applicant *a, char *err, size_t errSize) {
+    const char *start[FIELD_COUNT];
+    size_t len[FIELD_COUNT];
+    const char *s = line;
+
+    if (line[strspn(line, " \t\r\n")] == '\0') return 0;
 
-        if (fields == 12) {
-            i++;
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        const char *end = s + strcspn(s, f < FIELD_COUNT - 1 ? "," : ",\r\n");
+        if (f < FIELD_COUNT - 1 && *end != ',') {
+            snprintf(err, errSize, "expected %d fields, found %d", FIELD_COUNT, f + 1);
+            return -1;
         }
+        if (end == s) {
+            snprintf(err, errSize, "empty field %d", f + 1);
+            return -1;
+        }
+        start[f] = s;
+        len[f] = (size_t) (end - s);
+        s = end + 1;
+    }
+    if (len[F_NAME] >= NAME_LEN || len[F_PASSWORD] >= PASSWORD_LEN) {
+        snprintf(err, errSize, "%s too long", len[F_NAME] >= NAME_LEN ? "Name" : "Password");
+        return -1;
+    }
+
+    int allocated, category, dept = DEPT_NONE;
+    if (fieldInt(start[F_ID], len[F_ID], &a->id) < 0)
+        return fieldError(err, errSize, "bad ID", start[F_ID], len[F_ID]);
+    if (fieldInt(start[F_MARKS], len[F_MARKS], &a->marks) < 0)
+        return fieldError(err, errSize, "bad Marks", start[F_MARKS], len[F_MARKS]);
+    if (fieldInt(start[F_RANK], len[F_RANK], &a->jee_rank) < 0)
+        return fieldError(err, errSize, "bad JEE_Rank", start[F_RANK], len[F_RANK]);
+    if (fieldInt(start[F_ALLOCATED], len[F_ALLOCATED], &allocated) < 0)
+        return fieldError(err, errSize, "bad Allocated", start[F_ALLOCATED], len[F_ALLOCATED]);
+    if ((category = fieldCode(start[F_CATEGORY], len[F_CATEGORY], 1)) < 0)
+        return fieldError(err, errSize, "unknown category", start[F_CATEGORY], len[F_CATEGORY]);
+    for (int f = F_PREF1; f <= F_DEPARTMENT; f++) {
+        int d = fieldCode(start[f], len[f], 0);
+        if (d < 0) return fieldError(err, errSize, "unknown program", start[f], len[f]);
+        if (f == F_DEPARTMENT) dept = d;
+        else a->pref[f - F_PREF1] = (uint8_t) d;
     }
 
+    a->category = (uint8_t) category;
+    a->department = (uint8_t) dept;
+    a->allocated = allocated != 0;
+    a->name = arenaInternN(start[F_NAME], len[F_NAME]);
+    a->password = arenaInternN(start[F_PASSWORD], len[F_PASSWORD]);
+    return 1;
+}
+
+/* ============ READ ROWS FROM AN OPEN CSV ============ */
+/* Appends rows to *a, growing it when grow is set and failing past
+   *cap otherwise. Returns the row count, or -1 after reporting why
+   the file could not be loaded whole. */
+static int readApplicants(FILE *fp, const char *path, Applicant **a, int *cap, int grow) {
+    char line[500], err[80];
+    int n = 0, lineNo = skipHeader(fp);
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        if (n == *cap) {
+            Applicant *grown = grow ? realloc(*a, 2 * (size_t) *cap * sizeof(Applicant)) : NULL;
+            if (!grown) {
+                if (grow) fprintf(stderr, "Error: %s: out of memory at line %d\n", path, lineNo);
+                else fprintf(stderr, "Error: %s: more than %d applicants\n", path, *cap);
+                return -1;
+            }
+            *a = grown;
+            *cap *= 2;
+        }
+
+        int rc = parseApplicantLine(line, &(*a)[n], err, sizeof(err));
+        if (rc < 0) {
+            fprintf(stderr, "Error: %s: line %d: %s\n", path, lineNo, err);
+            return -1;
+        }
+        n += rc;
+    }
+    return n;
+}
+
+/* ============ LOAD APPLICANTS FROM CSV ============ */
+/* Returns the number of records, 0 if there is no file, or -1 if
+   it could not be loaded whole (already reported); callers must
+   not save over the file then. */
+int loadApplicants(Applicant a[]) {
+    FILE *fp = fopen(APPLICANTS_FILE, "r");
+    if (!fp) return 0;
+
+    int cap = MAX;
+    int n = readApplicants(fp, APPLICANTS_FILE, &a, &cap, 0);
+
     fclose(fp);
-    return i;
+    if (n < 0) printError("Applicant data not loaded; nothing was changed.");
+    return n;
 }
 
-/* ============ SAVE APPLICANTS TO CSV ============ */
-void saveApplicants(Applicant a[], int n) {
-    FILE *fp = fopen("applicants_full.csv", "w");
-    if (!fp) return;
+/* ============ LOAD APPLICANTS INTO A HEAP ARRAY ============ */
+/* No MAX limit: the array grows as needed. Caller frees *out.
+   Returns the number of records, CSV_UNREADABLE if the file cannot
+   be opened, or CSV_INVALID if it could not be loaded whole
+   (reported on stderr). */
+int loadApplicantsFrom(const char *path, Applicant **out) {
+    FILE *fp = fopen(path, "r");
+    *out = NULL;
+    if (!fp) return CSV_UNREADABLE;
+
+    int cap = MAX;
+    Applicant *a = malloc(cap * sizeof(Applicant));
+
+    if (!a) {
+        fclose(fp);
+        return CSV_UNREADABLE;
+    }
+
+    int n = readApplicants(fp, path, &a, &cap, 1);
+
+    fclose(fp);
+    if (n < 0) {
+        free(a);
+        return CSV_INVALID;
+    }
+    *out = a;
+    return n;
+}
+
+/* ============ WRITE APPLICANTS FILE ============ */
+/* Writes to "<path>.tmp" and renames it over path, so readers never
+   see a half-written file. With durable set, the data and the rename
+   are fsync'ed before returning. */
+static int writeApplicantsFile(const char *path, Applicant a[], int n, int durable) {
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *fp = fopen(tmp, "w");
+    if (!fp) return -1;
 
     // Write header
     fprintf(fp, "ID,Name,Password,Category,Pref1,Pref2,Pref3,Pref4,Department,Marks,JEE_Rank,Allocated\n");
@@ -63,21 +219,60 @@ void saveApplicants(Applicant a[], int n) {
         fprintf(fp,
             "%d,%s,%s,%s,%s,%s,%s,%s,%s,%d,%d,%d\n",
             a[i].id,
-            a[i].name,
-            a[i].password,
-            a[i].category,
-            a[i].pref[0],
-            a[i].pref[1],
-            a[i].pref[2],
-            a[i].pref[3],
-            a[i].department,
+            applicantName(&a[i]),
+            applicantPassword(&a[i]),
+            categoryCode(a[i].category),
+            getDeptCode(a[i].pref[0]),
+            getDeptCode(a[i].pref[1]),
+            getDeptCode(a[i].pref[2]),
+            getDeptCode(a[i].pref[3]),
+            getDeptCode(a[i].department),
             a[i].marks,
             a[i].jee_rank,
             a[i].allocated
         );
     }
 
-    fclose(fp);
+    if (fflush(fp) != 0 || ferror(fp) || (durable && fsync(fileno(fp)) != 0)) {
+        fclose(fp);
+        unlink(tmp);
+        return -1;
+    }
+    if (fclose(fp) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+
+    if (durable) {
+        // Make the rename itself durable
+        char dir[512];
+        snprintf(dir, sizeof(dir), "%s", path);
+        char *slash = strrchr(dir, '/');
+        if (slash) *slash = '\0';
+        else strcpy(dir, ".");
+
+        int dfd = open(dir, O_RDONLY);
+        if (dfd < 0) return -1;
+        int rc = fsync(dfd);
+        close(dfd);
+        if (rc != 0) return -1;
+    }
+    return 0;
+}
+
+/* ============ SAVE APPLICANTS TO A GIVEN FILE ============ */
+int saveApplicantsTo(const char *path, Applicant a[], int n) {
+    return writeApplicantsFile(path, a, n, 0);
+}
+
+/* ============ SAVE AND FSYNC (COMMITTED BATCHES) ============ */
+int saveApplicantsDurable(const char *path, Applicant a[], int n) {
+    return writeApplicantsFile(path, a, n, 1);
+}
+
+/* ============ SAVE APPLICANTS TO CSV ============ */
+void saveApplicants(Applicant a[], int n) {
+    saveApplicantsTo(APPLICANTS_FILE, a, n);
 }
 
 /* ============ LOAD ADMIN CREDENTIALS ============ */
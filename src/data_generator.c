@@ -1,8 +1,9 @@
 #include "data_generator.h"
+#include "department.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
+#include <math.h>
 
 static const char *FIRST_NAMES[] = {
     "Amit", "Anirban", "Rohit", "Sourav", "Arjun", "Rahul",
@@ -19,80 +20,333 @@ static const char *LAST_NAMES[] = {
     "Patel", "Mehta", "Joshi", "Iyer", "Reddy"
 };
 
-
-static const char *CATEGORIES[] = { "GEN", "OBC", "SC", "ST" };
-static const char *DEPARTMENTS[] = { "CSE", "IT", "TT", "APM" };
-
 #define FN_COUNT (sizeof(FIRST_NAMES) / sizeof(FIRST_NAMES[0]))
 #define LN_COUNT (sizeof(LAST_NAMES) / sizeof(LAST_NAMES[0]))
 
-static void random_password(char *out, int len) {
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15ULL
+
+/* SplitMix64 finalizer: a strong 64-bit mixing function */
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void gen_rng_init(GenRng *r, uint64_t seed, uint64_t stream) {
+    r->key = mix64(seed ^ mix64(stream + GOLDEN_GAMMA));
+    r->counter = 0;
+}
+
+uint64_t gen_rng_next(GenRng *r) {
+    return mix64(r->key + (++r->counter) * GOLDEN_GAMMA);
+}
+
+/* Uniform value in [0, n) (multiply-shift, negligible bias for small n) */
+uint32_t gen_rng_below(GenRng *r, uint32_t n) {
+    return (uint32_t) (((gen_rng_next(r) >> 32) * (uint64_t) n) >> 32);
+}
+
+/* 4-round Feistel network: a keyed bijection on [0, 2^(2*halfBits)) */
+static uint64_t feistel(uint64_t x, int halfBits, uint64_t seed) {
+    uint64_t mask = (1ULL << halfBits) - 1;
+    uint64_t l = x >> halfBits, r = x & mask;
+
+    for (uint64_t round = 0; round < 4; round++) {
+        uint64_t f = mix64(r ^ seed ^ (round * GOLDEN_GAMMA)) & mask;
+        uint64_t t = l ^ f;
+        l = r;
+        r = t;
+    }
+    return (l << halfBits) | r;
+}
+
+/* Position of row `index` in a seeded permutation of [0, total).
+   Cycle-walking keeps the Feistel output inside the range, so every
+   row gets a distinct value. */
+uint64_t gen_unique_id_index(uint64_t index, uint64_t total, uint64_t seed) {
+    int halfBits = 1;
+    while ((1ULL << (2 * halfBits)) < total)
+        halfBits++;
+
+    uint64_t x = index;
+    do {
+        x = feistel(x, halfBits, seed);
+    } while (x >= total);
+    return x;
+}
+
+static void random_password(char *out, int len, GenRng *rng) {
     const char chars[] =
         "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
         "abcdefghijklmnopqrstuvwxyz"
         "0123456789";
 
     for (int i = 0; i < len - 1; i++)
-        out[i] = chars[rand() % (sizeof(chars) - 1)];
+        out[i] = chars[gen_rng_below(rng, sizeof(chars) - 1)];
 
     out[len - 1] = '\0';
 }
 
-static void shuffle(char arr[][4], int n) {
-    for (int i = n - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
-        char tmp[4];
-        strcpy(tmp, arr[i]);
-        strcpy(arr[i], arr[j]);
-        strcpy(arr[j], tmp);
+/* Shuffles from the end, stopping once arr[n-k..n) is settled: those
+   places then hold a uniform ordered sample of k values (k = n for a
+   full shuffle) */
+static void shuffle_tail(uint8_t arr[], int n, int k, GenRng *rng) {
+    for (int i = n - 1; i > 0 && i >= n - k; i--) {
+        int j = gen_rng_below(rng, i + 1);
+        uint8_t tmp = arr[i];
+        arr[i] = arr[j];
+        arr[j] = tmp;
     }
 }
 
-void generate_applicant(Applicant *a) {
-    a->id = 1000 + rand() % 90000;
+/* ============ WORKLOAD PROFILES ============ */
+static const GenProfile PROFILES[] = {
+    /* name               range  ties corr  levels skew min  sorted */
+    { "uniform",          50000, 0,   0.0,  0,     0.0, 4,   0 },
+    /* Marks follow rank, the first department is most wanted, many short lists */
+    { "realistic-skew",   50000, 0,   0.85, 0,     1.5, 1,   0 },
+    /* Few distinct ranks and marks, everyone wants the same branch */
+    { "adversarial-ties", 50000, 16,  1.0,  5,     4.0, 4,   0 },
+    /* Rows already in merit order */
+    { "presorted",        50000, 0,   1.0,  0,     0.0, 4,   1 },
+};
+
+#define PROFILE_COUNT (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+int gen_profile_lookup(const char *name, GenProfile *out) {
+    for (size_t i = 0; i < PROFILE_COUNT; i++) {
+        if (strcmp(PROFILES[i].name, name) == 0) {
+            *out = PROFILES[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *gen_profile_names(void) {
+    return "uniform|realistic-skew|adversarial-ties|presorted";
+}
+
+/* Override one parameter by its option name; -1 if unknown or out of range */
+int gen_profile_set(GenProfile *p, const char *key, const char *value) {
+    char *end;
+
+    if (strcmp(key, "correlation") == 0 || strcmp(key, "skew") == 0) {
+        double d = strtod(value, &end);
+        if (end == value || *end != '\0' || d < 0) return -1;
+        if (key[0] == 'c') {
+            if (d > 1) return -1;
+            p->correlation = d;
+        } else {
+            p->skew = d;
+        }
+        return 0;
+    }
+
+    long v = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || v < 0 || v > 0x7FFFFFFF) return -1;
+
+    if (strcmp(key, "rank-range") == 0 && v >= 1)
+        p->rank_range = (int) v;
+    else if (strcmp(key, "ties") == 0)
+        p->tie_buckets = (int) v;
+    else if (strcmp(key, "mark-levels") == 0 && (v == 0 || (v >= 2 && v <= 101)))
+        p->mark_levels = (int) v;    // marks span 0..100: at most 101 values
+    else if (strcmp(key, "min-prefs") == 0 && v >= 1 && v <= PREF_COUNT)
+        p->min_prefs = (int) v;
+    else if (strcmp(key, "presorted") == 0 && v <= 1)
+        p->presorted = (int) v;
+    else
+        return -1;
+    return 0;
+}
+
+static double rng_unit(GenRng *rng) {
+    return (gen_rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int draw_rank(GenRng *rng, const GenProfile *p,
+                     uint64_t row, uint64_t total) {
+    int rank;
+
+    if (p->presorted)
+        rank = 1 + (int) (row * (uint64_t) p->rank_range / (total ? total : 1));
+    else
+        rank = 1 + gen_rng_below(rng, p->rank_range);
+
+    if (p->tie_buckets > 0 && p->tie_buckets < p->rank_range) {
+        int width = p->rank_range / p->tie_buckets;
+        rank = 1 + ((rank - 1) / width) * width;
+    }
+    return rank;
+}
+
+/* Marks blend a rank-derived score with uniform noise */
+static int draw_marks(GenRng *rng, const GenProfile *p, int rank) {
+    double fromRank = 100.0 * (p->rank_range - rank) /
+                      (p->rank_range > 1 ? p->rank_range - 1 : 1);
+    double noise = rng_unit(rng) * 101.0;
+    int marks = (int) (p->correlation * (fromRank + 0.5) +
+                       (1.0 - p->correlation) * noise);
+
+    if (p->mark_levels > 1) {
+        int step = 100 / (p->mark_levels - 1);
+        marks = ((marks + step / 2) / step) * step;
+    }
+    return marks < 0 ? 0 : (marks > 100 ? 100 : marks);
+}
+
+/* Department weights 1/(i+1)^skew and their sum, kept per thread
+   for the skew last asked for */
+static _Thread_local double cached_skew = -1.0;
+static _Thread_local int cached_programs;
+static _Thread_local double cached_weight[MAX_PROGRAMS], cached_sum;
+
+static const double *dept_weights(double skew, int programs, double *sum) {
+    if (skew != cached_skew || programs != cached_programs) {
+        cached_sum = 0;
+        for (int i = 0; i < programs; i++) {
+            cached_weight[i] = 1.0 / pow(i + 1, skew);
+            cached_sum += cached_weight[i];
+        }
+        cached_skew = skew;
+        cached_programs = programs;
+    }
+    *sum = cached_sum;
+    return cached_weight;
+}
+
+/* Fill a->pref by weighted sampling without replacement: department i
+   has weight 1/(i+1)^skew, so skew > 0 makes the first department in
+   the registry the popular choice. Lists shorter than PREF_COUNT (or
+   than the number of departments) are padded with DEPT_NONE ("NA"). */
+static void draw_prefs(Applicant *a, GenRng *rng, const GenProfile *p) {
+    int len = p->min_prefs + gen_rng_below(rng, PREF_COUNT - p->min_prefs + 1);
+    int programs = programCount();
+
+    if (len > programs) len = programs;
+    if (p->skew == 0.0) {
+        /* With PREF_COUNT departments this is a full shuffle */
+        uint8_t order[MAX_PROGRAMS];
+        int first = programs > PREF_COUNT ? programs - PREF_COUNT : 0;
+        for (int i = 0; i < programs; i++)
+            order[i] = (uint8_t) i;
+        shuffle_tail(order, programs, programs - first, rng);
+        for (int k = 0; k < PREF_COUNT; k++)
+            a->pref[k] = first + k < programs ? order[first + k] : DEPT_NONE;
+    } else {
+        double sum;
+        const double *weight = dept_weights(p->skew, programs, &sum);
+        uint8_t taken[MAX_PROGRAMS] = {0};
+
+        for (int k = 0; k < len; k++) {
+            double r = rng_unit(rng) * sum;
+            int pick = -1;
+            for (int i = 0; i < programs; i++) {
+                if (taken[i]) continue;
+                pick = i;
+                if (r < weight[i]) break;
+                r -= weight[i];
+            }
+            taken[pick] = 1;
+            sum -= weight[pick];
+            a->pref[k] = (uint8_t) pick;
+        }
+    }
+
+    for (int k = len; k < PREF_COUNT; k++)
+        a->pref[k] = DEPT_NONE;
+}
+
+/* The caller assigns r->a.id (see gen_unique_id_index) */
+void generate_applicant(GenRow *r, GenRng *rng, const GenProfile *p,
+                        uint64_t row, uint64_t total) {
+    Applicant *a = &r->a;
+
+    /* Zeroed so binary output is the same byte for byte, padding included */
+    memset(a, 0, sizeof(*a));
 
     /* Name generation */
-    const char *first = FIRST_NAMES[rand() % FN_COUNT];
-    const char *last  = LAST_NAMES[rand() % LN_COUNT];
+    const char *first = FIRST_NAMES[gen_rng_below(rng, FN_COUNT)];
+    const char *last  = LAST_NAMES[gen_rng_below(rng, LN_COUNT)];
 
-    snprintf(a->name, MAX_NAME_LEN, "%s %s", first, last);
+    snprintf(r->name, NAME_LEN, "%s %s", first, last);
 
     /* Password */
-    random_password(a->password, 10);
+    random_password(r->password, 10, rng);
 
     /* Category */
-    strcpy(a->category, CATEGORIES[rand() % 4]);
+    a->category = (uint8_t) gen_rng_below(rng, CAT_COUNT);
 
     /* Preferences (non-repeating) */
-    for (int i = 0; i < PREF_COUNT; i++)
-        strcpy(a->pref[i], DEPARTMENTS[i]);
-
-    shuffle(a->pref, PREF_COUNT);
+    draw_prefs(a, rng, p);
 
     /* Department - not allocated until merit list is generated */
-    strcpy(a->department, "N/A");
+    a->department = DEPT_NONE;
 
     /* Marks, rank, allocated */
-    a->marks = rand() % 101;
-    a->jee_rank = 1 + rand() % 50000;
+    a->jee_rank = draw_rank(rng, p, row, total);
+    a->marks = draw_marks(rng, p, a->jee_rank);
     a->allocated = 0;
 }
 
-void write_applicant_csv(FILE *fp, const Applicant *a) {
-    fprintf(fp,
-        "%d,%s,%s,%s,%s,%s,%s,%s,%s,%d,%d,%d\n",
-        a->id,
-        a->name,
-        a->password,
-        a->category,
-        a->pref[0],
-        a->pref[1],
-        a->pref[2],
-        a->pref[3],
-        a->department,
-        a->marks,
-        a->jee_rank,
-        a->allocated
-    );
+/* Row `row` of a `total`-row dataset: its own RNG stream plus a
+   unique ID, so any row can be produced independently of the rest */
+void generate_row(GenRow *r, const GenProfile *p, uint64_t seed,
+                  uint64_t row, uint64_t total) {
+    GenRng rng;
+
+    gen_rng_init(&rng, seed, row);
+    generate_applicant(r, &rng, p, row, total);
+    r->a.id = 1000 + (int) gen_unique_id_index(row, total, seed);
+}
+
+/* Append a decimal integer; returns the number of characters */
+static int put_int(char *out, int v) {
+    char tmp[12];
+    int n = 0, len = 0;
+    unsigned int u = v < 0 ? 0u - (unsigned int) v : (unsigned int) v;
+
+    if (v < 0) out[len++] = '-';
+    do {
+        tmp[n++] = (char) ('0' + u % 10);
+        u /= 10;
+    } while (u);
+    while (n) out[len++] = tmp[--n];
+    return len;
+}
+
+static int put_str(char *out, const char *s) {
+    int len = 0;
+    while (s[len]) {
+        out[len] = s[len];
+        len++;
+    }
+    return len;
+}
+
+/* Format one CSV line into buf (at least MAX_CSV_LINE bytes) without
+   stdio; returns its length. Same layout as write_applicant_csv. */
+int format_applicant_csv(char *buf, const GenRow *r) {
+    const Applicant *a = &r->a;
+    char *p = buf;
+
+    p += put_int(p, a->id);        *p++ = ',';
+    p += put_str(p, r->name);      *p++ = ',';
+    p += put_str(p, r->password);  *p++ = ',';
+    p += put_str(p, categoryCode(a->category)); *p++ = ',';
+    for (int i = 0; i < PREF_COUNT; i++) {
+        p += put_str(p, getDeptCode(a->pref[i]));
+        *p++ = ',';
+    }
+    p += put_str(p, getDeptCode(a->department)); *p++ = ',';
+    p += put_int(p, a->marks);      *p++ = ',';
+    p += put_int(p, a->jee_rank);   *p++ = ',';
+    p += put_int(p, a->allocated);  *p++ = '\n';
+    return (int) (p - buf);
 }
 
+void write_applicant_csv(FILE *fp, const GenRow *r) {
+    char line[MAX_CSV_LINE];
+    fwrite(line, 1, format_applicant_csv(line, r), fp);
+}
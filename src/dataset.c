@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "student.h"
+#include "csv_handler.h"
+#include "dataset.h"
+
+#define MAX_READER_SLOTS 64
+
+/* One slot per reader thread. epoch is 0 while the thread holds no
+   snapshot, otherwise the global epoch it observed on entry.
+   Padded to a cache line so readers never share a line. */
+typedef struct {
+    _Atomic unsigned long epoch;
+    _Atomic int used;
+    char pad[64 - sizeof(unsigned long) - sizeof(int)];
+} ReaderSlot;
+
+static ReaderSlot slots[MAX_READER_SLOTS];
+static _Atomic unsigned long global_epoch = 1;
+static _Atomic(DatasetVersion *) current = NULL;
+
+/* Writers (and reclamation) are serialized by this lock; readers never take it */
+static pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static DatasetVersion *retired = NULL;
+static _Atomic int retired_count = 0;  // versions awaiting reclamation
+
+static char data_path[256];
+static struct stat data_stat;   // file as last loaded or written by us
+
+static _Thread_local int my_slot = -1;
+static _Thread_local int my_depth = 0;
+
+/* ============ VERSION HELPERS ============ */
+static DatasetVersion *newVersion(int capacity) {
+    DatasetVersion *v = calloc(1, sizeof(DatasetVersion));
+    if (!v) return NULL;
+
+    v->capacity = capacity > 0 ? capacity : 1;
+    v->rows = malloc(v->capacity * sizeof(Applicant));
+    if (!v->rows) {
+        free(v);
+        return NULL;
+    }
+    return v;
+}
+
+static void freeVersion(DatasetVersion *v) {
+    if (!v) return;
+    free(v->rows);
+    free(v->id_slots);
+    free(v);
+}
+
+static unsigned int idHash(long id) {
+    return (unsigned int) (((unsigned long long) id * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/* ============ ID INDEX ============ */
+/* Open addressing at <= 50% load; with duplicate IDs the first row
+   wins, as with a front-to-back scan. Without memory the index is
+   left out and lookups fall back to scanning. */
+static void buildIdIndex(DatasetVersion *v) {
+    unsigned int size = 16;
+    while (size < 2u * (unsigned int) v->count) size *= 2;
+
+    free(v->id_slots);
+    v->id_slots = calloc(size, sizeof(int));
+    if (!v->id_slots) return;
+    v->id_mask = size - 1;
+
+    for (int i = 0; i < v->count; i++) {
+        unsigned int h = idHash(v->rows[i].id) & v->id_mask;
+        while (v->id_slots[h] && v->rows[v->id_slots[h] - 1].id != v->rows[i].id)
+            h = (h + 1) & v->id_mask;
+        if (!v->id_slots[h]) v->id_slots[h] = i + 1;
+    }
+}
+
+static void rememberFileState(void) {
+    if (stat(data_path, &data_stat) != 0)
+        memset(&data_stat, 0, sizeof(data_stat));
+}
+
+/* ============ CLAIM A READER SLOT FOR THIS THREAD ============ */
+static int claimSlot(void) {
+    for (int i = 0; i < MAX_READER_SLOTS; i++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&slots[i].used, &expected, 1))
+            return i;
+    }
+    return -1;
+}
+
+/* ============ RECLAIM RETIRED VERSIONS (writer_lock held) ============ */
+static void reclaimLocked(void) {
+    unsigned long oldest = 0;   // smallest epoch any active reader entered with
+
+    for (int i = 0; i < MAX_READER_SLOTS; i++) {
+        if (!atomic_load(&slots[i].used)) continue;
+        unsigned long e = atomic_load(&slots[i].epoch);
+        if (e != 0 && (oldest == 0 || e < oldest))
+            oldest = e;
+    }
+
+    DatasetVersion **link = &retired;
+    while (*link) {
+        DatasetVersion *v = *link;
+        // Readers that entered before v was retired may still hold it
+        if (oldest == 0 || oldest >= v->retire_epoch) {
+            *link = v->next_retired;
+            freeVersion(v);
+            atomic_fetch_sub(&retired_count, 1);
+        } else {
+            link = &v->next_retired;
+        }
+    }
+}
+
+/* ============ SWAP IN A NEW VERSION (writer_lock held) ============ */
+static void publishLocked(DatasetVersion *v) {
+    buildIdIndex(v);
+    statsSettle(&v->stats, v->rows, v->count);
+    DatasetVersion *old = atomic_exchange(&current, v);
+
+    if (old) {
+        // Readers entering from now on see an epoch >= retire_epoch
+        old->retire_epoch = atomic_fetch_add(&global_epoch, 1) + 1;
+        old->next_retired = retired;
+        retired = old;
+        atomic_fetch_add(&retired_count, 1);
+    }
+    reclaimLocked();
+}
+
+/* ============ LOAD THE DATASET FROM CSV ============ */
+int datasetInit(const char *path) {
+    Applicant *rows;
+    int n;
+
+    snprintf(data_path, sizeof(data_path), "%s", path);
+    n = loadApplicantsFrom(data_path, &rows);
+    if (n == CSV_INVALID) return -1;   // never publish, and save, part of a file
+    if (n < 0) {
+        // Missing file: start with an empty dataset
+        n = 0;
+        rows = NULL;
+    }
+
+    DatasetVersion *v = newVersion(n);
+    if (!v) {
+        free(rows);
+        return -1;
+    }
+    if (n > 0) memcpy(v->rows, rows, n * sizeof(Applicant));
+    v->count = n;
+    v->version = 1;
+    statsRebuild(&v->stats, v->rows, n);
+    free(rows);
+
+    pthread_mutex_lock(&writer_lock);
+    rememberFileState();
+    publishLocked(v);
+    pthread_mutex_unlock(&writer_lock);
+    return n;
+}
+
+/* ============ FREE EVERYTHING (no readers may be active) ============ */
+void datasetShutdown(void) {
+    pthread_mutex_lock(&writer_lock);
+    freeVersion(atomic_exchange(&current, NULL));
+    while (retired) {
+        DatasetVersion *next = retired->next_retired;
+        freeVersion(retired);
+        retired = next;
+    }
+    atomic_store(&retired_count, 0);
+    pthread_mutex_unlock(&writer_lock);
+}
+
+/* Versions replaced but still waiting for readers to leave */
+int datasetRetiredCount(void) {
+    return atomic_load(&retired_count);
+}
+
+/* ============ READER: TAKE A SNAPSHOT ============ */
+/* Lock-free: announce the epoch we entered with, then read the
+   current pointer. The version stays valid until datasetRelease(). */
+const DatasetVersion *datasetAcquire(void) {
+    if (my_slot < 0) {
+        my_slot = claimSlot();
+        if (my_slot < 0) {
+            fprintf(stderr, "dataset: out of reader slots\n");
+            abort();
+        }
+    }
+
+    if (my_depth++ == 0)
+        atomic_store(&slots[my_slot].epoch, atomic_load(&global_epoch));
+
+    return atomic_load(&current);
+}
+
+/* ============ READER: DROP THE SNAPSHOT ============ */
+void datasetRelease(const DatasetVersion *v) {
+    (void) v;
+    if (--my_depth == 0)
+        atomic_store(&slots[my_slot].epoch, 0);
+}
+
+/* ============ VERSION NUMBER OF THE CURRENT SNAPSHOT ============ */
+unsigned long datasetCurrentVersion(void) {
+    const DatasetVersion *v = datasetAcquire();
+    unsigned long version = v ? v->version : 0;
+    datasetRelease(v);
+    return version;
+}
+
+/* ============ LOOK UP ONE APPLICANT IN A SNAPSHOT ============ */
+/* O(1) on published versions; scans copies that were never published */
+const Applicant *datasetFindById(const DatasetVersion *v, long id) {
+    if (!v->id_slots) {
+        for (int i = 0; i < v->count; i++)
+            if (v->rows[i].id == id) return &v->rows[i];
+        return NULL;
+    }
+
+    for (unsigned int h = idHash(id) & v->id_mask; v->id_slots[h]; h = (h + 1) & v->id_mask)
+        if (v->rows[v->id_slots[h] - 1].id == id)
+            return &v->rows[v->id_slots[h] - 1];
+    return NULL;
+}
+
+/* ============ WRITER: COPY THE CURRENT VERSION ============ */
+/* Takes the writer lock; the copy has room for `extra` more rows.
+   Must be followed by datasetPublish() or datasetAbortWrite(). */
+DatasetVersion *datasetBeginWrite(int extra) {
+    pthread_mutex_lock(&writer_lock);
+
+    DatasetVersion *cur = atomic_load(&current);
+    int n = cur ? cur->count : 0;
+    DatasetVersion *v = newVersion(n + extra);
+    if (!v) {
+        pthread_mutex_unlock(&writer_lock);
+        return NULL;
+    }
+
+    if (n > 0) memcpy(v->rows, cur->rows, n * sizeof(Applicant));
+    v->count = n;
+    v->version = (cur ? cur->version : 0) + 1;
+    if (cur) v->stats = cur->stats;
+    else statsRebuild(&v->stats, NULL, 0);
+    return v;
+}
+
+/* ============ WRITER: PUBLISH AND PERSIST ============ */
+void datasetPublish(DatasetVersion *v) {
+    publishLocked(v);
+    saveApplicantsTo(data_path, v->rows, v->count);
+    rememberFileState();
+    pthread_mutex_unlock(&writer_lock);
+}
+
+/* ============ WRITER: COMMIT DURABLY, THEN PUBLISH ============ */
+/* The version becomes visible only after it is fsync'ed to disk.
+   On failure it is discarded and -1 is returned. */
+int datasetPublishDurable(DatasetVersion *v) {
+    if (saveApplicantsDurable(data_path, v->rows, v->count) != 0) {
+        datasetAbortWrite(v);
+        return -1;
+    }
+    rememberFileState();
+    publishLocked(v);
+    pthread_mutex_unlock(&writer_lock);
+    return 0;
+}
+
+/* ============ WRITER: DISCARD AN UNPUBLISHED COPY ============ */
+void datasetAbortWrite(DatasetVersion *v) {
+    freeVersion(v);
+    pthread_mutex_unlock(&writer_lock);
+}
+
+/* ============ PICK UP EXTERNAL EDITS TO THE CSV ============ */
+/* Reloads when the file was changed by another program (e.g. the
+   terminal application). Returns 1 if a new version was published. */
+int datasetRefreshIfChanged(void) {
+    struct stat st;
+
+    if (stat(data_path, &st) != 0) return 0;
+    if (pthread_mutex_trylock(&writer_lock) != 0) return 0;
+
+    if (st.st_size == data_stat.st_size &&
+        st.st_mtim.tv_sec == data_stat.st_mtim.tv_sec &&
+        st.st_mtim.tv_nsec == data_stat.st_mtim.tv_nsec) {
+        pthread_mutex_unlock(&writer_lock);
+        return 0;
+    }
+
+    Applicant *rows;
+    int n = loadApplicantsFrom(data_path, &rows);
+    DatasetVersion *cur = atomic_load(&current);
+    if (n == CSV_INVALID) data_stat = st;   // reported once; keep serving the last good version
+    DatasetVersion *v = n >= 0 ? calloc(1, sizeof(DatasetVersion)) : NULL;
+
+    if (!v) {
+        free(rows);
+        pthread_mutex_unlock(&writer_lock);
+        return 0;
+    }
+
+    v->rows = rows;
+    v->count = n;
+    v->capacity = n;
+    v->version = (cur ? cur->version : 0) + 1;
+    statsRebuild(&v->stats, rows, n);   // edited elsewhere: anything may differ
+    data_stat = st;
+    publishLocked(v);
+    pthread_mutex_unlock(&writer_lock);
+    return 1;
+}
+
+/* ============ FREE VERSIONS NO READER CAN STILL SEE ============ */
+void datasetReclaim(void) {
+    if (pthread_mutex_trylock(&writer_lock) != 0) return;
+    reclaimLocked();
+    pthread_mutex_unlock(&writer_lock);
+}
+
+/* ============ RELEASE THIS THREAD'S READER SLOT ============ */
+void datasetThreadExit(void) {
+    if (my_slot >= 0) {
+        atomic_store(&slots[my_slot].epoch, 0);
+        atomic_store(&slots[my_slot].used, 0);
+        my_slot = -1;
+        my_depth = 0;
+    }
+}
@@ -1,43 +1,270 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <pthread.h>
 #include "student.h"
 #include "department.h"
 
-char departments[4][5] = {"CSE", "IT", "TT", "APM"};
-char departmentNames[4][50] = {
-    "Computer Science and Engineering",
-    "Information Technology",
-    "Textile Technology",
-    "Advanced Production Management"
+#define PROGRAM_SLOTS 512      // power of two, at least 2 * MAX_PROGRAMS
+
+typedef struct {
+    char code[PROGRAM_CODE_LEN];
+    char name[PROGRAM_NAME_LEN];
+    int seats;
+} Program;
+
+typedef struct {
+    Program programs[MAX_PROGRAMS];
+    int count;
+    uint8_t slots[PROGRAM_SLOTS];      // program id + 1, 0 = empty
+} Registry;
+
+static const Program builtin[] = {
+    {"CSE", "Computer Science and Engineering", 10},
+    {"IT", "Information Technology", 10},
+    {"TT", "Textile Technology", 10},
+    {"APM", "Advanced Production Management", 10}
 };
 
+static Registry current, staged;
+static pthread_once_t builtinOnce = PTHREAD_ONCE_INIT;
+
+static uint32_t hashCode(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ (unsigned char) s[i]) * 16777619u;
+    return h;
+}
+
+/* ============ CODE HASH ============ */
+/* Id of the code s[0..len), or -1 */
+static int lookup(const Registry *r, const char *s, size_t len) {
+    if (len >= PROGRAM_CODE_LEN) return -1;
+
+    uint32_t h = hashCode(s, len) & (PROGRAM_SLOTS - 1);
+    while (r->slots[h]) {
+        const Program *p = &r->programs[r->slots[h] - 1];
+        if (memcmp(p->code, s, len) == 0 && p->code[len] == '\0')
+            return r->slots[h] - 1;
+        h = (h + 1) & (PROGRAM_SLOTS - 1);
+    }
+    return -1;
+}
+
+/* Appends a program and hashes its code; -1 if the code is taken */
+static int addProgram(Registry *r, const Program *p) {
+    size_t len = strlen(p->code);
+    if (lookup(r, p->code, len) >= 0) return -1;
+
+    uint32_t h = hashCode(p->code, len) & (PROGRAM_SLOTS - 1);
+    while (r->slots[h]) h = (h + 1) & (PROGRAM_SLOTS - 1);
+    r->programs[r->count] = *p;
+    r->slots[h] = (uint8_t) ++r->count;
+    return 0;
+}
+
+static void useBuiltin(void) {
+    memset(&current, 0, sizeof(current));
+    for (size_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++)
+        addProgram(&current, &builtin[i]);
+}
+
+static const Registry *registry(void) {
+    pthread_once(&builtinOnce, useBuiltin);
+    return &current;
+}
+
+/* ============ LOAD PROGRAMS ============ */
+/* An upper-case letter, then upper-case letters, digits and '_',
+   so a code reads as one word everywhere (menus, queries, scenario
+   files); "NA" means no program */
+static int isValidCode(const char *code) {
+    if (code[0] < 'A' || code[0] > 'Z' || strlen(code) >= PROGRAM_CODE_LEN ||
+        strcmp(code, "NA") == 0)
+        return 0;
+    for (const char *c = code; *c; c++)
+        if (!((*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '_'))
+            return 0;
+    return 1;
+}
+
+/* Code,Seats,Name per line; a Code,... header, blank lines and #
+   comments are skipped. Replaces the registry only when the whole
+   file is valid. Returns 0, or -1 with a message in err. */
+int programsLoad(const char *path, char *err, size_t errSize) {
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    int lineNo = 0;
+
+    registry();
+    if (!fp) {
+        snprintf(err, errSize, "cannot open the file");
+        return -1;
+    }
+    memset(&staged, 0, sizeof(staged));
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        size_t len = strcspn(line, "\r\n");
+        if (line[len] == '\0' && !feof(fp)) {
+            snprintf(err, errSize, "line %d: too long", lineNo);
+            goto fail;
+        }
+        line[len] = '\0';
+        if (line[0] == '\0' || line[0] == '#' ||
+            (lineNo == 1 && (strncmp(line, "Code,", 5) == 0 || strncmp(line, "code,", 5) == 0)))
+            continue;
+
+        char *seats = strchr(line, ',');
+        char *name = seats ? strchr(seats + 1, ',') : NULL;
+        char *end;
+        if (!name) {
+            snprintf(err, errSize, "line %d: expected Code,Seats,Name", lineNo);
+            goto fail;
+        }
+        *seats++ = '\0';
+        *name++ = '\0';
+
+        Program p;
+        long v = strtol(seats, &end, 10);
+        if (!isValidCode(line)) {
+            snprintf(err, errSize, "line %d: bad program code '%s'", lineNo, line);
+            goto fail;
+        }
+        if (seats[0] == '\0' || *end != '\0' || v < 0 || v > MAX_PROGRAM_SEATS) {
+            snprintf(err, errSize, "line %d: bad seat count for %s", lineNo, line);
+            goto fail;
+        }
+        if (name[0] == '\0' || strlen(name) >= PROGRAM_NAME_LEN) {
+            snprintf(err, errSize, "line %d: name of %s must be 1-%d characters",
+                     lineNo, line, PROGRAM_NAME_LEN - 1);
+            goto fail;
+        }
+        if (staged.count == MAX_PROGRAMS) {
+            snprintf(err, errSize, "line %d: more than %d programs", lineNo, MAX_PROGRAMS);
+            goto fail;
+        }
+        strcpy(p.code, line);
+        strcpy(p.name, name);
+        p.seats = (int) v;
+        if (addProgram(&staged, &p) != 0) {
+            snprintf(err, errSize, "line %d: duplicate program %s", lineNo, line);
+            goto fail;
+        }
+    }
+    fclose(fp);
+
+    if (staged.count == 0) {
+        snprintf(err, errSize, "no programs listed");
+        return -1;
+    }
+    current = staged;
+    return 0;
+
+fail:
+    fclose(fp);
+    return -1;
+}
+
+/* ============ LOAD AT STARTUP ============ */
+/* Loads $ADM_PROGRAMS, else PROGRAMS_FILE when it exists; keeps the
+   built-in programs otherwise. Returns -1 after reporting a bad file. */
+int programsInit(void) {
+    const char *path = getenv("ADM_PROGRAMS");
+    char err[160];
+
+    if (!path || !*path) {
+        FILE *fp = fopen(PROGRAMS_FILE, "r");
+        if (!fp) {
+            registry();
+            return 0;
+        }
+        fclose(fp);
+        path = PROGRAMS_FILE;
+    }
+    if (programsLoad(path, err, sizeof(err)) == 0) return 0;
+    fprintf(stderr, "Error: %s: %s\n", path, err);
+    return -1;
+}
+
+int programCount(void) {
+    return registry()->count;
+}
+
+int programSeats(int index) {
+    const Registry *r = registry();
+    return index >= 0 && index < r->count ? r->programs[index].seats : 0;
+}
+
+/* Hash of the codes in id order: equal when ids mean the same programs */
+unsigned int programsFingerprint(void) {
+    const Registry *r = registry();
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < r->count; i++)
+        h = (h ^ hashCode(r->programs[i].code, strlen(r->programs[i].code))) * 16777619u;
+    return h;
+}
+
 /* ============ LIST ALL DEPARTMENTS ============ */
 void listDepartments() {
+    const Registry *r = registry();
     printf("\n========== DEPARTMENTS ==========\n");
-    for (int i = 0; i < 4; i++)
-        printf("%d. %s (%s) - Seats: 10\n", i + 1, departments[i], departmentNames[i]);
+    for (int i = 0; i < r->count; i++)
+        printf("%d. %s (%s) - Seats: %d\n", i + 1, r->programs[i].code,
+               r->programs[i].name, r->programs[i].seats);
     printf("=================================\n");
 }
 
+/* ============ READ DEPARTMENT CHOICE ============ */
+/* Reads one word from stdin: a department's number in
+   listDepartments() or its code, in any case. Returns the
+   department, or -1. */
+int readDepartmentChoice(void) {
+    char word[PROGRAM_CODE_LEN + 8];
+    char *end;
+
+    if (scanf("%19s", word) != 1) return -1;
+    long v = strtol(word, &end, 10);
+    if (*end == '\0')
+        return v >= 1 && v <= programCount() ? (int) v - 1 : -1;
+    for (char *c = word; *c; c++)
+        *c = (char) toupper((unsigned char) *c);
+    return getDeptIndex(word);
+}
+
 /* ============ VALIDATE DEPARTMENT ============ */
 int isValidDepartment(char dept[]) {
-    for (int i = 0; i < 4; i++)
-        if (strcmp(dept, departments[i]) == 0)
-            return 1;
-    return 0;
+    return getDeptIndex(dept) >= 0;
 }
 
 /* ============ GET DEPARTMENT INDEX ============ */
 int getDeptIndex(char dept[]) {
-    for (int i = 0; i < 4; i++)
-        if (strcmp(dept, departments[i]) == 0)
-            return i;
-    return -1;
+    return lookup(registry(), dept, strlen(dept));
+}
+
+/* ============ PARSE DEPARTMENT CODE ============ */
+/* Department for a code, DEPT_NONE for "NA", "N/A" or an empty
+   field, -1 if unknown */
+int parseDepartment(const char *code) {
+    if (code[0] == '\0' || strcmp(code, "NA") == 0 || strcmp(code, "N/A") == 0)
+        return DEPT_NONE;
+    return lookup(registry(), code, strlen(code));
+}
+
+/* ============ GET DEPARTMENT CODE ============ */
+char* getDeptCode(int index) {
+    const Registry *r = registry();
+    if (index >= 0 && index < r->count)
+        return current.programs[index].code;
+    return "NA";
 }
 
 /* ============ GET DEPARTMENT NAME ============ */
 char* getDeptName(int index) {
-    if (index >= 0 && index < 4)
-        return departmentNames[index];
+    const Registry *r = registry();
+    if (index >= 0 && index < r->count)
+        return current.programs[index].name;
     return "Unknown";
 }
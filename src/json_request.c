@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+#include "json_request.h"
+
+#define JSON_MAX_DEPTH 16
+
+typedef struct {
+    const char *p;
+    const char *end;
+} Cursor;
+
+static void skipSpace(Cursor *c) {
+    while (c->p < c->end &&
+           (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r'))
+        c->p++;
+}
+
+static int hexValue(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+/* ============ READ FOUR HEX DIGITS AFTER \u ============ */
+static long readHex4(const char *p, const char *end) {
+    long v = 0;
+
+    if (end - p < 4) return -1;
+    for (int i = 0; i < 4; i++) {
+        int h = hexValue(p[i]);
+        if (h < 0) return -1;
+        v = v * 16 + h;
+    }
+    return v;
+}
+
+/* ============ DECODE ONE ESCAPE SEQUENCE ============ */
+/* *p points just past the backslash. Writes the UTF-8 bytes to out
+   (if not NULL), advances *p and returns the byte count, or -1. */
+static int decodeEscape(const char **p, const char *end, char *out) {
+    char tmp[4];
+    char *o = out ? out : tmp;
+    const char *s = *p;
+
+    if (s >= end) return -1;
+
+    switch (*s) {
+        case '"':  o[0] = '"';  *p = s + 1; return 1;
+        case '\\': o[0] = '\\'; *p = s + 1; return 1;
+        case '/':  o[0] = '/';  *p = s + 1; return 1;
+        case 'b':  o[0] = '\b'; *p = s + 1; return 1;
+        case 'f':  o[0] = '\f'; *p = s + 1; return 1;
+        case 'n':  o[0] = '\n'; *p = s + 1; return 1;
+        case 'r':  o[0] = '\r'; *p = s + 1; return 1;
+        case 't':  o[0] = '\t'; *p = s + 1; return 1;
+        case 'u':  break;
+        default:   return -1;
+    }
+
+    long cp = readHex4(s + 1, end);
+    s += 5;
+    if (cp < 0) return -1;
+
+    // Surrogate pair: \uD8xx\uDCxx
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        if (end - s < 6 || s[0] != '\\' || s[1] != 'u') return -1;
+        long lo = readHex4(s + 2, end);
+        if (lo < 0xDC00 || lo > 0xDFFF) return -1;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+        s += 6;
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        return -1;
+    }
+
+    *p = s;
+    if (cp < 0x80) {
+        o[0] = (char) cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        o[0] = (char) (0xC0 | (cp >> 6));
+        o[1] = (char) (0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        o[0] = (char) (0xE0 | (cp >> 12));
+        o[1] = (char) (0x80 | ((cp >> 6) & 0x3F));
+        o[2] = (char) (0x80 | (cp & 0x3F));
+        return 3;
+    }
+    o[0] = (char) (0xF0 | (cp >> 18));
+    o[1] = (char) (0x80 | ((cp >> 12) & 0x3F));
+    o[2] = (char) (0x80 | ((cp >> 6) & 0x3F));
+    o[3] = (char) (0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/* ============ SCAN A STRING TOKEN ============ */
+/* c->p is at the opening quote. Returns the view between the quotes
+   and, in *decoded, the length after unescaping. */
+static int scanString(Cursor *c, JsonView *out, size_t *decoded) {
+    const char *s = c->p + 1;
+    size_t n = 0;
+
+    if (c->p >= c->end || *c->p != '"') return -1;
+
+    while (s < c->end && *s != '"') {
+        if ((unsigned char) *s < 0x20) return -1;
+        if (*s == '\\') {
+            s++;
+            int k = decodeEscape(&s, c->end, NULL);
+            if (k < 0) return -1;
+            n += k;
+        } else {
+            s++;
+            n++;
+        }
+    }
+    if (s >= c->end) return -1;
+
+    out->ptr = c->p + 1;
+    out->len = s - (c->p + 1);
+    if (decoded) *decoded = n;
+    c->p = s + 1;
+    return 0;
+}
+
+/* ============ SCAN AN INTEGER TOKEN ============ */
+static int scanInt(Cursor *c, long *out) {
+    const char *s = c->p;
+    int neg = 0;
+    long v = 0;
+
+    if (s < c->end && *s == '-') {
+        neg = 1;
+        s++;
+    }
+    if (s >= c->end || *s < '0' || *s > '9') return -1;
+
+    while (s < c->end && *s >= '0' && *s <= '9') {
+        int d = *s - '0';
+        if (v > (LONG_MAX - d) / 10) return -1;
+        v = v * 10 + d;
+        s++;
+    }
+    // Fractions and exponents are not integers
+    if (s < c->end && (*s == '.' || *s == 'e' || *s == 'E')) return -1;
+
+    *out = neg ? -v : v;
+    c->p = s;
+    return 0;
+}
+
+static int scanLiteral(Cursor *c, const char *lit) {
+    size_t n = strlen(lit);
+    if ((size_t) (c->end - c->p) < n || memcmp(c->p, lit, n) != 0) return -1;
+    c->p += n;
+    return 0;
+}
+
+/* ============ SKIP ANY VALUE (UNKNOWN FIELDS) ============ */
+static int skipValue(Cursor *c, int depth) {
+    JsonView v;
+
+    if (depth > JSON_MAX_DEPTH) return -1;
+    skipSpace(c);
+    if (c->p >= c->end) return -1;
+
+    switch (*c->p) {
+        case '"':
+            return scanString(c, &v, NULL);
+        case 't':
+            return scanLiteral(c, "true");
+        case 'f':
+            return scanLiteral(c, "false");
+        case 'n':
+            return scanLiteral(c, "null");
+        case '{':
+        case '[': {
+            char close = *c->p == '{' ? '}' : ']';
+            int isObject = close == '}';
+            c->p++;
+            skipSpace(c);
+            if (c->p < c->end && *c->p == close) {
+                c->p++;
+                return 0;
+            }
+            while (1) {
+                if (isObject) {
+                    skipSpace(c);
+                    if (scanString(c, &v, NULL) < 0) return -1;
+                    skipSpace(c);
+                    if (c->p >= c->end || *c->p != ':') return -1;
+                    c->p++;
+                }
+                if (skipValue(c, depth + 1) < 0) return -1;
+                skipSpace(c);
+                if (c->p >= c->end) return -1;
+                if (*c->p == close) {
+                    c->p++;
+                    return 0;
+                }
+                if (*c->p != ',') return -1;
+                c->p++;
+            }
+        }
+        default: {
+            // Number: sign, digits, fraction, exponent
+            const char *start = c->p;
+            while (c->p < c->end &&
+                   (strchr("+-.eE", *c->p) != NULL || (*c->p >= '0' && *c->p <= '9')))
+                c->p++;
+            return c->p > start ? 0 : -1;
+        }
+    }
+}
+
+/* ============ PARSE A STRING ARRAY ============ */
+static int scanStringArray(Cursor *c, const JsonField *f, JsonValue *v) {
+    size_t decoded;
+
+    if (c->p >= c->end || *c->p != '[') return -1;
+    c->p++;
+    skipSpace(c);
+    if (c->p < c->end && *c->p == ']') {
+        c->p++;
+        return 0;
+    }
+
+    while (1) {
+        skipSpace(c);
+        if (v->count >= f->max_items || v->count >= JSON_MAX_ITEMS) return -1;
+        if (scanString(c, &v->items[v->count], &decoded) < 0) return -1;
+        if (decoded > f->max_len) return -1;
+        v->count++;
+        skipSpace(c);
+        if (c->p >= c->end) return -1;
+        if (*c->p == ']') {
+            c->p++;
+            return 0;
+        }
+        if (*c->p != ',') return -1;
+        c->p++;
+    }
+}
+
+/* ============ PARSE A REQUEST OBJECT AGAINST A SCHEMA ============ */
+/* Returns 0 on success. On failure returns -1 and writes a short
+   reason to err. out[] must have nfields entries. A JSON null is
+   treated as an absent field. */
+int jsonParseRequest(const char *buf, size_t len,
+                     const JsonField *schema, int nfields,
+                     JsonValue *out, char *err, size_t errlen) {
+    Cursor c = { buf, buf + len };
+    JsonView key;
+
+    memset(out, 0, nfields * sizeof(JsonValue));
+
+    skipSpace(&c);
+    if (c.p >= c.end || *c.p != '{') {
+        snprintf(err, errlen, "Body must be a JSON object");
+        return -1;
+    }
+    c.p++;
+    skipSpace(&c);
+
+    if (c.p < c.end && *c.p == '}') {
+        c.p++;
+    } else {
+        while (1) {
+            skipSpace(&c);
+            if (scanString(&c, &key, NULL) < 0) {
+                snprintf(err, errlen, "Malformed JSON key");
+                return -1;
+            }
+            skipSpace(&c);
+            if (c.p >= c.end || *c.p != ':') {
+                snprintf(err, errlen, "Expected ':' after key");
+                return -1;
+            }
+            c.p++;
+            skipSpace(&c);
+
+            int f = -1;
+            for (int i = 0; i < nfields; i++) {
+                if (jsonViewEquals(key, schema[i].name)) {
+                    f = i;
+                    break;
+                }
+            }
+
+            if (f < 0) {
+                if (skipValue(&c, 0) < 0) {
+                    snprintf(err, errlen, "Malformed JSON value");
+                    return -1;
+                }
+            } else if (out[f].present) {
+                snprintf(err, errlen, "Duplicate field '%s'", schema[f].name);
+                return -1;
+            } else if (scanLiteral(&c, "null") == 0) {
+                // null: leave the field absent
+            } else {
+                int rc;
+                size_t decoded = 0;
+
+                switch (schema[f].type) {
+                    case JSON_STRING:
+                        rc = scanString(&c, &out[f].str, &decoded);
+                        if (rc == 0 && decoded > schema[f].max_len) rc = -1;
+                        break;
+                    case JSON_INT:
+                        rc = scanInt(&c, &out[f].num);
+                        break;
+                    default:
+                        rc = scanStringArray(&c, &schema[f], &out[f]);
+                        break;
+                }
+                if (rc < 0) {
+                    snprintf(err, errlen, "Invalid value for '%s'", schema[f].name);
+                    return -1;
+                }
+                out[f].present = 1;
+            }
+
+            skipSpace(&c);
+            if (c.p < c.end && *c.p == ',') {
+                c.p++;
+                continue;
+            }
+            if (c.p < c.end && *c.p == '}') {
+                c.p++;
+                break;
+            }
+            snprintf(err, errlen, "Expected ',' or '}'");
+            return -1;
+        }
+    }
+
+    skipSpace(&c);
+    if (c.p != c.end) {
+        snprintf(err, errlen, "Trailing data after JSON object");
+        return -1;
+    }
+
+    for (int i = 0; i < nfields; i++) {
+        if (schema[i].required && !out[i].present) {
+            snprintf(err, errlen, "Missing field '%s'", schema[i].name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ============ UNESCAPE A STRING VIEW INTO A BUFFER ============ */
+/* Returns the decoded length, or -1 if it does not fit in size-1. */
+int jsonCopyString(char *dst, size_t size, JsonView v) {
+    const char *s = v.ptr, *end = v.ptr + v.len;
+    size_t n = 0;
+    char bytes[4];
+
+    while (s < end) {
+        int k;
+        if (*s == '\\') {
+            s++;
+            k = decodeEscape(&s, end, bytes);
+            if (k < 0) return -1;
+        } else {
+            bytes[0] = *s++;
+            k = 1;
+        }
+        if (n + k >= size) return -1;
+        memcpy(dst + n, bytes, k);
+        n += k;
+    }
+
+    dst[n] = '\0';
+    return (int) n;
+}
+
+/* ============ COMPARE A RAW VIEW WITH A C STRING ============ */
+int jsonViewEquals(JsonView v, const char *s) {
+    size_t n = strlen(s);
+    return v.len == n && memcmp(v.ptr, s, n) == 0;
+}
+
+/* ============ APPEND FORMATTED OUTPUT ============ */
+/* printf-style append at buf + *len. *len always grows by the full
+   formatted length, so *len >= size afterwards means the output was
+   truncated; nothing is written past size. */
+void jsonAppend(char *buf, size_t size, size_t *len, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int w = vsnprintf(buf + (*len < size ? *len : size), *len < size ? size - *len : 0, fmt, ap);
+    va_end(ap);
+    if (w > 0) *len += (size_t) w;
+}
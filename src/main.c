@@ -2,16 +2,25 @@
 #include <stdlib.h>
 #include <string.h>
 #include "student.h"
+#include "department.h"
 #include "auth.h"
 #include "admin_menu.h"
 #include "stud_menu.h"
 #include "csv_handler.h"
 #include "utils.h"
+#include "cli.h"
 
-int main() {
+int main(int argc, char *argv[]) {
     int choice;
     int loopFlag = 1;
 
+    if (programsInit() < 0)
+        return 1;
+
+    // Any arguments select the non-interactive command-line mode
+    if (argc > 1)
+        return cliMain(argc, argv);
+
     printf("===================================================\n");
     printf("      ADMISSION MANAGEMENT SYSTEM\n");
     printf("===================================================\n\n");
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <string.h>
+#include "student.h"
+#include "applicant_table.h"
+#include "department.h"
+#include "merit_engine.h"
+
+/* ============================================================
+   ALLOCATE SEATS
+   Walks the applicants in merit order (already sorted) and gives
+   each one the first preference that still has a free seat, up to
+   each program's seats in the registry. seats[] receives the number
+   of seats filled per department.
+   Returns the number of allocated applicants.
+   ============================================================ */
+int allocateSeats(Applicant a[], int n, int seats[MAX_PROGRAMS],
+                  MeritProgressFn progress, void *ctx) {
+    int allocated = 0, programs = programCount();
+    int step = n / 100 > 0 ? n / 100 : 1;
+    int capacity[MAX_PROGRAMS];
+
+    for (int d = 0; d < programs; d++) {
+        seats[d] = 0;
+        capacity[d] = programSeats(d);
+    }
+
+    for (int i = 0; i < n; i++) {
+        a[i].allocated = 0;
+        a[i].department = DEPT_NONE;
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int p = 0; p < PREF_COUNT; p++) {
+            int d = a[i].pref[p];
+            if (d < programs && seats[d] < capacity[d]) {
+                seats[d]++;
+                a[i].allocated = 1;
+                a[i].department = (uint8_t) d;
+                allocated++;
+                break;
+            }
+        }
+
+        if (progress && (i + 1) % step == 0)
+            progress(ctx, i + 1, n);
+    }
+
+    return allocated;
+}
+
+/* ============================================================
+   ALLOCATE SEATS (COLUMNAR)
+   Same result as allocateSeats() on a table in merit order. Reads
+   only the pref columns, and stops once every department is full
+   since nobody later in the order can get a seat.
+   ============================================================ */
+int allocateTableSeats(ApplicantTable *t, int seats[MAX_PROGRAMS],
+                       MeritProgressFn progress, void *ctx) {
+    int n = t->count;
+    int allocated = 0, full = 0, programs = programCount();
+    int step = n / 100 > 0 ? n / 100 : 1;
+    int capacity[MAX_PROGRAMS];
+
+    for (int d = 0; d < programs; d++) {
+        seats[d] = 0;
+        capacity[d] = programSeats(d);
+        if (capacity[d] == 0) full++;
+    }
+
+    memset(t->allocated, 0, n);
+    memset(t->department, DEPT_NONE, n);
+
+    for (int i = 0; i < n && full < programs; i++) {
+        for (int p = 0; p < PREF_COUNT; p++) {
+            int d = t->pref[p][i];
+            if (d < programs && seats[d] < capacity[d]) {
+                if (++seats[d] == capacity[d]) full++;
+                t->allocated[i] = 1;
+                t->department[i] = (uint8_t) d;
+                allocated++;
+                break;
+            }
+        }
+
+        if (progress && (i + 1) % step == 0)
+            progress(ctx, i + 1, n);
+    }
+    if (progress && n > 0) progress(ctx, n, n);
+
+    return allocated;
+}
+
+/* ============================================================
+   WRITE MERIT LIST CSV
+   Returns 0 on success, -1 if the file cannot be written.
+   ============================================================ */
+int writeMeritList(const char *path, Applicant a[], int n) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+
+    fprintf(fp, "JEE_Rank,ID,Name,Category,Department,Marks,Status\n");
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "%d,%d,%s,%s,%s,%d,%s\n",
+                a[i].jee_rank, a[i].id, applicantName(&a[i]), categoryCode(a[i].category),
+                getDeptCode(a[i].department), a[i].marks,
+                a[i].allocated ? "SELECTED" : "WAITING");
+    }
+
+    fclose(fp);
+    return 0;
+}
@@ -1,18 +1,33 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "student.h"
 #include "csv_handler.h"
 #include "sorting.h"
 #include "meritlist.h"
 #include "department.h"
+#include "merit_engine.h"
+#include "applicant_table.h"
+#include "admission_stats.h"
 #include "utils.h"
+#include "trace.h"
 
 /* ============================================================
    GENERATE MERIT LIST
+   With ADM_TRACE=FILE set, each phase is traced: a summary table is
+   printed after the run and the spans are written to FILE as Chrome
+   trace-event JSON.
    ============================================================ */
 void generateMeritList() {
     Applicant a[MAX];
+    const char *tracePath = getenv("ADM_TRACE");
+    if (tracePath) traceEnable(1);
+    unsigned long traceFrom = traceMark();
+
+    TraceSpan span = traceBegin("merit.load");
     int n = loadApplicants(a);
+    span.n = n;
+    traceEnd(&span);
 
     if (n <= 0) {
         printWarning("No applicants found.");
@@ -25,6 +40,7 @@ void generateMeritList() {
     printf("2. Insertion Sort\n");
     printf("3. Merge Sort\n");
     printf("4. Quick Sort\n");
+    printf("5. Radix Sort\n");
     printf("=============================================\n");
     printf("Enter your choice: ");
     scanf("%d", &sortChoice);
@@ -32,51 +48,50 @@ void generateMeritList() {
 
     printf("\nSorting applicants by JEE Rank (lower is better)...\n");
 
+    sortStatsEnable(1);
+    sortStatsReset();
+    span = traceBegin("merit.sort");
+    span.n = n;
+    int sortRc;
     switch (sortChoice) {
-        case 1: selectionSort(a, n); printf("Using: Selection Sort\n"); break;
-        case 2: insertionSort(a, n); printf("Using: Insertion Sort\n"); break;
-        case 3: mergeSort(a, 0, n - 1); printf("Using: Merge Sort\n"); break;
-        case 4: quickSort(a, 0, n - 1); printf("Using: Quick Sort\n"); break;
+        case 1: sortRc = selectionSort(a, n); printf("Using: Selection Sort\n"); break;
+        case 2: sortRc = insertionSort(a, n); printf("Using: Insertion Sort\n"); break;
+        case 3: sortRc = mergeSort(a, 0, n - 1); printf("Using: Merge Sort\n"); break;
+        case 4: sortRc = quickSort(a, 0, n - 1); printf("Using: Quick Sort\n"); break;
+        case 5: sortRc = radixSort(a, n); printf("Using: Radix Sort\n"); break;
         default:
             printWarning("Invalid choice. Using Merge Sort.");
-            mergeSort(a, 0, n - 1);
+            sortRc = mergeSort(a, 0, n - 1);
     }
-
-    int seat[4] = {0};
-    char deptList[4][5] = {"CSE", "IT", "TT", "APM"};
-    int maxSeat = 10;
-
-    for (int i = 0; i < n; i++) {
-        a[i].allocated = 0;
-        strcpy(a[i].department, "NA");
+    double sortMs = traceEnd(&span);
+    SortStats stats = sortStatsGet();
+    sortStatsEnable(0);
+    if (sortRc != 0) {
+        printError("Out of memory while sorting; no seats were allocated.");
+        return;
     }
+    printf("Sorted %d applicants in %.3f ms: ", n, sortMs);
+    sortStatsPrint(stdout, &stats);
 
-    for (int i = 0; i < n; i++) {
-        for (int p = 0; p < PREF_COUNT && !a[i].allocated; p++) {
-            for (int d = 0; d < 4; d++) {
-                if (strcmp(a[i].pref[p], deptList[d]) == 0 && seat[d] < maxSeat) {
-                    seat[d]++;
-                    a[i].allocated = 1;
-                    strcpy(a[i].department, deptList[d]);
-                    break;
-                }
-            }
-        }
-    }
+    int seat[MAX_PROGRAMS];
+    span = traceBegin("merit.allocate");
+    span.n = allocateSeats(a, n, seat, NULL, NULL);
+    traceEnd(&span);
 
-    FILE *fp = fopen("merit_list.csv", "w");
-    if (fp) {
-        fprintf(fp, "JEE_Rank,ID,Name,Category,Department,Marks,Status\n");
-        for (int i = 0; i < n; i++) {
-            fprintf(fp, "%d,%d,%s,%s,%s,%d,%s\n",
-                    a[i].jee_rank, a[i].id, a[i].name, a[i].category,
-                    a[i].department, a[i].marks,
-                    a[i].allocated ? "SELECTED" : "WAITING");
-        }
-        fclose(fp);
-    }
+    span = traceBegin("merit.write_merit_list");
+    writeMeritList("merit_list.csv", a, n);
+    traceEnd(&span);
 
+    span = traceBegin("merit.save_applicants");
     saveApplicants(a, n);
+    traceEnd(&span);
+
+    if (tracePath) {
+        printf("\n");
+        tracePrintSummary(stdout, traceFrom);
+        if (traceWriteChrome(tracePath, traceFrom) != 0)
+            printWarning("Could not write the trace file.");
+    }
 }
 
 /* ============================================================
@@ -97,9 +112,9 @@ void viewMeritList() {
 
     while (fgets(line, sizeof(line), fp)) {
         int rank, id, marks;
-        char name[50], category[10], dept[10], status[20];
+        char name[50], category[10], dept[PROGRAM_CODE_LEN], status[20];
 
-        if (sscanf(line, "%d,%d,%49[^,],%9[^,],%9[^,],%d,%19s",
+        if (sscanf(line, "%d,%d,%49[^,],%9[^,],%11[^,],%d,%19s",
                    &rank, &id, name, category, dept, &marks, status) == 7) {
             if (strcmp(status, "SELECTED") == 0) {
                 printf("%-6d | %-6d | %-25s | %-10s | %-7d | %-6s | %-10s\n",
@@ -110,36 +125,55 @@ void viewMeritList() {
     fclose(fp);
 }
 
+/* ============================================================
+   PRINT FILTERED ROWS
+   Loads the applicants into a table and prints the rows matching
+   f, in file (merit) order, under the merit list header.
+   ============================================================ */
+static void printMatching(const TableFilter *f) {
+    Applicant a[MAX];
+    int rows[MAX];
+    ApplicantTable t;
+    int n = loadApplicants(a);
+
+    if (n < 0) return;
+    printf("%-6s | %-6s | %-25s | %-10s | %-7s | %-6s | %-10s\n", "Rank", "ID", "Name", "Category", "Marks", "Dept", "Status");
+    printf("---------------------------------------------------------------------------\n");
+
+    if (tableFromRows(&t, a, n) != 0) return;
+    int m = tableFilter(&t, f, rows);
+
+    for (int i = 0; i < m; i++) {
+        Applicant r = tableRow(&t, rows[i]);
+        printf("%-6d | %-6d | %-25s | %-10s | %-7d | %-6s | %-10s\n",
+               r.jee_rank, r.id, applicantName(&r), categoryCode(r.category),
+               r.marks, getDeptCode(r.department),
+               r.allocated ? "SELECTED" : "WAITING");
+    }
+    tableFree(&t);
+}
+
 /* ============================================================
    VIEW CATEGORY-WISE MERIT LIST
    ============================================================ */
 void viewCategoryWiseMeritList(int category) {
     generateMeritList();
 
-    Applicant a[MAX];
-    int n = loadApplicants(a);
-    char catCode[5] = "";
+    int cat;
 
     switch (category) {
-        case 1: strcpy(catCode, "OBC"); break;
-        case 2: strcpy(catCode, "SC"); break;
-        case 3: strcpy(catCode, "ST"); break;
-        case 4: strcpy(catCode, "GEN"); break;
+        case 1: cat = CAT_OBC; break;
+        case 2: cat = CAT_SC; break;
+        case 3: cat = CAT_ST; break;
+        case 4: cat = CAT_GEN; break;
         default: return;
     }
 
-    printf("\n========== %s CATEGORY MERIT LIST ==========\n", catCode);
-    printf("%-6s | %-6s | %-25s | %-10s | %-7s | %-6s | %-10s\n", "Rank", "ID", "Name", "Category", "Marks", "Dept", "Status");
-    printf("---------------------------------------------------------------------------\n");
-
-    for (int i = 0; i < n; i++) {
-        if (strcmp(a[i].category, catCode) == 0 && a[i].allocated) {
-            printf("%-6d | %-6d | %-25s | %-10s | %-7d | %-6s | %-10s\n",
-                   a[i].jee_rank, a[i].id, a[i].name, a[i].category, a[i].marks,
-                   a[i].department,
-                   a[i].allocated ? "SELECTED" : "WAITING");
-        }
-    }
+    printf("\n========== %s CATEGORY MERIT LIST ==========\n", categoryCode(cat));
+    TableFilter f = TABLE_FILTER_ANY;
+    f.category = cat;
+    f.allocated = 1;
+    printMatching(&f);
 }
 
 /* ============================================================
@@ -148,23 +182,14 @@ void viewCategoryWiseMeritList(int category) {
 void viewDepartmentWiseMeritList(int deptChoice) {
     generateMeritList();
 
-    Applicant a[MAX];
-    int n = loadApplicants(a);
-    char depts[4][5] = {"CSE", "IT", "TT", "APM"};
-
-    if (deptChoice < 1 || deptChoice > 4) return;
-
-    printf("\n========== %s DEPARTMENT MERIT LIST ==========\n", depts[deptChoice - 1]);
-    printf("%-6s | %-6s | %-25s | %-10s | %-7s | %-6s | %-10s\n", "Rank", "ID", "Name", "Category", "Marks", "Dept", "Status");
-    printf("---------------------------------------------------------------------------\n");
+    if (deptChoice < 1 || deptChoice > programCount()) return;
+    int dept = deptChoice - 1;
 
-    for (int i = 0; i < n; i++) {
-        if (strcmp(a[i].department, depts[deptChoice - 1]) == 0 && a[i].allocated) {
-            printf("%-6d | %-6d | %-25s | %-10s | %-7d | %-6s | %-10s\n",
-                   a[i].jee_rank, a[i].id, a[i].name,
-                   a[i].category, a[i].marks, a[i].department, "SELECTED");
-        }
-    }
+    printf("\n========== %s DEPARTMENT MERIT LIST ==========\n", getDeptCode(dept));
+    TableFilter f = TABLE_FILTER_ANY;
+    f.department = dept;
+    f.allocated = 1;
+    printMatching(&f);
 }
 
 /* ============================================================
@@ -173,17 +198,53 @@ void viewDepartmentWiseMeritList(int deptChoice) {
 void viewWaitingList() {
     generateMeritList();
 
+    printf("\n========== WAITING LIST ==========\n");
+    TableFilter f = TABLE_FILTER_ANY;
+    f.allocated = 0;
+    printMatching(&f);
+}
+
+/* ============================================================
+   VIEW ADMISSION STATISTICS
+   Seat fill, opening/closing JEE rank and first-preference demand
+   per program and category, for the applicants as last saved.
+   ============================================================ */
+static void printCell(const char *program, const char *category, const StatsCell *c, int seats) {
+    char filled[16];
+
+    if (seats > 0) snprintf(filled, sizeof(filled), "%d/%d", c->filled, seats);
+    else snprintf(filled, sizeof(filled), "%d", c->filled);
+
+    if (c->filled == 0)
+        printf("%-7s | %-8s | %6s | %6d | %7s | %7s\n", program, category, filled, c->demand, "-", "-");
+    else
+        printf("%-7s | %-8s | %6s | %6d | %7d | %7d\n",
+               program, category, filled, c->demand, c->openRank, c->closeRank);
+}
+
+void viewAdmissionStats() {
     Applicant a[MAX];
+    AdmissionStats s;
     int n = loadApplicants(a);
 
-    printf("\n========== WAITING LIST ==========\n");
-    printf("%-6s | %-6s | %-25s | %-10s | %-7s | %-6s | %-10s\n", "Rank", "ID", "Name", "Category", "Marks", "Dept", "Status");
-    printf("---------------------------------------------------------------------------\n");
-
-    for (int i = 0; i < n; i++) {
-        if (!a[i].allocated) {
-            printf("%-6d | %-6d | %-25s | %-10s | %-7d | %-6s | %-10s\n",
-                   a[i].jee_rank, a[i].id, a[i].name, a[i].category, a[i].marks, a[i].department, "WAITING");
-        }
+    if (n <= 0) {
+        printWarning("No applicants found.");
+        return;
+    }
+    statsRebuild(&s, a, n);
+
+    int allocated = statsAllocated(&s);
+    printf("\n========== ADMISSION STATISTICS ==========\n");
+    printf("Applicants: %d   Selected: %d   Waiting: %d\n", n, allocated, n - allocated);
+    for (int c = 0; c < CAT_COUNT; c++)
+        printf("%s%s: %d", c ? "   " : "", categoryCode(c), s.categories[c]);
+    printf("\n\n%-7s | %-8s | %6s | %6s | %7s | %7s\n",
+           "Program", "Category", "Filled", "Demand", "Opening", "Closing");
+    printf("---------------------------------------------------------\n");
+
+    for (int d = 0; d < s.programs; d++) {
+        printCell(getDeptCode(d), "ALL", &s.program[d].total, s.program[d].seats);
+        for (int c = 0; c < CAT_COUNT; c++)
+            printCell("", categoryCode(c), &s.program[d].cat[c], 0);
     }
 }
@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "metrics.h"
+
+#define MAX_METRIC_SHARDS 64
+
+/* Log-linear histogram of microseconds: values below 16 get exact
+   buckets, above that every power of two is split into 16 buckets
+   (at most ~6% relative error), up to 2^36 us. */
+#define HIST_SUB_BITS 4
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_MAX_BIT 35
+#define HIST_BUCKETS ((HIST_MAX_BIT - HIST_SUB_BITS + 2) * HIST_SUB)
+
+typedef struct {
+    _Atomic uint64_t count;
+    _Atomic uint64_t sumUs;
+    _Atomic uint64_t buckets[HIST_BUCKETS];
+} Histogram;
+
+/* Status classes 1xx..5xx, 0 = no reply */
+#define STATUS_CLASSES 6
+
+typedef struct {
+    _Atomic int used;
+    int shared;     // overflow shard: several threads, so atomic adds
+    _Atomic uint64_t counters[METRIC_COUNTER_COUNT];
+    _Atomic uint64_t status[METRIC_ROUTE_COUNT][STATUS_CLASSES];
+    Histogram routes[METRIC_ROUTE_COUNT];
+    Histogram phases[METRIC_PHASE_COUNT];
+} MetricShard;
+
+static MetricShard *shards[MAX_METRIC_SHARDS];
+static _Atomic int nshards;
+static pthread_mutex_t shardLock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local MetricShard *myShard = NULL;
+
+static const char *routeNames[METRIC_ROUTE_COUNT] = {
+    "applicants", "bulk", "update", "login_student", "login_admin",
+    "session", "logout", "register", "generate_merit", "job_status", "query", "stats",
+    "predict", "programs", "metrics",
+    "preflight", "static"
+};
+
+static const char *phaseNames[METRIC_PHASE_COUNT] = {
+    "load", "sort", "allocate", "persist"
+};
+
+static const char *counterNames[METRIC_COUNTER_COUNT][2] = {
+    { "adm_merit_cache_hits_total",   "Merit requests answered from the last completed run" },
+    { "adm_merit_cache_misses_total", "Merit requests that started a new job" },
+    { "adm_merit_joined_total",       "Merit requests that attached to a running job" },
+    { "adm_merit_retries_total",      "Merit runs restarted because the dataset changed" },
+    { "adm_merit_failures_total",     "Merit jobs that failed" },
+    { "adm_http_request_bytes_total", "Request body bytes received" },
+    { "adm_rate_limited_total",       "Requests rejected with 429 by a rate limit" },
+    { "adm_shed_total",               "Expensive requests rejected with 503 under load" },
+};
+
+/* Prometheus le= boundaries in seconds, derived from the fine buckets */
+static const double exportBounds[] = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+    0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60
+};
+#define EXPORT_BOUNDS (sizeof(exportBounds) / sizeof(exportBounds[0]))
+
+/* ============ SHARD FOR THE CALLING THREAD ============ */
+static MetricShard *shard(void) {
+    if (myShard) return myShard;
+
+    // Reuse a shard released by an exited thread (its totals carry on)
+    int n = atomic_load(&nshards);
+    for (int i = 0; i < n; i++) {
+        int expected = 0;
+        if (!shards[i]->shared && atomic_compare_exchange_strong(&shards[i]->used, &expected, 1))
+            return myShard = shards[i];
+    }
+
+    pthread_mutex_lock(&shardLock);
+    n = atomic_load(&nshards);
+    MetricShard *s = n < MAX_METRIC_SHARDS ? calloc(1, sizeof(MetricShard)) : NULL;
+    if (s) {
+        // The last slot is shared by every thread beyond the limit
+        s->shared = (n == MAX_METRIC_SHARDS - 1);
+        atomic_store(&s->used, 1);
+        shards[n] = s;
+        atomic_store(&nshards, n + 1);
+    } else if (n > 0) {
+        s = shards[n - 1];
+    }
+    pthread_mutex_unlock(&shardLock);
+    return myShard = s;
+}
+
+/* Single-writer increment: no locked instruction unless shared */
+static inline void bump(MetricShard *s, _Atomic uint64_t *p, uint64_t n) {
+    if (s->shared)
+        atomic_fetch_add_explicit(p, n, memory_order_relaxed);
+    else
+        atomic_store_explicit(p, atomic_load_explicit(p, memory_order_relaxed) + n,
+                              memory_order_relaxed);
+}
+
+static int bucketIndex(uint64_t v) {
+    if (v < HIST_SUB) return (int) v;
+    int msb = 63 - __builtin_clzll(v);
+    if (msb > HIST_MAX_BIT) return HIST_BUCKETS - 1;
+    int shift = msb - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB + (int) ((v >> shift) & (HIST_SUB - 1));
+}
+
+/* Exclusive upper bound of a bucket, in microseconds */
+static uint64_t bucketUpper(int index) {
+    if (index < HIST_SUB) return (uint64_t) index + 1;
+    int shift = index / HIST_SUB - 1;
+    uint64_t sub = (uint64_t) (index % HIST_SUB);
+    return (HIST_SUB + sub + 1) << shift;
+}
+
+static void observe(MetricShard *s, Histogram *h, uint64_t us) {
+    bump(s, &h->count, 1);
+    bump(s, &h->sumUs, us);
+    bump(s, &h->buckets[bucketIndex(us)], 1);
+}
+
+/* ============ RECORDING (HOT PATH) ============ */
+void metricsObserveRequest(MetricRoute route, int status, uint64_t latencyUs) {
+    MetricShard *s = shard();
+    if (!s || route >= METRIC_ROUTE_COUNT) return;
+
+    int cls = status >= 100 && status < 600 ? status / 100 : 0;
+    bump(s, &s->status[route][cls], 1);
+    observe(s, &s->routes[route], latencyUs);
+}
+
+void metricsObservePhase(MetricPhase phase, uint64_t us) {
+    MetricShard *s = shard();
+    if (!s || phase >= METRIC_PHASE_COUNT) return;
+    observe(s, &s->phases[phase], us);
+}
+
+void metricsCount(MetricCounter counter, uint64_t n) {
+    MetricShard *s = shard();
+    if (!s || counter >= METRIC_COUNTER_COUNT) return;
+    bump(s, &s->counters[counter], n);
+}
+
+/* Hand this thread's shard to the next thread that needs one */
+void metricsThreadExit(void) {
+    if (myShard && !myShard->shared)
+        atomic_store(&myShard->used, 0);
+    myShard = NULL;
+}
+
+/* ============ AGGREGATION ============ */
+typedef struct {
+    uint64_t count, sumUs;
+    uint64_t buckets[HIST_BUCKETS];
+} HistogramTotal;
+
+static void sumRoute(int route, int phase, HistogramTotal *t) {
+    int n = atomic_load(&nshards);
+    memset(t, 0, sizeof(*t));
+
+    for (int i = 0; i < n; i++) {
+        Histogram *h = route >= 0 ? &shards[i]->routes[route] : &shards[i]->phases[phase];
+        t->count += atomic_load_explicit(&h->count, memory_order_relaxed);
+        t->sumUs += atomic_load_explicit(&h->sumUs, memory_order_relaxed);
+        for (int b = 0; b < HIST_BUCKETS; b++)
+            t->buckets[b] += atomic_load_explicit(&h->buckets[b], memory_order_relaxed);
+    }
+}
+
+static double quantileSeconds(const HistogramTotal *t, double q) {
+    uint64_t total = 0, seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) total += t->buckets[b];
+    if (total == 0) return 0;
+
+    uint64_t rank = (uint64_t) (q * (double) (total - 1)) + 1;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += t->buckets[b];
+        if (seen >= rank) return bucketUpper(b) / 1e6;
+    }
+    return bucketUpper(HIST_BUCKETS - 1) / 1e6;
+}
+
+/* ============ PROMETHEUS TEXT ============ */
+typedef struct {
+    char *buf;
+    size_t len, cap;
+    int failed;
+} Text;
+
+static void put(Text *t, const char *fmt, ...) {
+    va_list ap;
+    for (;;) {
+        va_start(ap, fmt);
+        int n = vsnprintf(t->buf ? t->buf + t->len : NULL, t->buf ? t->cap - t->len : 0, fmt, ap);
+        va_end(ap);
+        if (n < 0) {
+            t->failed = 1;
+            return;
+        }
+        if (t->buf && t->len + (size_t) n < t->cap) {
+            t->len += (size_t) n;
+            return;
+        }
+        size_t cap = t->cap ? t->cap * 2 : 16384;
+        while (cap < t->len + (size_t) n + 1) cap *= 2;
+        char *grown = realloc(t->buf, cap);
+        if (!grown) {
+            t->failed = 1;
+            return;
+        }
+        t->buf = grown;
+        t->cap = cap;
+    }
+}
+
+static void putHistogram(Text *t, const char *name, const char *label,
+                         const char *value, const HistogramTotal *h) {
+    uint64_t cumulative = 0;
+    int b = 0;
+
+    for (size_t i = 0; i < EXPORT_BOUNDS; i++) {
+        // Whole fine buckets that end at or below the boundary
+        while (b < HIST_BUCKETS && bucketUpper(b) <= (uint64_t) (exportBounds[i] * 1e6 + 0.5))
+            cumulative += h->buckets[b++];
+        put(t, "%s_bucket{%s=\"%s\",le=\"%g\"} %llu\n", name, label, value,
+            exportBounds[i], (unsigned long long) cumulative);
+    }
+    put(t, "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", name, label, value,
+        (unsigned long long) h->count);
+    put(t, "%s_sum{%s=\"%s\"} %.6f\n", name, label, value, h->sumUs / 1e6);
+    put(t, "%s_count{%s=\"%s\"} %llu\n", name, label, value, (unsigned long long) h->count);
+}
+
+/* Returns a malloc'd document (caller frees) or NULL */
+char *metricsRender(const MetricGauge *gauges, int ngauges, size_t *len) {
+    static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    HistogramTotal *h = malloc(sizeof(HistogramTotal));
+    Text t = { NULL, 0, 0, 0 };
+    int n = atomic_load(&nshards);
+
+    if (!h) return NULL;
+
+    put(&t, "# HELP adm_http_requests_total Requests handled, by route and status class\n"
+            "# TYPE adm_http_requests_total counter\n");
+    for (int r = 0; r < METRIC_ROUTE_COUNT; r++) {
+        for (int c = 0; c < STATUS_CLASSES; c++) {
+            uint64_t v = 0;
+            for (int i = 0; i < n; i++)
+                v += atomic_load_explicit(&shards[i]->status[r][c], memory_order_relaxed);
+            if (v == 0) continue;
+            if (c == 0)
+                put(&t, "adm_http_requests_total{route=\"%s\",code=\"none\"} %llu\n",
+                    routeNames[r], (unsigned long long) v);
+            else
+                put(&t, "adm_http_requests_total{route=\"%s\",code=\"%dxx\"} %llu\n",
+                    routeNames[r], c, (unsigned long long) v);
+        }
+    }
+
+    put(&t, "# HELP adm_http_request_duration_seconds Time spent handling a request\n"
+            "# TYPE adm_http_request_duration_seconds histogram\n");
+    for (int r = 0; r < METRIC_ROUTE_COUNT; r++) {
+        sumRoute(r, 0, h);
+        if (h->count > 0)
+            putHistogram(&t, "adm_http_request_duration_seconds", "route", routeNames[r], h);
+    }
+
+    put(&t, "# HELP adm_http_request_duration_quantile_seconds Latency quantiles from the full-resolution histogram\n"
+            "# TYPE adm_http_request_duration_quantile_seconds gauge\n");
+    for (int r = 0; r < METRIC_ROUTE_COUNT; r++) {
+        sumRoute(r, 0, h);
+        if (h->count == 0) continue;
+        for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++)
+            put(&t, "adm_http_request_duration_quantile_seconds{route=\"%s\",quantile=\"%g\"} %.6f\n",
+                routeNames[r], quantiles[q], quantileSeconds(h, quantiles[q]));
+    }
+
+    put(&t, "# HELP adm_merit_phase_duration_seconds Merit job phase durations\n"
+            "# TYPE adm_merit_phase_duration_seconds histogram\n");
+    for (int p = 0; p < METRIC_PHASE_COUNT; p++) {
+        sumRoute(-1, p, h);
+        putHistogram(&t, "adm_merit_phase_duration_seconds", "phase", phaseNames[p], h);
+    }
+
+    for (int c = 0; c < METRIC_COUNTER_COUNT; c++) {
+        uint64_t v = 0;
+        for (int i = 0; i < n; i++)
+            v += atomic_load_explicit(&shards[i]->counters[c], memory_order_relaxed);
+        put(&t, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", counterNames[c][0],
+            counterNames[c][1], counterNames[c][0], counterNames[c][0], (unsigned long long) v);
+    }
+
+    for (int g = 0; g < ngauges; g++)
+        put(&t, "# HELP %s %s\n# TYPE %s gauge\n%s %.17g\n", gauges[g].name, gauges[g].help,
+            gauges[g].name, gauges[g].name, gauges[g].value);
+
+    free(h);
+    if (t.failed) {
+        free(t.buf);
+        return NULL;
+    }
+    *len = t.len;
+    return t.buf;
+}
+
+/* ============ PERIODIC DUMP ============ */
+/* Written to a temporary file and renamed, so readers never see a
+   partial dump. */
+int metricsDumpFile(const char *path, const MetricGauge *gauges, int ngauges) {
+    char tmp[512];
+    size_t len;
+    char *text = metricsRender(gauges, ngauges, &len);
+    if (!text) return -1;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *fp = fopen(tmp, "w");
+    int ok = fp && fwrite(text, 1, len, fp) == len;
+    if (fp && fclose(fp) != 0) ok = 0;
+    free(text);
+
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        return -1;
+    }
+    return 0;
+}
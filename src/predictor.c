@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <string.h>
+#include "student.h"
+#include "department.h"
+#include "sorting.h"
+#include "merit_engine.h"
+#include "predictor.h"
+
+/* ============ BUILD THE INDEX ============ */
+/* Keys are sorted only when the rows are not already in merit
+   order, which they are after a merit run. Returns 0, or -1 when
+   out of memory. */
+int predictorBuild(Predictor *p, const Applicant a[], int n) {
+    int admits = 0, sorted = 1, programs = programCount();
+
+    memset(p, 0, sizeof(*p));
+    p->programs = programs;
+    for (int d = 0; d < programs; d++)
+        p->seats[d] = programSeats(d);
+    for (int i = 0; i < n; i++)
+        if (a[i].allocated && a[i].department < programs) admits++;
+
+    MeritKey *k = malloc((n > 0 ? n : 1) * sizeof(MeritKey));
+    p->keys = malloc(((size_t) n + admits + 1) * sizeof(unsigned long long));
+    if (!k || !p->keys) {
+        free(k);
+        predictorFree(p);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        k[i].key = meritKey(a[i].jee_rank, a[i].marks);
+        k[i].index = i;
+        if (i > 0 && k[i].key < k[i - 1].key) sorted = 0;
+    }
+    if (!sorted && sortMeritKeys(k, n, SORT_RADIX, 1) != 0) {
+        free(k);
+        predictorFree(p);
+        return -1;
+    }
+
+    // Admits' keys follow the full list, one run per department
+    unsigned long long *next = p->keys + n;
+    for (int i = 0; i < n; i++) {
+        const Applicant *r = &a[i];
+        if (r->allocated && r->department < programs) p->filled[r->department]++;
+    }
+    for (int d = 0; d < programs; d++) {
+        p->admitted[d] = next;
+        next += p->filled[d];
+        p->filled[d] = 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const Applicant *r = &a[k[i].index];
+        p->keys[i] = k[i].key;
+        if (!r->allocated || r->department >= programs) continue;
+
+        int d = r->department;
+        p->admitted[d][p->filled[d]++] = k[i].key;
+        if (r->jee_rank > p->closeRank[d][r->category]) p->closeRank[d][r->category] = r->jee_rank;
+        if (r->jee_rank > p->closeRank[d][CAT_COUNT]) p->closeRank[d][CAT_COUNT] = r->jee_rank;
+    }
+    p->count = n;
+    free(k);
+    return 0;
+}
+
+void predictorFree(Predictor *p) {
+    free(p->keys);
+    memset(p, 0, sizeof(*p));
+}
+
+/* Number of keys <= key in sorted k[0..n) */
+static int countUpTo(const unsigned long long k[], int n, unsigned long long key) {
+    int lo = 0, hi = n;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (k[mid] <= key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* ============ PREDICT ONE APPLICANT ============ */
+/* The hypothetical applicant is placed after everyone with the same
+   rank and marks. self, when the asker is already indexed, is their
+   own row and never counts toward their merit position. Asked with
+   their own rank and marks, their seat is theirs; with a worse one
+   it stays counted as taken, since a rerun would hand it to someone
+   ranked in between and the index cannot tell who. */
+void predictAllocation(const Predictor *p, int jeeRank, int marks,
+                       const uint8_t pref[PREF_COUNT], const Applicant *self,
+                       Prediction *out) {
+    unsigned long long key = meritKey(jeeRank, marks);
+    unsigned long long selfKey = self ? meritKey(self->jee_rank, self->marks) : 0;
+    int selfAhead = self && selfKey <= key;
+    int ownSeat = self && selfKey == key && self->allocated ? self->department : -1;
+
+    out->department = DEPT_NONE;
+    out->preference = 0;
+    out->meritPosition = countUpTo(p->keys, p->count, key) - selfAhead + 1;
+
+    for (int q = 0; q < PREF_COUNT; q++) {
+        int d = pref[q];
+        out->ahead[q] = 0;
+        if (d >= p->programs) continue;
+
+        out->ahead[q] = countUpTo(p->admitted[d], p->filled[d], key);
+        if (d == ownSeat) out->ahead[q]--;
+        if (out->department == DEPT_NONE && out->ahead[q] < p->seats[d]) {
+            out->department = d;
+            out->preference = q + 1;
+        }
+    }
+}
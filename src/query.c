@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
+#include "student.h"
+#include "department.h"
+#include "applicant_table.h"
+#include "scan_kernels.h"
+#include "json_request.h"
+#include "query.h"
+
+static const struct {
+    const char *name;
+    QueryField field;
+} fieldNames[] = {
+    {"id", QF_ID}, {"marks", QF_MARKS}, {"jee_rank", QF_JEE_RANK}, {"rank", QF_JEE_RANK},
+    {"category", QF_CATEGORY}, {"department", QF_DEPARTMENT}, {"dept", QF_DEPARTMENT},
+    {"program", QF_DEPARTMENT}, {"allocated", QF_ALLOCATED}, {"status", QF_ALLOCATED},
+    {"pref1", QF_PREF1}, {"pref2", QF_PREF1 + 1}, {"pref3", QF_PREF1 + 2}, {"pref4", QF_PREF1 + 3},
+};
+
+/* Field names in results */
+static const char *fieldJson[QF_COUNT] = {
+    "id", "marks", "jee_rank", "category", "department", "allocated",
+    "pref1", "pref2", "pref3", "pref4"
+};
+
+static const char *aggNames[] = { "count", "min", "max", "avg", "sum" };
+
+static int isIntField(int f) {
+    return f == QF_ID || f == QF_MARKS || f == QF_JEE_RANK;
+}
+
+/* Number of codes a code field can hold */
+static int codeDomain(int f) {
+    if (f == QF_CATEGORY) return CAT_COUNT;
+    if (f == QF_ALLOCATED) return 2;
+    return DEPT_NONE + 1;
+}
+
+/* Can code g occur in field f? Departments only use the registry's
+   ids and DEPT_NONE. */
+static int isCodeUsed(int f, int g) {
+    if (f == QF_CATEGORY || f == QF_ALLOCATED) return 1;
+    return g < programCount() || g == DEPT_NONE;
+}
+
+/* ============ TOKENIZER ============ */
+/* The current token: a word or number, an operator (= != <> < <= >
+   >=), or one of , ( ) *. Empty at the end of the text. */
+typedef struct {
+    const char *p;
+    char tok[32];
+} Lexer;
+
+static int advance(Lexer *lx) {
+    const char *s = lx->p;
+    size_t n = 0;
+
+    while (isspace((unsigned char) *s)) s++;
+    if (isalnum((unsigned char) *s) || *s == '_' ||
+        (*s == '-' && isdigit((unsigned char) s[1]))) {
+        do n++; while (isalnum((unsigned char) s[n]) || s[n] == '_');
+    } else if (*s && strchr("<>=!", *s)) {
+        n = s[1] && strchr("<>=", s[1]) ? 2 : 1;
+    } else if (*s) {
+        n = 1;
+    }
+
+    if (n >= sizeof(lx->tok)) return -1;
+    memcpy(lx->tok, s, n);
+    lx->tok[n] = '\0';
+    lx->p = s + n;
+    return 0;
+}
+
+static int isWord(const Lexer *lx, const char *word) {
+    return strcasecmp(lx->tok, word) == 0;
+}
+
+/* ============ PARSER ============ */
+static int fail(char *err, size_t size, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(err, size, fmt, ap);
+    va_end(ap);
+    return -1;
+}
+
+static int lookupField(const char *name) {
+    for (size_t i = 0; i < sizeof(fieldNames) / sizeof(fieldNames[0]); i++)
+        if (strcasecmp(name, fieldNames[i].name) == 0)
+            return fieldNames[i].field;
+    return -1;
+}
+
+/* Number or code for field f; -1 (with err set) if invalid */
+static int parseValue(int f, const char *tok, int *value, char *err, size_t size) {
+    char code[16];
+
+    if (isIntField(f)) {
+        char *end;
+        long v = strtol(tok, &end, 10);
+        if (!*tok || *end || v < INT_MIN || v > INT_MAX)
+            return fail(err, size, "%s needs a number, not '%s'", fieldJson[f], tok);
+        *value = (int) v;
+        return 0;
+    }
+
+    size_t n = strlen(tok);
+    if (n >= sizeof(code)) n = sizeof(code) - 1;
+    for (size_t i = 0; i < n; i++) code[i] = (char) toupper((unsigned char) tok[i]);
+    code[n] = '\0';
+
+    if (f == QF_CATEGORY) *value = parseCategory(code);
+    else if (f == QF_ALLOCATED)
+        *value = strcmp(code, "1") == 0 || strcmp(code, "SELECTED") == 0 ? 1 :
+                 strcmp(code, "0") == 0 || strcmp(code, "WAITING") == 0 ? 0 : -1;
+    else *value = parseDepartment(code);
+
+    if (*value < 0 || !*tok)
+        return fail(err, size, "unknown %s '%s'", fieldJson[f], tok);
+    return 0;
+}
+
+static int parseOp(const char *tok) {
+    if (strcmp(tok, "=") == 0 || strcmp(tok, "==") == 0) return QOP_EQ;
+    if (strcmp(tok, "!=") == 0 || strcmp(tok, "<>") == 0) return QOP_NE;
+    if (strcmp(tok, "<") == 0) return QOP_LT;
+    if (strcmp(tok, "<=") == 0) return QOP_LE;
+    if (strcmp(tok, ">") == 0) return QOP_GT;
+    if (strcmp(tok, ">=") == 0) return QOP_GE;
+    return -1;
+}
+
+/* COUNT [( [*] )] or MIN|MAX|AVG|SUM ( int field ) */
+static int parseAgg(Lexer *lx, QueryAgg *a, char *err, size_t size) {
+    int kind = -1;
+    for (int k = AGG_COUNT; k <= AGG_SUM; k++)
+        if (isWord(lx, aggNames[k])) kind = k;
+    if (kind < 0)
+        return fail(err, size, "expected an aggregate, not '%s'", lx->tok);
+    a->kind = (QueryAggKind) kind;
+    a->field = QF_ID;
+    if (advance(lx) < 0) return fail(err, size, "token too long");
+
+    if (kind == AGG_COUNT) {
+        if (strcmp(lx->tok, "(") != 0) return 0;
+        if (advance(lx) < 0) return fail(err, size, "token too long");
+        if (strcmp(lx->tok, "*") == 0 && advance(lx) < 0) return fail(err, size, "token too long");
+    } else {
+        if (strcmp(lx->tok, "(") != 0 || advance(lx) < 0)
+            return fail(err, size, "expected ( after %s", aggNames[kind]);
+        int f = lookupField(lx->tok);
+        if (f < 0 || !isIntField(f))
+            return fail(err, size, "%s needs id, marks or jee_rank, not '%s'", aggNames[kind], lx->tok);
+        a->field = (QueryField) f;
+        if (advance(lx) < 0) return fail(err, size, "token too long");
+    }
+    if (strcmp(lx->tok, ")") != 0)
+        return fail(err, size, "expected ) after %s", aggNames[kind]);
+    return advance(lx) < 0 ? fail(err, size, "token too long") : 0;
+}
+
+/* field op value */
+static int parseTerm(Lexer *lx, QueryTerm *t, char *err, size_t size) {
+    int f = lookupField(lx->tok);
+    if (f < 0) return fail(err, size, "unknown field '%s'", lx->tok);
+    if (advance(lx) < 0) return fail(err, size, "token too long");
+
+    int op = parseOp(lx->tok);
+    if (op < 0) return fail(err, size, "expected an operator after %s, not '%s'", fieldJson[f], lx->tok);
+    if (!isIntField(f) && op != QOP_EQ && op != QOP_NE)
+        return fail(err, size, "%s only takes = and !=", fieldJson[f]);
+    if (advance(lx) < 0) return fail(err, size, "token too long");
+
+    t->field = (QueryField) f;
+    t->op = (QueryOp) op;
+    if (parseValue(f, lx->tok, &t->value, err, size) < 0) return -1;
+    return advance(lx) < 0 ? fail(err, size, "token too long") : 0;
+}
+
+/* Returns 0, or -1 with a message in err */
+int queryParse(const char *text, Query *q, char *err, size_t errSize) {
+    Lexer lx = { text, "" };
+
+    memset(q, 0, sizeof(*q));
+    q->groupBy = -1;
+    if (advance(&lx) < 0) return fail(err, errSize, "token too long");
+    if (isWord(&lx, "select") && advance(&lx) < 0) return fail(err, errSize, "token too long");
+
+    while (lx.tok[0] && !isWord(&lx, "where") && !isWord(&lx, "group")) {
+        if (q->aggCount == QUERY_MAX_AGGS)
+            return fail(err, errSize, "at most %d aggregates", QUERY_MAX_AGGS);
+        if (parseAgg(&lx, &q->aggs[q->aggCount++], err, errSize) < 0) return -1;
+        if (strcmp(lx.tok, ",") != 0) break;
+        if (advance(&lx) < 0) return fail(err, errSize, "token too long");
+    }
+    if (q->aggCount == 0) {
+        q->aggs[0].kind = AGG_COUNT;
+        q->aggCount = 1;
+    }
+
+    if (isWord(&lx, "where")) {
+        do {
+            if (q->termCount == QUERY_MAX_TERMS)
+                return fail(err, errSize, "at most %d conditions", QUERY_MAX_TERMS);
+            if (advance(&lx) < 0) return fail(err, errSize, "token too long");
+            if (parseTerm(&lx, &q->terms[q->termCount++], err, errSize) < 0) return -1;
+        } while (isWord(&lx, "and"));
+    }
+
+    if (isWord(&lx, "group")) {
+        if (advance(&lx) < 0 || !isWord(&lx, "by") || advance(&lx) < 0)
+            return fail(err, errSize, "expected GROUP BY field");
+        int f = lookupField(lx.tok);
+        if (f < 0 || isIntField(f))
+            return fail(err, errSize, "cannot group by '%s'", lx.tok);
+        q->groupBy = f;
+        if (advance(&lx) < 0) return fail(err, errSize, "token too long");
+    }
+
+    if (lx.tok[0]) return fail(err, errSize, "unexpected '%s'", lx.tok);
+    return 0;
+}
+
+/* ============ EXECUTION ============ */
+static const int *intColumn(const ApplicantTable *t, int f) {
+    if (f == QF_MARKS) return t->marks;
+    if (f == QF_JEE_RANK) return t->jee_rank;
+    return t->id;
+}
+
+static const uint8_t *codeColumn(const ApplicantTable *t, int f) {
+    if (f == QF_CATEGORY) return t->category;
+    if (f == QF_DEPARTMENT) return t->department;
+    if (f == QF_ALLOCATED) return t->allocated;
+    return t->pref[f - QF_PREF1];
+}
+
+/* Narrows sel to the rows satisfying one condition */
+static void applyTerm(const ApplicantTable *t, const QueryTerm *term,
+                      uint64_t sel[], uint64_t pass[]) {
+    int n = t->count, v = term->value;
+
+    if (!isIntField(term->field)) {
+        scanEqU8(codeColumn(t, term->field), n, (uint8_t) v, pass);
+    } else {
+        int lo = INT_MIN, hi = INT_MAX;
+        switch (term->op) {
+            case QOP_EQ:
+            case QOP_NE: lo = hi = v; break;
+            case QOP_LT: if (v == INT_MIN) { lo = 1; hi = 0; } else hi = v - 1; break;
+            case QOP_LE: hi = v; break;
+            case QOP_GT: if (v == INT_MAX) { lo = 1; hi = 0; } else lo = v + 1; break;
+            case QOP_GE: lo = v; break;
+        }
+        scanRangeI32(intColumn(t, term->field), n, lo, hi, pass);
+    }
+
+    if (term->op == QOP_NE) bitmapAndNot(sel, pass, n);
+    else bitmapAnd(sel, pass, n);
+}
+
+static void runGroup(const Query *q, const ApplicantTable *t, const uint64_t bits[],
+                     int key, QueryGroup *g) {
+    g->key = key;
+    g->count = bitmapCount(bits, t->count);
+    for (int a = 0; a < q->aggCount; a++) {
+        if (q->aggs[a].kind == AGG_COUNT) {
+            memset(&g->agg[a], 0, sizeof(g->agg[a]));
+            g->agg[a].count = g->count;
+        } else {
+            aggregateI32(intColumn(t, q->aggs[a].field), t->count, bits, &g->agg[a]);
+        }
+    }
+}
+
+/* GROUP BY in one pass over the selected rows: each row adds to the
+   accumulator of its code, instead of one column scan per code (a
+   department column can hold hundreds). Non-empty groups are copied
+   to r in code order. Returns -1 when out of memory. */
+static int runGroupBy(const Query *q, const ApplicantTable *t, const uint64_t sel[],
+                      QueryResult *r) {
+    QueryGroup *acc = calloc(QUERY_MAX_GROUPS, sizeof(QueryGroup));
+    const int *col[QUERY_MAX_AGGS] = {0};
+    const uint8_t *key = codeColumn(t, q->groupBy);
+    size_t words = BITMAP_WORDS(t->count);
+
+    if (!acc) return -1;
+    for (int a = 0; a < q->aggCount; a++)
+        if (q->aggs[a].kind != AGG_COUNT) col[a] = intColumn(t, q->aggs[a].field);
+    for (int g = 0; g < QUERY_MAX_GROUPS; g++) {
+        for (int a = 0; a < q->aggCount; a++) {
+            acc[g].agg[a].min = INT32_MAX;
+            acc[g].agg[a].max = INT32_MIN;
+        }
+    }
+
+    for (size_t w = 0; w < words; w++) {
+        for (uint64_t b = sel[w]; b; b &= b - 1) {
+            int i = (int) (w * 64) + __builtin_ctzll(b);
+            QueryGroup *g = &acc[key[i]];
+            g->count++;
+            for (int a = 0; a < q->aggCount; a++) {
+                ScanAgg *s = &g->agg[a];
+                s->count++;
+                if (!col[a]) continue;
+                int v = col[a][i];
+                s->sum += v;
+                if (v < s->min) s->min = v;
+                if (v > s->max) s->max = v;
+            }
+        }
+    }
+
+    for (int g = 0; g < codeDomain(q->groupBy); g++) {
+        if (acc[g].count == 0 || !isCodeUsed(q->groupBy, g)) continue;
+        QueryGroup *out = &r->groups[r->groupCount++];
+        *out = acc[g];
+        out->key = g;
+        for (int a = 0; a < q->aggCount; a++) {
+            if (!col[a]) {
+                memset(&out->agg[a], 0, sizeof(out->agg[a]));
+                out->agg[a].count = out->count;
+            }
+        }
+    }
+    free(acc);
+    return 0;
+}
+
+/* Returns 0, or -1 when out of memory */
+int queryRun(const Query *q, const ApplicantTable *t, QueryResult *r) {
+    int n = t->count;
+    size_t words = BITMAP_WORDS(n > 0 ? n : 1);
+    uint64_t *sel = malloc(words * sizeof(uint64_t));
+    uint64_t *pass = malloc(words * sizeof(uint64_t));
+    if (!sel || !pass) {
+        free(sel);
+        free(pass);
+        return -1;
+    }
+
+    bitmapFill(sel, n);
+    for (int i = 0; i < q->termCount; i++)
+        applyTerm(t, &q->terms[i], sel, pass);
+
+    r->rows = n;
+    r->matched = bitmapCount(sel, n);
+    r->groupCount = 0;
+    int rc = 0;
+    if (q->groupBy < 0)
+        runGroup(q, t, sel, -1, &r->groups[r->groupCount++]);
+    else
+        rc = runGroupBy(q, t, sel, r);
+
+    free(sel);
+    free(pass);
+    return rc;
+}
+
+/* ============ RESULT AS JSON ============ */
+static const char *codeName(int f, int code) {
+    if (f == QF_CATEGORY) return categoryCode(code);
+    return getDeptCode(code);
+}
+
+/* {"rows":N,"matched":M,"groups":[{"department":"CSE","count":..,
+   "avg_marks":..},...]}; min/max/avg are null for an empty group.
+   Returns the length, or -1 if buf is too small. */
+int queryFormatJson(const Query *q, const QueryResult *r, char *buf, size_t size) {
+    size_t len = 0;
+
+    jsonAppend(buf, size, &len, "{\"rows\":%d,\"matched\":%d,\"groups\":[", r->rows, r->matched);
+    for (int g = 0; g < r->groupCount; g++) {
+        const QueryGroup *grp = &r->groups[g];
+        jsonAppend(buf, size, &len, "%s{", g ? "," : "");
+        if (q->groupBy == QF_ALLOCATED)
+            jsonAppend(buf, size, &len, "\"allocated\":%d,", grp->key);
+        else if (q->groupBy >= 0)
+            jsonAppend(buf, size, &len, "\"%s\":\"%s\",", fieldJson[q->groupBy], codeName(q->groupBy, grp->key));
+
+        for (int a = 0; a < q->aggCount; a++) {
+            const QueryAgg *agg = &q->aggs[a];
+            const ScanAgg *v = &grp->agg[a];
+            const char *sep = a ? "," : "";
+
+            if (agg->kind == AGG_COUNT) {
+                jsonAppend(buf, size, &len, "%s\"count\":%lld", sep, v->count);
+                continue;
+            }
+            jsonAppend(buf, size, &len, "%s\"%s_%s\":", sep, aggNames[agg->kind], fieldJson[agg->field]);
+            if (agg->kind == AGG_SUM) jsonAppend(buf, size, &len, "%lld", v->sum);
+            else if (v->count == 0) jsonAppend(buf, size, &len, "null");
+            else if (agg->kind == AGG_AVG) jsonAppend(buf, size, &len, "%.2f", (double) v->sum / v->count);
+            else jsonAppend(buf, size, &len, "%d", agg->kind == AGG_MIN ? v->min : v->max);
+        }
+        jsonAppend(buf, size, &len, "}");
+    }
+    jsonAppend(buf, size, &len, "]}");
+    return len < size ? (int) len : -1;
+}
@@ -0,0 +1,126 @@
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include "rate_limit.h"
+
+#define CLIENT_PROBE 8              /* slots searched per address */
+#define BUDGET_WINDOW_US 1000000u
+
+typedef struct {
+    uint8_t addr[16];
+    uint8_t len;                    /* 0 = free slot */
+    uint64_t lastSeenUs;
+    TokenBucket buckets[RATE_MAX_ROUTES];
+} ClientEntry;
+
+static ClientEntry clients[RATE_CLIENT_SLOTS];
+
+static atomic_int inFlight;
+static int maxInFlight = 1;
+static uint64_t budgetUs = BUDGET_WINDOW_US;
+static uint64_t windowStartUs;
+static uint64_t busyThisWindow, busyLastWindow;
+
+/* ============ TOKEN BUCKET ============ */
+int tokenBucketTake(TokenBucket *b, const RateLimit *limit, uint64_t nowUs, int *retryAfter) {
+    if (limit->rate <= 0) return 1;
+
+    if (b->lastUs == 0) {
+        b->tokens = limit->burst;
+    } else if (nowUs > b->lastUs) {
+        b->tokens += (double) (nowUs - b->lastUs) / 1e6 * limit->rate;
+        if (b->tokens > limit->burst) b->tokens = limit->burst;
+    }
+    b->lastUs = nowUs;
+
+    if (b->tokens >= 1.0) {
+        b->tokens -= 1.0;
+        return 1;
+    }
+    // Whole seconds until one token has accumulated, at least 1
+    int wait = (int) ((1.0 - b->tokens) / limit->rate + 0.999);
+    *retryAfter = wait > 0 ? wait : 1;
+    return 0;
+}
+
+void tokenBucketRefund(TokenBucket *b, const RateLimit *limit) {
+    if (limit->rate <= 0) return;
+    b->tokens += 1.0;
+    if (b->tokens > limit->burst) b->tokens = limit->burst;
+}
+
+/* ============ PER-CLIENT BUCKETS ============ */
+/* An address maps to one of CLIENT_PROBE slots from its hash; when
+   all are taken by other clients the least recently seen one is
+   reused, which only ever makes a limit more lenient. */
+TokenBucket *rateClientBucket(const uint8_t *addr, size_t len, int route, uint64_t nowUs) {
+    uint32_t h = 2166136261u;
+    if (len > sizeof(clients[0].addr)) len = sizeof(clients[0].addr);
+    assert(route >= 0 && route < RATE_MAX_ROUTES);   // never share another route's bucket
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ addr[i]) * 16777619u;
+
+    ClientEntry *victim = NULL;
+    for (int i = 0; i < CLIENT_PROBE; i++) {
+        ClientEntry *e = &clients[(h + (uint32_t) i) & (RATE_CLIENT_SLOTS - 1)];
+        if (e->len == len && memcmp(e->addr, addr, len) == 0) {
+            e->lastSeenUs = nowUs;
+            return &e->buckets[route];
+        }
+        if (!victim || e->lastSeenUs < victim->lastSeenUs)
+            victim = e;
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    memcpy(victim->addr, addr, len);
+    victim->len = (uint8_t) len;
+    victim->lastSeenUs = nowUs;
+    return &victim->buckets[route];
+}
+
+/* ============ ADMISSION CONTROL ============ */
+void admissionInit(int max, uint64_t budgetUsPerSecond) {
+    maxInFlight = max > 0 ? max : 1;
+    budgetUs = budgetUsPerSecond;
+}
+
+/* 1 if the caller may start expensive work; pair with admissionLeave() */
+int admissionTryEnter(void) {
+    int n = atomic_load(&inFlight);
+    while (n < maxInFlight) {
+        if (atomic_compare_exchange_weak(&inFlight, &n, n + 1))
+            return 1;
+    }
+    return 0;
+}
+
+void admissionLeave(void) {
+    atomic_fetch_sub(&inFlight, 1);
+}
+
+int admissionInFlight(void) {
+    return atomic_load(&inFlight);
+}
+
+static void rollWindow(uint64_t nowUs) {
+    if (nowUs - windowStartUs < BUDGET_WINDOW_US) return;
+    // A gap of more than one window means the last one was idle
+    busyLastWindow = nowUs - windowStartUs < 2 * BUDGET_WINDOW_US ? busyThisWindow : 0;
+    busyThisWindow = 0;
+    windowStartUs = nowUs - (nowUs - windowStartUs) % BUDGET_WINDOW_US;
+}
+
+/* Event-loop time an expensive handler just used */
+void admissionCharge(uint64_t busyUs, uint64_t nowUs) {
+    rollWindow(nowUs);
+    busyThisWindow += busyUs;
+}
+
+/* Sliding estimate over the last second: the previous window weighted
+   by how much of it still overlaps, plus the current one */
+int admissionOverBudget(uint64_t nowUs) {
+    if (budgetUs == 0) return 0;
+    rollWindow(nowUs);
+    double overlap = 1.0 - (double) (nowUs - windowStartUs) / BUDGET_WINDOW_US;
+    return busyLastWindow * overlap + busyThisWindow > (double) budgetUs;
+}
@@ -0,0 +1,401 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "scan_kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#else
+#define SCAN_X86 0
+#endif
+
+/* One implementation per level; rows are processed 64 at a time
+   (one bitmap word) and the last partial word by the scalar code. */
+typedef struct {
+    void (*eqU8)(const uint8_t *col, int n, uint8_t value, uint64_t bits[]);
+    void (*rangeI32)(const int *col, int n, int lo, int hi, uint64_t bits[]);
+    int (*countEqU8)(const uint8_t *col, int n, uint8_t value);
+    void (*aggI32)(const int *col, int n, const uint64_t bits[], ScanAgg *agg);
+} ScanOps;
+
+/* ============ SCALAR ============ */
+static uint64_t eqWord(const uint8_t *c, int len, uint8_t value) {
+    uint64_t w = 0;
+    for (int i = 0; i < len; i++)
+        w |= (uint64_t) (c[i] == value) << i;
+    return w;
+}
+
+static uint64_t rangeWord(const int *c, int len, int lo, int hi) {
+    uint64_t w = 0;
+    for (int i = 0; i < len; i++)
+        w |= (uint64_t) (c[i] >= lo && c[i] <= hi) << i;
+    return w;
+}
+
+static int countTail(const uint8_t *c, int len, uint8_t value) {
+    int m = 0;
+    for (int i = 0; i < len; i++)
+        m += c[i] == value;
+    return m;
+}
+
+static void eqU8Scalar(const uint8_t *col, int n, uint8_t value, uint64_t bits[]) {
+    for (int w = 0; w * 64 < n; w++)
+        bits[w] = eqWord(col + w * 64, n - w * 64 < 64 ? n - w * 64 : 64, value);
+}
+
+static void rangeI32Scalar(const int *col, int n, int lo, int hi, uint64_t bits[]) {
+    for (int w = 0; w * 64 < n; w++)
+        bits[w] = rangeWord(col + w * 64, n - w * 64 < 64 ? n - w * 64 : 64, lo, hi);
+}
+
+static int countEqU8Scalar(const uint8_t *col, int n, uint8_t value) {
+    return countTail(col, n, value);
+}
+
+/* Folds the rows of one bitmap word (base row `base`) into agg */
+static void aggWord(const int *col, int base, uint64_t w, ScanAgg *agg) {
+    for (; w; w &= w - 1) {
+        int v = col[base + __builtin_ctzll(w)];
+        agg->sum += v;
+        if (v < agg->min) agg->min = v;
+        if (v > agg->max) agg->max = v;
+    }
+}
+
+static void aggI32Scalar(const int *col, int n, const uint64_t bits[], ScanAgg *agg) {
+    for (int w = 0; w * 64 < n; w++) {
+        agg->count += __builtin_popcountll(bits[w]);
+        aggWord(col, w * 64, bits[w], agg);
+    }
+}
+
+static const ScanOps scalarOps = { eqU8Scalar, rangeI32Scalar, countEqU8Scalar, aggI32Scalar };
+
+#if SCAN_X86
+/* ============ SSE2 ============ */
+__attribute__((target("sse2")))
+static void eqU8Sse2(const uint8_t *col, int n, uint8_t value, uint64_t bits[]) {
+    __m128i v = _mm_set1_epi8((char) value);
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        const uint8_t *c = col + w * 64;
+        uint64_t word = 0;
+        for (int k = 0; k < 4; k++) {
+            __m128i x = _mm_loadu_si128((const __m128i *) (c + 16 * k));
+            word |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(x, v)) << (16 * k);
+        }
+        bits[w] = word;
+    }
+    if (n % 64) bits[full] = eqWord(col + full * 64, n % 64, value);
+}
+
+__attribute__((target("sse2")))
+static void rangeI32Sse2(const int *col, int n, int lo, int hi, uint64_t bits[]) {
+    __m128i vlo = _mm_set1_epi32(lo), vhi = _mm_set1_epi32(hi);
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        const int *c = col + w * 64;
+        uint64_t word = 0;
+        for (int k = 0; k < 16; k++) {
+            __m128i x = _mm_loadu_si128((const __m128i *) (c + 4 * k));
+            __m128i out = _mm_or_si128(_mm_cmpgt_epi32(vlo, x), _mm_cmpgt_epi32(x, vhi));
+            word |= (uint64_t) (~_mm_movemask_ps(_mm_castsi128_ps(out)) & 0xF) << (4 * k);
+        }
+        bits[w] = word;
+    }
+    if (n % 64) bits[full] = rangeWord(col + full * 64, n % 64, lo, hi);
+}
+
+__attribute__((target("sse2")))
+static int countEqU8Sse2(const uint8_t *col, int n, uint8_t value) {
+    __m128i v = _mm_set1_epi8((char) value);
+    int m = 0, i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *) (col + i));
+        m += __builtin_popcount((unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(x, v)));
+    }
+    return m + countTail(col + i, n - i, value);
+}
+
+/* SSE2 has no 32-bit min/max, so aggregation stays scalar */
+static const ScanOps sse2Ops = { eqU8Sse2, rangeI32Sse2, countEqU8Sse2, aggI32Scalar };
+
+/* ============ AVX2 ============ */
+__attribute__((target("avx2,popcnt")))
+static void eqU8Avx2(const uint8_t *col, int n, uint8_t value, uint64_t bits[]) {
+    __m256i v = _mm256_set1_epi8((char) value);
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        const uint8_t *c = col + w * 64;
+        __m256i x0 = _mm256_loadu_si256((const __m256i *) c);
+        __m256i x1 = _mm256_loadu_si256((const __m256i *) (c + 32));
+        uint32_t m0 = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x0, v));
+        uint32_t m1 = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x1, v));
+        bits[w] = m0 | (uint64_t) m1 << 32;
+    }
+    if (n % 64) bits[full] = eqWord(col + full * 64, n % 64, value);
+}
+
+__attribute__((target("avx2,popcnt")))
+static void rangeI32Avx2(const int *col, int n, int lo, int hi, uint64_t bits[]) {
+    __m256i vlo = _mm256_set1_epi32(lo), vhi = _mm256_set1_epi32(hi);
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        const int *c = col + w * 64;
+        uint64_t word = 0;
+        for (int k = 0; k < 8; k++) {
+            __m256i x = _mm256_loadu_si256((const __m256i *) (c + 8 * k));
+            __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+            word |= (uint64_t) (~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xFF) << (8 * k);
+        }
+        bits[w] = word;
+    }
+    if (n % 64) bits[full] = rangeWord(col + full * 64, n % 64, lo, hi);
+}
+
+__attribute__((target("avx2,popcnt")))
+static int countEqU8Avx2(const uint8_t *col, int n, uint8_t value) {
+    __m256i v = _mm256_set1_epi8((char) value);
+    int m = 0, i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *) (col + i));
+        m += __builtin_popcount((unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v)));
+    }
+    return m + countTail(col + i, n - i, value);
+}
+
+/* Each 8 bits of the selection become an 8-lane mask */
+__attribute__((target("avx2,popcnt")))
+static void aggI32Avx2(const int *col, int n, const uint64_t bits[], ScanAgg *agg) {
+    const __m256i lane = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i vmin = _mm256_set1_epi32(INT32_MAX), vmax = _mm256_set1_epi32(INT32_MIN);
+    __m256i vsum = _mm256_setzero_si256();
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        uint64_t word = bits[w];
+        if (!word) continue;
+        agg->count += __builtin_popcountll(word);
+        for (int k = 0; k < 8; k++, word >>= 8) {
+            if (!(word & 0xFF)) continue;
+            __m256i x = _mm256_loadu_si256((const __m256i *) (col + w * 64 + 8 * k));
+            __m256i sel = _mm256_set1_epi32((int) (word & 0xFF));
+            __m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(sel, lane), lane);
+            vmin = _mm256_blendv_epi8(vmin, _mm256_min_epi32(vmin, x), m);
+            vmax = _mm256_blendv_epi8(vmax, _mm256_max_epi32(vmax, x), m);
+            __m256i xm = _mm256_and_si256(x, m);
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(xm)));
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(xm, 1)));
+        }
+    }
+
+    int mins[8], maxs[8];
+    long long sums[4];
+    _mm256_storeu_si256((__m256i *) mins, vmin);
+    _mm256_storeu_si256((__m256i *) maxs, vmax);
+    _mm256_storeu_si256((__m256i *) sums, vsum);
+    for (int i = 0; i < 8; i++) {
+        if (mins[i] < agg->min) agg->min = mins[i];
+        if (maxs[i] > agg->max) agg->max = maxs[i];
+    }
+    agg->sum += sums[0] + sums[1] + sums[2] + sums[3];
+    if (n % 64) {
+        agg->count += __builtin_popcountll(bits[full]);
+        aggWord(col, full * 64, bits[full], agg);
+    }
+}
+
+static const ScanOps avx2Ops = { eqU8Avx2, rangeI32Avx2, countEqU8Avx2, aggI32Avx2 };
+
+/* ============ AVX-512 ============ */
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static void eqU8Avx512(const uint8_t *col, int n, uint8_t value, uint64_t bits[]) {
+    __m512i v = _mm512_set1_epi8((char) value);
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++)
+        bits[w] = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(col + w * 64), v);
+    if (n % 64) bits[full] = eqWord(col + full * 64, n % 64, value);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static void rangeI32Avx512(const int *col, int n, int lo, int hi, uint64_t bits[]) {
+    __m512i vlo = _mm512_set1_epi32(lo), vhi = _mm512_set1_epi32(hi);
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        const int *c = col + w * 64;
+        uint64_t word = 0;
+        for (int k = 0; k < 4; k++) {
+            __m512i x = _mm512_loadu_si512(c + 16 * k);
+            __mmask16 in = _mm512_cmpge_epi32_mask(x, vlo) & _mm512_cmple_epi32_mask(x, vhi);
+            word |= (uint64_t) in << (16 * k);
+        }
+        bits[w] = word;
+    }
+    if (n % 64) bits[full] = rangeWord(col + full * 64, n % 64, lo, hi);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static int countEqU8Avx512(const uint8_t *col, int n, uint8_t value) {
+    __m512i v = _mm512_set1_epi8((char) value);
+    int m = 0, i = 0;
+
+    for (; i + 64 <= n; i += 64)
+        m += __builtin_popcountll(_mm512_cmpeq_epi8_mask(_mm512_loadu_si512(col + i), v));
+    return m + countTail(col + i, n - i, value);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static void aggI32Avx512(const int *col, int n, const uint64_t bits[], ScanAgg *agg) {
+    __m512i vmin = _mm512_set1_epi32(INT32_MAX), vmax = _mm512_set1_epi32(INT32_MIN);
+    __m512i vsum = _mm512_setzero_si512();
+    int full = n / 64;
+
+    for (int w = 0; w < full; w++) {
+        uint64_t word = bits[w];
+        if (!word) continue;
+        agg->count += __builtin_popcountll(word);
+        for (int k = 0; k < 4; k++, word >>= 16) {
+            __mmask16 m = (__mmask16) word;
+            if (!m) continue;
+            __m512i x = _mm512_loadu_si512(col + w * 64 + 16 * k);
+            vmin = _mm512_mask_min_epi32(vmin, m, vmin, x);
+            vmax = _mm512_mask_max_epi32(vmax, m, vmax, x);
+            vsum = _mm512_mask_add_epi64(vsum, (__mmask8) m, vsum,
+                                         _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)));
+            vsum = _mm512_mask_add_epi64(vsum, (__mmask8) (m >> 8), vsum,
+                                         _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+        }
+    }
+
+    int lo = _mm512_reduce_min_epi32(vmin), hi = _mm512_reduce_max_epi32(vmax);
+    if (lo < agg->min) agg->min = lo;
+    if (hi > agg->max) agg->max = hi;
+    agg->sum += _mm512_reduce_add_epi64(vsum);
+    if (n % 64) {
+        agg->count += __builtin_popcountll(bits[full]);
+        aggWord(col, full * 64, bits[full], agg);
+    }
+}
+
+static const ScanOps avx512Ops = { eqU8Avx512, rangeI32Avx512, countEqU8Avx512, aggI32Avx512 };
+#endif
+
+/* ============ RUNTIME DISPATCH ============ */
+static const char *levelNames[] = { "scalar", "sse2", "avx2", "avx512" };
+static ScanLevel level;
+static const ScanOps *ops = &scalarOps;
+static pthread_once_t dispatchOnce = PTHREAD_ONCE_INIT;
+
+static void chooseLevel(void) {
+    ScanLevel best = SCAN_SCALAR;
+#if SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) best = SCAN_SSE2;
+    if (__builtin_cpu_supports("avx2")) best = SCAN_AVX2;
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        best = SCAN_AVX512;
+#endif
+
+    const char *cap = getenv("ADM_SIMD");
+    for (int l = SCAN_SCALAR; cap && l <= SCAN_AVX512; l++)
+        if (strcmp(cap, levelNames[l]) == 0 && (ScanLevel) l < best)
+            best = (ScanLevel) l;
+
+    level = best;
+#if SCAN_X86
+    switch (best) {
+        case SCAN_AVX512: ops = &avx512Ops; break;
+        case SCAN_AVX2:   ops = &avx2Ops; break;
+        case SCAN_SSE2:   ops = &sse2Ops; break;
+        default:          ops = &scalarOps; break;
+    }
+#endif
+}
+
+static const ScanOps *scanOps(void) {
+    pthread_once(&dispatchOnce, chooseLevel);
+    return ops;
+}
+
+ScanLevel scanLevel(void) {
+    scanOps();
+    return level;
+}
+
+const char *scanLevelName(ScanLevel l) {
+    return l >= SCAN_SCALAR && l <= SCAN_AVX512 ? levelNames[l] : "unknown";
+}
+
+/* ============ PREDICATES ============ */
+/* bits[] must hold BITMAP_WORDS(n) words */
+void scanEqU8(const uint8_t *col, int n, uint8_t value, uint64_t bits[]) {
+    scanOps()->eqU8(col, n, value, bits);
+}
+
+/* Rows with lo <= col[i] <= hi */
+void scanRangeI32(const int *col, int n, int lo, int hi, uint64_t bits[]) {
+    scanOps()->rangeI32(col, n, lo, hi, bits);
+}
+
+int countEqU8(const uint8_t *col, int n, uint8_t value) {
+    return scanOps()->countEqU8(col, n, value);
+}
+
+/* Aggregates col over the rows selected in bits[] */
+void aggregateI32(const int *col, int n, const uint64_t bits[], ScanAgg *agg) {
+    agg->count = 0;
+    agg->sum = 0;
+    agg->min = INT32_MAX;
+    agg->max = INT32_MIN;
+    scanOps()->aggI32(col, n, bits, agg);
+}
+
+/* ============ BITMAPS ============ */
+/* All n rows selected */
+void bitmapFill(uint64_t bits[], int n) {
+    size_t words = BITMAP_WORDS(n);
+    memset(bits, 0xFF, words * sizeof(uint64_t));
+    if (n % 64) bits[words - 1] = (1ULL << (n % 64)) - 1;
+}
+
+void bitmapAnd(uint64_t dst[], const uint64_t src[], int n) {
+    size_t words = BITMAP_WORDS(n);
+    for (size_t w = 0; w < words; w++)
+        dst[w] &= src[w];
+}
+
+void bitmapAndNot(uint64_t dst[], const uint64_t src[], int n) {
+    size_t words = BITMAP_WORDS(n);
+    for (size_t w = 0; w < words; w++)
+        dst[w] &= ~src[w];
+}
+
+int bitmapCount(const uint64_t bits[], int n) {
+    size_t words = BITMAP_WORDS(n);
+    int m = 0;
+    for (size_t w = 0; w < words; w++)
+        m += __builtin_popcountll(bits[w]);
+    return m;
+}
+
+/* Indexes of the selected rows, ascending; returns how many */
+int bitmapRows(const uint64_t bits[], int n, int out[]) {
+    size_t words = BITMAP_WORDS(n);
+    int m = 0;
+    for (size_t w = 0; w < words; w++) {
+        for (uint64_t b = bits[w]; b; b &= b - 1)
+            out[m++] = (int) (w * 64) + __builtin_ctzll(b);
+    }
+    return m;
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "student.h"
+#include "department.h"
+#include "applicant_table.h"
+#include "scenario.h"
+
+#define MAX_SCENARIO_SEATS 1000000
+#define MAX_SCENARIO_THREADS 256
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* ============ DEFAULT SEAT MATRIX ============ */
+void scenarioDefault(Scenario *s, const char *name) {
+    memset(s, 0, sizeof(*s));
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    for (int d = 0; d < programCount(); d++)
+        s->seats[d] = programSeats(d);
+    s->prefs = PREF_COUNT;
+}
+
+/* ============ PARSE ONE SCENARIO LINE ============ */
+/* Returns 0, or -1 with a message in err */
+int scenarioParse(const char *line, Scenario *s, char *err, size_t errSize) {
+    char buf[512], *save, *tok;
+
+    if (strlen(line) >= sizeof(buf)) {
+        snprintf(err, errSize, "line too long");
+        return -1;
+    }
+    strcpy(buf, line);
+
+    tok = strtok_r(buf, " \t\r\n", &save);
+    if (!tok || strchr(tok, '=')) {
+        snprintf(err, errSize, "expected a scenario name first");
+        return -1;
+    }
+    if (strlen(tok) >= SCENARIO_NAME_LEN) {
+        snprintf(err, errSize, "name longer than %d characters", SCENARIO_NAME_LEN - 1);
+        return -1;
+    }
+    scenarioDefault(s, tok);
+
+    while ((tok = strtok_r(NULL, " \t\r\n", &save))) {
+        char *eq = strchr(tok, '=');
+        char *end;
+        if (!eq) {
+            snprintf(err, errSize, "expected key=value, got '%s'", tok);
+            return -1;
+        }
+        *eq = '\0';
+        long v = strtol(eq + 1, &end, 10);
+        if (eq[1] == '\0' || *end != '\0' || v < 0 || v > MAX_SCENARIO_SEATS) {
+            snprintf(err, errSize, "bad number for %s", tok);
+            return -1;
+        }
+
+        char *dot = strchr(tok, '.');
+        if (dot) *dot = '\0';
+        int dept = parseDepartment(tok);
+
+        if (strcmp(tok, "prefs") == 0 && !dot) {
+            if (v < 1 || v > PREF_COUNT) {
+                snprintf(err, errSize, "prefs must be 1-%d", PREF_COUNT);
+                return -1;
+            }
+            s->prefs = (int) v;
+        } else if (dept < 0 || dept == DEPT_NONE) {
+            snprintf(err, errSize, "unknown program '%s'", tok);
+            return -1;
+        } else if (!dot) {
+            s->seats[dept] = (int) v;
+        } else {
+            int cat = parseCategory(dot + 1);
+            if (cat < 0) {
+                snprintf(err, errSize, "unknown category '%s'", dot + 1);
+                return -1;
+            }
+            s->reserved[dept][cat] = (int) v;
+        }
+    }
+
+    for (int d = 0; d < programCount(); d++) {
+        long reserved = 0;
+        for (int c = 0; c < CAT_COUNT; c++)
+            reserved += s->reserved[d][c];
+        if (reserved > s->seats[d]) {
+            snprintf(err, errSize, "%s reserves more seats than it has", getDeptCode(d));
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ============ ALLOCATE ONE SCENARIO ============ */
+/* Same walk as allocateTableSeats(), over the open and reserved
+   seats of s; stops once every seat is taken. With base, counts
+   moves against the baseline allocation base[] (baseAdmitted
+   admits); with dept, records each row's program there. */
+static void allocateScenario(const ApplicantTable *t, const Scenario *s,
+                             const uint8_t *base, int baseAdmitted,
+                             uint8_t *dept, ScenarioResult *r) {
+    int open[MAX_PROGRAMS], reserved[MAX_PROGRAMS][CAT_COUNT];
+    int programs = programCount();
+    long left = 0;
+    int kept = 0;
+    double start = nowMs();
+
+    memset(r, 0, sizeof(*r));
+    memcpy(reserved, s->reserved, programs * sizeof(reserved[0]));
+    for (int d = 0; d < programs; d++) {
+        open[d] = s->seats[d];
+        for (int c = 0; c < CAT_COUNT; c++)
+            open[d] -= reserved[d][c];
+        left += s->seats[d];
+    }
+    if (dept) memset(dept, DEPT_NONE, t->count);
+
+    for (int i = 0; i < t->count && left > 0; i++) {
+        int c = t->category[i];
+        for (int p = 0; p < s->prefs; p++) {
+            int d = t->pref[p][i];
+            int fromReserve = 0;
+            if (d >= programs) continue;
+            if (open[d] > 0) {
+                open[d]--;
+            } else if (reserved[d][c] > 0) {
+                reserved[d][c]--;
+                fromReserve = 1;
+            } else {
+                continue;
+            }
+
+            ScenarioProgram *prog = &r->program[d];
+            int rank = t->jee_rank[i];
+            if (prog->filled == 0 || rank < prog->openRank) prog->openRank = rank;
+            if (prog->filled == 0 || rank > prog->closeRank) prog->closeRank = rank;
+            prog->filled++;
+            prog->reservedFilled += fromReserve;
+            r->admitted++;
+            r->categoryAdmitted[c]++;
+            left--;
+
+            if (dept) dept[i] = (uint8_t) d;
+            if (base) {
+                if (base[i] == DEPT_NONE) r->gained++;
+                else if (base[i] == d) kept++;
+                else r->moved++;
+            }
+            break;
+        }
+    }
+
+    if (base) r->lost = baseAdmitted - kept - r->moved;
+    r->ms = nowMs() - start;
+}
+
+/* ============ WORKER THREADS ============ */
+typedef struct {
+    const ApplicantTable *t;
+    const Scenario *sc;
+    ScenarioResult *out;
+    int count;
+    const uint8_t *base;
+    int baseAdmitted;
+    _Atomic int next;          // next scenario to take
+} ScenarioRun;
+
+static void *scenarioWorker(void *arg) {
+    ScenarioRun *run = (ScenarioRun *) arg;
+    int i;
+
+    while ((i = atomic_fetch_add(&run->next, 1)) < run->count)
+        allocateScenario(run->t, &run->sc[i], run->base, run->baseAdmitted, NULL, &run->out[i]);
+    return NULL;
+}
+
+/* ============ RUN ALL SCENARIOS ============ */
+/* t must be in merit order (tableSort). Fills baseline and out[i]
+   for sc[i], spreading the scenarios over up to `threads` threads.
+   Returns 0, or -1 when out of memory. */
+int scenarioRunAll(const ApplicantTable *t, const Scenario sc[], int count,
+                   ScenarioResult *baseline, ScenarioResult out[], int threads) {
+    Scenario def;
+    uint8_t *base = malloc(t->count > 0 ? t->count : 1);
+    if (!base) return -1;
+
+    scenarioDefault(&def, "baseline");
+    allocateScenario(t, &def, NULL, 0, base, baseline);
+
+    ScenarioRun run = { t, sc, out, count, base, baseline->admitted, 0 };
+    pthread_t tids[MAX_SCENARIO_THREADS];
+    int started = 0;
+
+    if (threads > count) threads = count;
+    if (threads > MAX_SCENARIO_THREADS) threads = MAX_SCENARIO_THREADS;
+    while (started < threads - 1 &&
+           pthread_create(&tids[started], NULL, scenarioWorker, &run) == 0)
+        started++;
+    scenarioWorker(&run);   // this thread works too
+    for (int i = 0; i < started; i++)
+        pthread_join(tids[i], NULL);
+
+    free(base);
+    return 0;
+}
@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/random.h>
+#include "session.h"
+
+#define SESSION_PROBE 32            /* slots searched per token */
+
+typedef struct {
+    long empId;                     /* 0 = empty slot */
+    char username[100];
+    char password[100];
+} AdminCredential;
+
+static AdminCredential *admins = NULL;
+static unsigned int adminMask = 0;
+static int adminCount = -1;         /* -1 until the file has been read */
+static char adminPath[256];
+static struct stat adminStat;
+
+static Session *sessions = NULL;    /* allocated on first login */
+static unsigned int sessionMask = 0;
+static unsigned int sessionUsed = 0;  /* occupied slots, expired or not */
+
+static unsigned int idHash(long id) {
+    return (unsigned int) (((unsigned long long) id * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/* ============ ADMIN CREDENTIALS ============ */
+/* Reads EmpID,Username,Password rows into a new table and swaps it
+   in. Returns the number of admins, or -1 (old table kept) if the
+   file cannot be read. */
+static int readCredentials(void) {
+    FILE *fp = fopen(adminPath, "r");
+    if (!fp) return -1;
+
+    int rows = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) rows++;
+
+    unsigned int size = 16;
+    while (size < 2u * (unsigned int) rows) size *= 2;
+    AdminCredential *table = calloc(size, sizeof(AdminCredential));
+    if (!table) {
+        fclose(fp);
+        return -1;
+    }
+
+    int n = 0;
+    rewind(fp);
+    fgets(line, sizeof(line), fp); // Skip header
+    while (fgets(line, sizeof(line), fp)) {
+        AdminCredential c;
+        memset(&c, 0, sizeof(c));
+        if (sscanf(line, "%ld,%99[^,],%99[^\n\r]", &c.empId, c.username, c.password) != 3 ||
+            c.empId == 0)
+            continue;
+
+        unsigned int h = idHash(c.empId) & (size - 1);
+        while (table[h].empId && table[h].empId != c.empId)
+            h = (h + 1) & (size - 1);
+        if (!table[h].empId) {
+            table[h] = c;
+            n++;
+        }
+    }
+    fstat(fileno(fp), &adminStat);
+    fclose(fp);
+
+    free(admins);
+    admins = table;
+    adminMask = size - 1;
+    adminCount = n;
+    return n;
+}
+
+int credentialsLoad(const char *path) {
+    snprintf(adminPath, sizeof(adminPath), "%s", path);
+    return readCredentials();
+}
+
+/* Reloads when the file's size or mtime changed; returns 1 if reloaded */
+int credentialsRefreshIfChanged(void) {
+    struct stat st;
+    if (stat(adminPath, &st) != 0) return 0;
+    if (adminCount >= 0 && st.st_size == adminStat.st_size &&
+        st.st_mtim.tv_sec == adminStat.st_mtim.tv_sec &&
+        st.st_mtim.tv_nsec == adminStat.st_mtim.tv_nsec)
+        return 0;
+    return readCredentials() >= 0;
+}
+
+/* 1 on a match, 0 on a mismatch, -1 if no credentials could be read */
+int credentialsCheckAdmin(long empId, const char *username, const char *password) {
+    if (adminCount < 0) return -1;
+    if (empId == 0) return 0;
+
+    for (unsigned int h = idHash(empId) & adminMask; admins[h].empId; h = (h + 1) & adminMask) {
+        if (admins[h].empId == empId)
+            return strcmp(admins[h].username, username) == 0 &&
+                   strcmp(admins[h].password, password) == 0;
+    }
+    return 0;
+}
+
+int credentialsCount(void) {
+    return adminCount;
+}
+
+/* ============ SESSION TABLE ============ */
+/* A token's home slot comes from its leading hex digits (the token is
+   random, so they are uniformly distributed); it lives somewhere in
+   the SESSION_PROBE slots from there. */
+static unsigned int tokenHome(const char *token) {
+    unsigned int h = 0;
+    for (int i = 0; i < 8; i++) {
+        char ch = token[i];
+        h = h * 16 + (unsigned int) (ch <= '9' ? ch - '0' : ch - 'a' + 10);
+    }
+    return h & sessionMask;
+}
+
+static int newToken(char out[SESSION_TOKEN_LEN + 1]) {
+    static const char hex[] = "0123456789abcdef";
+    unsigned char raw[SESSION_TOKEN_LEN / 2];
+
+    if (getrandom(raw, sizeof(raw), 0) != (ssize_t) sizeof(raw)) return -1;
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        out[2 * i] = hex[raw[i] >> 4];
+        out[2 * i + 1] = hex[raw[i] & 15];
+    }
+    out[SESSION_TOKEN_LEN] = '\0';
+    return 0;
+}
+
+static int validToken(const char *token, size_t len) {
+    if (len != SESSION_TOKEN_LEN) return 0;
+    for (size_t i = 0; i < len; i++)
+        if (!((token[i] >= '0' && token[i] <= '9') || (token[i] >= 'a' && token[i] <= 'f')))
+            return 0;
+    return 1;
+}
+
+static Session *findSlot(const char *token, size_t len) {
+    if (!sessions || !validToken(token, len)) return NULL;
+
+    unsigned int home = tokenHome(token);
+    for (int i = 0; i < SESSION_PROBE; i++) {
+        Session *s = &sessions[(home + i) & sessionMask];
+        if (s->token[0] && memcmp(s->token, token, SESSION_TOKEN_LEN) == 0)
+            return s;
+    }
+    return NULL;
+}
+
+/* A free or expired slot in the token's probe window, or NULL */
+static Session *openSlot(const char *token, time_t now) {
+    unsigned int home = tokenHome(token);
+    for (int i = 0; i < SESSION_PROBE; i++) {
+        Session *s = &sessions[(home + i) & sessionMask];
+        if (!s->token[0] || s->expires <= now)
+            return s;
+    }
+    return NULL;
+}
+
+static void clearSlot(Session *s) {
+    memset(s, 0, sizeof(*s));
+    sessionUsed--;
+}
+
+/* Clears every expired slot. Expiry has one-second resolution, so a
+   second sweep within the same second would free nothing and is
+   skipped. */
+static void sweepExpired(time_t now) {
+    static time_t lastSweep;
+
+    if (now == lastSweep) return;
+    for (unsigned int i = 0; i <= sessionMask; i++)
+        if (sessions[i].token[0] && sessions[i].expires <= now) clearSlot(&sessions[i]);
+    lastSweep = now;
+}
+
+/* Moves the live sessions into a table of the given size (a power of
+   two). Returns -1, keeping the old table, when out of memory or if a
+   probe window overflows. */
+static int resizeTable(unsigned int size, time_t now) {
+    Session *old = sessions;
+    unsigned int oldMask = sessionMask;
+    unsigned int oldUsed = sessionUsed;
+    Session *table = calloc(size, sizeof(Session));
+    if (!table) return -1;
+
+    sessions = table;
+    sessionMask = size - 1;
+    sessionUsed = 0;
+    for (unsigned int i = 0; old && i <= oldMask; i++) {
+        if (!old[i].token[0] || old[i].expires <= now) continue;
+        Session *slot = openSlot(old[i].token, now);
+        if (!slot) {
+            sessions = old;
+            sessionMask = oldMask;
+            sessionUsed = oldUsed;
+            free(table);
+            return -1;
+        }
+        *slot = old[i];
+        sessionUsed++;
+    }
+    free(old);
+    return 0;
+}
+
+/* Takes a free or expired slot near the token's home; a live session
+   is never evicted. When that window is full, expired sessions are
+   cleared from the whole table and, if the window is still full, the
+   table doubles (up to SESSION_MAX_CAPACITY). Returns NULL only when
+   the table cannot grow further (the caller should shed load) or no
+   random token could be made. Growing moves sessions, so a pointer
+   from sessionLookup() is only valid until the next sessionCreate(). */
+const Session *sessionCreate(SessionRole role, long subjectId, const char *name) {
+    char token[SESSION_TOKEN_LEN + 1];
+    time_t now = time(NULL);
+
+    if (newToken(token) < 0) return NULL;
+    if (!sessions && resizeTable(SESSION_CAPACITY, now) < 0) return NULL;
+
+    Session *slot = openSlot(token, now);
+    if (!slot) {
+        // Double while the window is still full or the table half used;
+        // slot is always re-taken from the current table
+        sweepExpired(now);
+        unsigned int size = sessionMask + 1;
+        while ((!(slot = openSlot(token, now)) || 2 * sessionUsed >= size) &&
+               size < SESSION_MAX_CAPACITY && resizeTable(size * 2, now) == 0)
+            size *= 2;
+        if (!slot) return NULL;
+    }
+
+    if (!slot->token[0]) sessionUsed++;
+    memset(slot, 0, sizeof(*slot));
+    memcpy(slot->token, token, sizeof(token));
+    slot->role = role;
+    slot->subjectId = subjectId;
+    snprintf(slot->name, sizeof(slot->name), "%s", name ? name : "");
+    slot->expires = now + SESSION_TTL_SECONDS;
+    return slot;
+}
+
+/* Live session for the token, with its expiry extended; NULL if the
+   token is unknown or has expired. */
+const Session *sessionLookup(const char *token, size_t len) {
+    Session *s = findSlot(token, len);
+    time_t now = time(NULL);
+
+    if (!s) return NULL;
+    if (s->expires <= now) {
+        clearSlot(s);
+        return NULL;
+    }
+    s->expires = now + SESSION_TTL_SECONDS;
+    return s;
+}
+
+/* Returns 1 if the token named a session */
+int sessionRevoke(const char *token, size_t len) {
+    Session *s = findSlot(token, len);
+    if (!s) return 0;
+    clearSlot(s);
+    return 1;
+}
+
+/* Ends every session of one student or admin except keep (e.g. after
+   a password change made through keep) */
+void sessionRevokeSubject(SessionRole role, long subjectId, const Session *keep) {
+    for (unsigned int i = 0; sessions && i <= sessionMask; i++)
+        if (sessions[i].token[0] && sessions[i].role == role &&
+            sessions[i].subjectId == subjectId && &sessions[i] != keep)
+            clearSlot(&sessions[i]);
+}
+
+int sessionCount(void) {
+    time_t now = time(NULL);
+    int n = 0;
+    for (unsigned int i = 0; sessions && i <= sessionMask; i++)
+        if (sessions[i].token[0] && sessions[i].expires > now) n++;
+    return n;
+}
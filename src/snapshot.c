@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "student.h"
+#include "department.h"
+#include "csv_handler.h"
+#include "snapshot.h"
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t count;
+    uint32_t programs;         // programsFingerprint() of the writer
+    uint32_t reserved;
+} SnapshotHeader;
+
+/* ============ WRITE SNAPSHOT HEADER ============ */
+/* For writers that stream `count` records in chunks after the header themselves. */
+int writeSnapshotHeader(FILE *fp, uint64_t count) {
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.recordSize = sizeof(Applicant);
+    h.count = count;
+    h.programs = programsFingerprint();
+
+    return fwrite(&h, sizeof(h), 1, fp) == 1 ? 0 : -1;
+}
+
+/* ============ SAVE SNAPSHOT ============ */
+/* Appends s (with its NUL) to the chunk's strings; returns its offset */
+static int64_t addString(char **buf, size_t *len, size_t *cap, const char *s) {
+    size_t n = strlen(s) + 1;
+    if (*len + n > *cap) {
+        size_t grown = 2 * *cap + n;
+        char *b = realloc(*buf, grown);
+        if (!b) return -1;
+        *buf = b;
+        *cap = grown;
+    }
+    memcpy(*buf + *len, s, n);
+    *len += n;
+    return (int64_t) (*len - n);
+}
+
+int saveSnapshot(const char *path, Applicant a[], int n) {
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) return -1;
+
+    size_t cap = SNAPSHOT_CHUNK_ROWS * (NAME_LEN + PASSWORD_LEN);
+    Applicant *rec = malloc(SNAPSHOT_CHUNK_ROWS * sizeof(Applicant));
+    char *str = malloc(cap);
+    int ok = rec && str && writeSnapshotHeader(fp, (uint64_t) n) == 0;
+
+    for (int first = 0; ok && first < n; first += SNAPSHOT_CHUNK_ROWS) {
+        SnapshotChunk c;
+        size_t len = 0;
+        c.rows = (uint32_t) (n - first < SNAPSHOT_CHUNK_ROWS ? n - first : SNAPSHOT_CHUNK_ROWS);
+
+        memcpy(rec, a + first, c.rows * sizeof(Applicant));
+        for (uint32_t i = 0; ok && i < c.rows; i++) {
+            int64_t name = addString(&str, &len, &cap, applicantName(&rec[i]));
+            int64_t pass = addString(&str, &len, &cap, applicantPassword(&rec[i]));
+            ok = name >= 0 && pass >= 0;
+            rec[i].name = (StrRef) name;
+            rec[i].password = (StrRef) pass;
+        }
+        c.stringBytes = (uint32_t) len;
+
+        ok = ok && fwrite(&c, sizeof(c), 1, fp) == 1 &&
+             fwrite(rec, sizeof(Applicant), c.rows, fp) == c.rows &&
+             fwrite(str, 1, len, fp) == len;
+    }
+    free(rec);
+    free(str);
+
+    if (fclose(fp) != 0 || !ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+/* ============ LOAD SNAPSHOT ============ */
+static int isDeptCode(int d) {
+    return d < programCount() || d == DEPT_NONE;
+}
+
+/* Interns one chunk's strings and checks its codes; -1 if corrupt */
+static int resolveChunk(Applicant a[], uint32_t rows, const char *str, uint32_t len) {
+    if (len == 0 || str[len - 1] != '\0') return -1;
+
+    for (uint32_t i = 0; i < rows; i++) {
+        if (a[i].name >= len || a[i].password >= len ||
+            a[i].category >= CAT_COUNT || !isDeptCode(a[i].department) || a[i].allocated > 1)
+            return -1;
+        for (int p = 0; p < PREF_COUNT; p++)
+            if (!isDeptCode(a[i].pref[p])) return -1;
+
+        a[i].name = arenaIntern(str + a[i].name);
+        a[i].password = arenaIntern(str + a[i].password);
+    }
+    return 0;
+}
+
+/* Returns the record count (array in *out, caller frees) or -1. */
+int loadSnapshot(const char *path, Applicant **out) {
+    FILE *fp = fopen(path, "rb");
+    SnapshotHeader h;
+
+    *out = NULL;
+    if (!fp) return -1;
+
+    if (fread(&h, sizeof(h), 1, fp) != 1 ||
+        memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != SNAPSHOT_VERSION ||
+        h.recordSize != sizeof(Applicant) ||
+        h.programs != programsFingerprint() ||
+        h.count > 0x7FFFFFFF) {
+        fclose(fp);
+        return -1;
+    }
+
+    int n = (int) h.count;
+    Applicant *a = malloc((n > 0 ? n : 1) * sizeof(Applicant));
+    char *str = NULL;
+    size_t cap = 0;
+    int got = 0;
+
+    while (a && got < n) {
+        SnapshotChunk c;
+        if (fread(&c, sizeof(c), 1, fp) != 1 || c.rows == 0 || c.rows > (uint32_t) (n - got) ||
+            c.stringBytes > c.rows * 2u * (STR_MAX_LEN + 1))
+            break;
+        if (c.stringBytes > cap) {
+            char *grown = realloc(str, c.stringBytes);
+            if (!grown) break;
+            str = grown;
+            cap = c.stringBytes;
+        }
+        if (fread(a + got, sizeof(Applicant), c.rows, fp) != c.rows ||
+            fread(str, 1, c.stringBytes, fp) != c.stringBytes ||
+            resolveChunk(a + got, c.rows, str, c.stringBytes) != 0)
+            break;
+        got += (int) c.rows;
+    }
+    free(str);
+    fclose(fp);
+
+    if (!a || got != n) {
+        free(a);
+        return -1;
+    }
+    *out = a;
+    return n;
+}
+
+/* ============ DETECT SNAPSHOT BY MAGIC ============ */
+int isSnapshotFile(const char *path) {
+    char magic[8];
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+
+    int is = fread(magic, sizeof(magic), 1, fp) == 1 &&
+             memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    fclose(fp);
+    return is;
+}
+
+/* ============ LOAD CSV OR SNAPSHOT ============ */
+int loadApplicantsAuto(const char *path, Applicant **out) {
+    if (isSnapshotFile(path))
+        return loadSnapshot(path, out);
+    return loadApplicantsFrom(path, out);
+}
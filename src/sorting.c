@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <pthread.h>
 #include "student.h"
 #include "sorting.h"
+#include "trace.h"
 
 /* =====================================================
    COMPARISON FUNCTION
@@ -25,83 +27,177 @@ int isBetter(Applicant a, Applicant b) {
     return 0;
 }
 
+/* =====================================================
+   MERIT KEY
+   JEE rank ascending in the high half, marks descending in
+   the low half: a smaller key is exactly isBetter(). The
+   algorithms below sort (key, row index) pairs and the rows
+   are permuted once at the end, so they move 16 bytes per
+   step instead of whole records and never read other fields.
+   ===================================================== */
+unsigned long long meritKey(int jeeRank, int marks) {
+    unsigned int rank = (unsigned int) jeeRank ^ 0x80000000u;
+    unsigned int m = ~((unsigned int) marks ^ 0x80000000u);
+    return ((unsigned long long) rank << 32) | m;
+}
+
+/* ================= INSTRUMENTATION ================= */
+/* Counters live per thread and are folded into the totals when a
+   sort worker finishes, so counting never contends. When disabled
+   the sorts pay one predictable branch per comparison. */
+#define statsOn (SORT_STATS && statsEnabled)
+
+static int statsEnabled;
+static SortStats statsTotal;
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local SortStats statsLocal;
+
+#define COUNT_MOVES(k) do { \
+        if (statsOn) { \
+            statsLocal.moves += (k); \
+            statsLocal.bytesCopied += (unsigned long long) (k) * sizeof(MeritKey); \
+        } \
+    } while (0)
+#define COUNT_BYTES(b) do { if (statsOn) statsLocal.bytesCopied += (b); } while (0)
+
+static inline int better(const MeritKey *x, const MeritKey *y) {
+    if (statsOn) statsLocal.comparisons++;
+    return x->key < y->key;
+}
+
+/* malloc that counts scratch allocations */
+static void *sortAlloc(size_t size) {
+    if (statsOn) {
+        statsLocal.allocations++;
+        statsLocal.bytesAllocated += size;
+    }
+    return malloc(size);
+}
+
+static void statsFlush(void) {
+    if (!statsOn) return;
+    pthread_mutex_lock(&statsLock);
+    statsTotal.comparisons += statsLocal.comparisons;
+    statsTotal.moves += statsLocal.moves;
+    statsTotal.bytesCopied += statsLocal.bytesCopied;
+    statsTotal.allocations += statsLocal.allocations;
+    statsTotal.bytesAllocated += statsLocal.bytesAllocated;
+    pthread_mutex_unlock(&statsLock);
+    memset(&statsLocal, 0, sizeof(statsLocal));
+}
+
+void sortStatsEnable(int on) {
+    statsEnabled = on;
+}
+
+void sortStatsReset(void) {
+    pthread_mutex_lock(&statsLock);
+    memset(&statsTotal, 0, sizeof(statsTotal));
+    pthread_mutex_unlock(&statsLock);
+    memset(&statsLocal, 0, sizeof(statsLocal));
+}
+
+SortStats sortStatsGet(void) {
+    statsFlush();
+    pthread_mutex_lock(&statsLock);
+    SortStats s = statsTotal;
+    pthread_mutex_unlock(&statsLock);
+    return s;
+}
+
+void sortStatsPrint(FILE *fp, const SortStats *s) {
+    fprintf(fp, "%llu comparisons, %llu moves, %.1f MB copied, %llu allocations (%.1f MB)\n",
+            s->comparisons, s->moves, s->bytesCopied / (1024.0 * 1024.0),
+            s->allocations, s->bytesAllocated / (1024.0 * 1024.0));
+}
+
 /* ================= SELECTION SORT ================= */
-void selectionSort(Applicant a[], int n) {
+static void selectionKeys(MeritKey a[], int n) {
     int i, j, best;
 
     for (i = 0; i < n - 1; i++) {
         best = i;
 
         for (j = i + 1; j < n; j++) {
-            if (isBetter(a[j], a[best]))
+            if (better(&a[j], &a[best]))
                 best = j;
         }
 
         if (best != i) {
-            Applicant temp = a[i];
+            MeritKey temp = a[i];
             a[i] = a[best];
             a[best] = temp;
+            COUNT_MOVES(3);
         }
     }
 }
 
 /* ================= INSERTION SORT ================= */
-void insertionSort(Applicant a[], int n) {
+static void insertionKeys(MeritKey a[], int n) {
     int i, j;
-    Applicant key;
+    MeritKey key;
 
     for (i = 1; i < n; i++) {
         key = a[i];
         j = i - 1;
 
-        while (j >= 0 && isBetter(key, a[j])) {
+        while (j >= 0 && better(&key, &a[j])) {
             a[j + 1] = a[j];
             j--;
         }
 
         a[j + 1] = key;
+        COUNT_MOVES(i - j + 1);
     }
 }
 
 /* ================= QUICK SORT HELPER ================= */
-static int partition(Applicant a[], int low, int high) {
-    Applicant pivot = a[high];
+static int partition(MeritKey a[], int low, int high) {
+    MeritKey pivot = a[high];
     int i = low - 1;
     int j;
 
     for (j = low; j < high; j++) {
-        if (isBetter(a[j], pivot)) {
+        if (better(&a[j], &pivot)) {
             i++;
-            Applicant temp = a[i];
+            MeritKey temp = a[i];
             a[i] = a[j];
             a[j] = temp;
+            COUNT_MOVES(3);
         }
     }
 
-    Applicant temp = a[i + 1];
+    MeritKey temp = a[i + 1];
     a[i + 1] = a[high];
     a[high] = temp;
+    COUNT_MOVES(4);
 
     return i + 1;
 }
 
 /* ================= QUICK SORT ================= */
-void quickSort(Applicant a[], int low, int high) {
+static void quickKeys(MeritKey a[], int low, int high) {
     if (low < high) {
         int pi = partition(a, low, high);
-        quickSort(a, low, pi - 1);
-        quickSort(a, pi + 1, high);
+        quickKeys(a, low, pi - 1);
+        quickKeys(a, pi + 1, high);
     }
 }
 
 /* ================= MERGE SORT HELPER ================= */
-static void merge(Applicant a[], int l, int m, int r) {
+/* Returns -1, leaving a[] as it was, if the halves cannot be copied */
+static int merge(MeritKey a[], int l, int m, int r) {
     int n1 = m - l + 1;
     int n2 = r - m;
     int i, j, k = l;
 
-    Applicant *L = (Applicant *)malloc(n1 * sizeof(Applicant));
-    Applicant *R = (Applicant *)malloc(n2 * sizeof(Applicant));
+    MeritKey *L = (MeritKey *)sortAlloc(n1 * sizeof(MeritKey));
+    MeritKey *R = (MeritKey *)sortAlloc(n2 * sizeof(MeritKey));
+    if (!L || !R) {
+        free(L);
+        free(R);
+        return -1;
+    }
 
     for (i = 0; i < n1; i++)
         L[i] = a[l + i];
@@ -112,7 +208,7 @@ static void merge(Applicant a[], int l, int m, int r) {
     j = 0;
 
     while (i < n1 && j < n2) {
-        if (isBetter(L[i], R[j])) {
+        if (better(&L[i], &R[j])) {
             a[k++] = L[i++];
         } else {
             a[k++] = R[j++];
@@ -125,16 +221,262 @@ static void merge(Applicant a[], int l, int m, int r) {
     while (j < n2)
         a[k++] = R[j++];
 
+    COUNT_MOVES(2 * (n1 + n2));
     free(L);
     free(R);
+    return 0;
 }
 
 /* ================= MERGE SORT ================= */
-void mergeSort(Applicant a[], int l, int r) {
+static int mergeKeys(MeritKey a[], int l, int r) {
     if (l < r) {
         int m = l + (r - l) / 2;
-        mergeSort(a, l, m);
-        mergeSort(a, m + 1, r);
-        merge(a, l, m, r);
+        if (mergeKeys(a, l, m) != 0 || mergeKeys(a, m + 1, r) != 0)
+            return -1;
+        return merge(a, l, m, r);
+    }
+    return 0;
+}
+
+/* ================= RADIX SORT ================= */
+/* LSD radix sort on the 64-bit key, 16 bits per pass, skipping
+   passes where every key has the same digit. Stable. */
+static int radixKeys(MeritKey items[], int n) {
+    MeritKey *tmp = sortAlloc(n * sizeof(MeritKey));
+    int *count = sortAlloc(65536 * sizeof(int));
+    if (!tmp || !count) {
+        free(tmp);
+        free(count);
+        return mergeKeys(items, 0, n - 1);
+    }
+
+    MeritKey *src = items;
+    for (int shift = 0; shift < 64; shift += 16) {
+        memset(count, 0, 65536 * sizeof(int));
+
+        for (int i = 0; i < n; i++)
+            count[(src[i].key >> shift) & 0xFFFF]++;
+
+        // All keys share this digit: nothing to do
+        if (count[(src[0].key >> shift) & 0xFFFF] == n)
+            continue;
+
+        int sum = 0;
+        for (int d = 0; d < 65536; d++) {
+            int c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (int i = 0; i < n; i++)
+            tmp[count[(src[i].key >> shift) & 0xFFFF]++] = src[i];
+        COUNT_BYTES((unsigned long long) n * sizeof(MeritKey));
+
+        MeritKey *swap = src;
+        src = tmp;
+        tmp = swap;
+    }
+
+    // An odd number of passes leaves the result in the scratch buffer
+    if (src != items) {
+        memcpy(items, src, n * sizeof(MeritKey));
+        COUNT_BYTES((unsigned long long) n * sizeof(MeritKey));
+        tmp = src;
+    }
+    free(tmp);
+    free(count);
+    return 0;
+}
+
+/* ================= SORT DISPATCH ================= */
+static const char *sortNames[] = {
+    "", "selection", "insertion", "merge", "quick", "radix"
+};
+
+const char *sortAlgorithmName(SortAlgorithm algo) {
+    if (algo >= SORT_SELECTION && algo <= SORT_RADIX)
+        return sortNames[algo];
+    return "unknown";
+}
+
+/* Returns the algorithm for a name like "radix", or 0 if unknown */
+SortAlgorithm parseSortAlgorithm(const char *name) {
+    for (int i = SORT_SELECTION; i <= SORT_RADIX; i++)
+        if (strcmp(name, sortNames[i]) == 0)
+            return (SortAlgorithm) i;
+    return 0;
+}
+
+/* Returns -1 if the algorithm ran out of scratch memory */
+static int sortRange(MeritKey k[], int n, SortAlgorithm algo) {
+    switch (algo) {
+        case SORT_SELECTION: selectionKeys(k, n); return 0;
+        case SORT_INSERTION: insertionKeys(k, n); return 0;
+        case SORT_QUICK:     quickKeys(k, 0, n - 1); return 0;
+        case SORT_RADIX:     return radixKeys(k, n);
+        default:             return mergeKeys(k, 0, n - 1);
+    }
+}
+
+/* ================= PARALLEL SORT ================= */
+/* The keys are cut into one chunk per thread; each chunk is sorted
+   with the chosen algorithm on its own thread, then neighbouring
+   runs are merged pairwise (each merge on its own thread) until one
+   run remains. */
+typedef struct {
+    MeritKey *k;
+    MeritKey *buf;
+    int lo, mid, hi;
+    SortAlgorithm algo;
+    int failed;             /* chunk sort ran out of memory */
+} SortTask;
+
+static void *sortChunkThread(void *arg) {
+    SortTask *t = (SortTask *) arg;
+    TraceSpan span = traceBegin("sort.chunk");
+    t->failed = sortRange(t->k + t->lo, t->hi - t->lo, t->algo) != 0;
+    span.n = t->hi - t->lo;
+    traceEnd(&span);
+    statsFlush();
+    return NULL;
+}
+
+/* Merge sorted runs [lo,mid) and [mid,hi); ties keep the left run first */
+static void *mergeRunsThread(void *arg) {
+    SortTask *t = (SortTask *) arg;
+    int i = t->lo, j = t->mid, k = t->lo;
+    TraceSpan span = traceBegin("sort.merge");
+
+    while (i < t->mid && j < t->hi) {
+        if (better(&t->k[j], &t->k[i]))
+            t->buf[k++] = t->k[j++];
+        else
+            t->buf[k++] = t->k[i++];
+    }
+    while (i < t->mid) t->buf[k++] = t->k[i++];
+    while (j < t->hi) t->buf[k++] = t->k[j++];
+
+    memcpy(t->k + t->lo, t->buf + t->lo, (t->hi - t->lo) * sizeof(MeritKey));
+    COUNT_MOVES(2 * (t->hi - t->lo));
+    span.n = t->hi - t->lo;
+    traceEnd(&span);
+    statsFlush();
+    return NULL;
+}
+
+/* Returns -1 when out of memory; k[] then holds the same keys in
+   no particular order. */
+int sortMeritKeys(MeritKey k[], int n, SortAlgorithm algo, int threads) {
+    if (threads > MAX_SORT_THREADS) threads = MAX_SORT_THREADS;
+    if (threads < 2 || n < threads * 2)
+        return n > 1 ? sortRange(k, n, algo) : 0;
+
+    MeritKey *buf = sortAlloc(n * sizeof(MeritKey));
+    if (!buf)
+        return sortRange(k, n, algo);
+
+    int bounds[MAX_SORT_THREADS + 1];
+    SortTask tasks[MAX_SORT_THREADS];
+    pthread_t tids[MAX_SORT_THREADS];
+    int started[MAX_SORT_THREADS];
+    int runs = threads;
+
+    for (int t = 0; t <= runs; t++)
+        bounds[t] = (int) ((long long) n * t / runs);
+
+    for (int t = 0; t < runs; t++) {
+        tasks[t] = (SortTask) { k, buf, bounds[t], 0, bounds[t + 1], algo, 0 };
+        started[t] = pthread_create(&tids[t], NULL, sortChunkThread, &tasks[t]) == 0;
+        if (!started[t])
+            sortChunkThread(&tasks[t]);
+    }
+    int failed = 0;
+    for (int t = 0; t < runs; t++) {
+        if (started[t]) pthread_join(tids[t], NULL);
+        failed |= tasks[t].failed;
+    }
+    if (failed) {
+        free(buf);
+        return -1;
+    }
+
+    while (runs > 1) {
+        int merges = runs / 2;
+
+        for (int m = 0; m < merges; m++) {
+            tasks[m] = (SortTask) { k, buf, bounds[2 * m], bounds[2 * m + 1], bounds[2 * m + 2], algo, 0 };
+            started[m] = pthread_create(&tids[m], NULL, mergeRunsThread, &tasks[m]) == 0;
+            if (!started[m])
+                mergeRunsThread(&tasks[m]);
+        }
+        for (int m = 0; m < merges; m++)
+            if (started[m]) pthread_join(tids[m], NULL);
+
+        // Collapse the run boundaries; an odd last run carries over
+        int next = 0;
+        for (int r = 0; r <= runs; r += 2)
+            bounds[next++] = bounds[r];
+        if (runs % 2 == 1)
+            bounds[next++] = bounds[runs];
+        runs = next - 1;
     }
+
+    free(buf);
+    return 0;
+}
+
+/* ================= SORTING RECORDS ================= */
+/* Sorts the keys of a[] and then moves each record once. Returns
+   -1, leaving a[] as it was, when out of memory. */
+int sortApplicants(Applicant a[], int n, SortAlgorithm algo, int threads) {
+    if (n < 2) return 0;
+
+    MeritKey *k = sortAlloc(n * sizeof(MeritKey));
+    Applicant *out = sortAlloc(n * sizeof(Applicant));
+    if (!k || !out) {
+        free(k);
+        free(out);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        k[i].key = meritKey(a[i].jee_rank, a[i].marks);
+        k[i].index = i;
+    }
+    COUNT_BYTES((unsigned long long) n * sizeof(MeritKey));
+
+    if (sortMeritKeys(k, n, algo, threads) != 0) {
+        free(k);
+        free(out);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++)
+        out[i] = a[k[i].index];
+    memcpy(a, out, n * sizeof(Applicant));
+    COUNT_BYTES(2 * (unsigned long long) n * sizeof(Applicant));
+
+    free(k);
+    free(out);
+    return 0;
+}
+
+/* Wrappers: 0, or -1 (records unchanged) when out of memory */
+int selectionSort(Applicant a[], int n) {
+    return sortApplicants(a, n, SORT_SELECTION, 1);
+}
+
+int insertionSort(Applicant a[], int n) {
+    return sortApplicants(a, n, SORT_INSERTION, 1);
+}
+
+int quickSort(Applicant a[], int low, int high) {
+    return low < high ? sortApplicants(a + low, high - low + 1, SORT_QUICK, 1) : 0;
+}
+
+int mergeSort(Applicant a[], int l, int r) {
+    return l < r ? sortApplicants(a + l, r - l + 1, SORT_MERGE, 1) : 0;
+}
+
+int radixSort(Applicant a[], int n) {
+    return sortApplicants(a, n, SORT_RADIX, 1);
 }
@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "string_arena.h"
+
+#define BLOCK_BITS 20
+#define BLOCK_SIZE (1u << BLOCK_BITS)
+#define MAX_BLOCKS 4096             /* 4 GB of strings */
+
+typedef struct {
+    uint32_t hash;
+    StrRef ref;                     /* 0 = empty slot */
+    uint16_t len;                   /* compared before the bytes, so a
+                                       match never reads past a string */
+} InternSlot;
+
+/* Block 0 starts with the "" that handle 0 names */
+static char firstBlock[BLOCK_SIZE];
+static char *blocks[MAX_BLOCKS] = { firstBlock };
+static uint32_t blockCount = 1;
+static uint32_t blockUsed = 1;
+
+static InternSlot *table;
+static uint32_t tableMask;
+static size_t stringCount, stringBytes;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t hashBytes(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ (unsigned char) s[i]) * 16777619u;
+    return h;
+}
+
+const char *arenaGet(StrRef ref) {
+    return blocks[ref >> BLOCK_BITS] + (ref & (BLOCK_SIZE - 1));
+}
+
+/* ============ INTERN TABLE ============ */
+/* Open addressing, kept at most half full */
+static int growTable(void) {
+    uint32_t size = table ? 2 * (tableMask + 1) : 1024;
+    InternSlot *grown = calloc(size, sizeof(InternSlot));
+    if (!grown) return -1;
+
+    for (uint32_t i = 0; table && i <= tableMask; i++) {
+        if (!table[i].ref) continue;
+        uint32_t h = table[i].hash & (size - 1);
+        while (grown[h].ref) h = (h + 1) & (size - 1);
+        grown[h] = table[i];
+    }
+    free(table);
+    table = grown;
+    tableMask = size - 1;
+    return 0;
+}
+
+/* Copies the string into the current block, starting a new block
+   when it does not fit. Returns 0 when out of memory. */
+static StrRef append(const char *s, size_t len) {
+    if (blockUsed + len + 1 > BLOCK_SIZE) {
+        if (blockCount == MAX_BLOCKS) return 0;
+        char *b = malloc(BLOCK_SIZE);
+        if (!b) return 0;
+        blocks[blockCount++] = b;
+        blockUsed = 0;
+    }
+
+    StrRef ref = (blockCount - 1) << BLOCK_BITS | blockUsed;
+    char *dst = blocks[blockCount - 1] + blockUsed;
+    memcpy(dst, s, len);
+    dst[len] = '\0';
+    blockUsed += (uint32_t) len + 1;
+    stringBytes += len + 1;
+    return ref;
+}
+
+/* ============ INTERN ============ */
+/* Handle of the string, adding it if new. If memory runs out the
+   string reads back as empty. */
+StrRef arenaInternN(const char *s, size_t len) {
+    if (len > STR_MAX_LEN) len = STR_MAX_LEN;
+    if (len == 0) return 0;
+
+    uint32_t h = hashBytes(s, len);
+    StrRef ref = 0;
+
+    pthread_mutex_lock(&lock);
+    if ((stringCount + 1) * 2 > (size_t) tableMask + 1 && growTable() < 0) {
+        pthread_mutex_unlock(&lock);
+        return 0;
+    }
+
+    uint32_t i = h & tableMask;
+    for (; table[i].ref; i = (i + 1) & tableMask) {
+        if (table[i].hash != h || table[i].len != len) continue;
+        if (memcmp(arenaGet(table[i].ref), s, len) == 0) {
+            ref = table[i].ref;
+            break;
+        }
+    }
+    if (!ref && (ref = append(s, len)) != 0) {
+        table[i].hash = h;
+        table[i].ref = ref;
+        table[i].len = (uint16_t) len;
+        stringCount++;
+    }
+    pthread_mutex_unlock(&lock);
+    return ref;
+}
+
+StrRef arenaIntern(const char *s) {
+    return arenaInternN(s, strlen(s));
+}
+
+void arenaStats(size_t *strings, size_t *bytes) {
+    pthread_mutex_lock(&lock);
+    *strings = stringCount;
+    *bytes = stringBytes;
+    pthread_mutex_unlock(&lock);
+}
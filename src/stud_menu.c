@@ -2,8 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include "student.h"
+#include "department.h"
 #include "stud_menu.h"
 #include "csv_handler.h"
+#include "predictor.h"
 #include "utils.h"
 
 /* ============ STUDENT MENU ============ */
@@ -33,7 +35,8 @@ void studentMenu(long int studentId) {
         printf("3. View Allocation Status\n");
         printf("4. Edit Preferences\n");
         printf("5. Change Password\n");
-        printf("6. Logout\n");
+        printf("6. Predict Allocation (What-If)\n");
+        printf("7. Logout\n");
         printf("----------------------------------------------\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
@@ -44,17 +47,17 @@ void studentMenu(long int studentId) {
                 Applicant currentStudent = a[studentIndex];
                 printf("\n============== YOUR PROFILE ==============\n");
                 printf("Application ID: %d\n", currentStudent.id);
-                printf("Name: %s\n", currentStudent.name);
-                printf("Category: %s\n", currentStudent.category);
+                printf("Name: %s\n", applicantName(&currentStudent));
+                printf("Category: %s\n", categoryCode(currentStudent.category));
                 printf("HS Marks: %d\n", currentStudent.marks);
                 printf("JEE Rank: %d\n", currentStudent.jee_rank);
                 printf("\nDepartment Preferences:\n");
                 for (int i = 0; i < PREF_COUNT; i++) {
-                    printf("  Preference %d: %s\n", i + 1, currentStudent.pref[i]);
+                    printf("  Preference %d: %s\n", i + 1, getDeptCode(currentStudent.pref[i]));
                 }
                 printf("\nDepartment Allotted: %s\n",
-                       strlen(currentStudent.department) > 0 && strcmp(currentStudent.department, "NA") != 0
-                           ? currentStudent.department
+                       currentStudent.department != DEPT_NONE
+                           ? getDeptCode(currentStudent.department)
                            : "Not Allotted");
                 printf("=========================================\n");
                 break;
@@ -93,7 +96,7 @@ void studentMenu(long int studentId) {
                 printf("\n========== ALLOCATION STATUS ==========\n");
                 if (a[studentIndex].allocated) {
                     printf("Status: SELECTED\n");
-                    printf("Allotted Department: %s\n", a[studentIndex].department);
+                    printf("Allotted Department: %s\n", getDeptCode(a[studentIndex].department));
                 } else {
                     printf("Status: NOT ALLOTTED\n");
                     printf("Please wait for merit list generation.\n");
@@ -104,27 +107,22 @@ void studentMenu(long int studentId) {
 
             case 4: { // Edit Preferences
                 printf("\n--- EDIT PREFERENCES ---\n");
-                printf("Available Departments:\n");
-                printf("1. CSE\n");
-                printf("2. IT\n");
-                printf("3. TT\n");
-                printf("4. APM\n\n");
+                listDepartments();
 
-                const char *depts[] = {"CSE", "IT", "TT", "APM"};
                 for (int i = 0; i < PREF_COUNT; i++) {
                     int valid = 0;
                     while (!valid) {
-                        printf("Enter Preference %d (current: %s) [1-4]: ", i + 1, a[studentIndex].pref[i]);
-                        int choice;
-                        scanf("%d", &choice);
+                        printf("Enter Preference %d (current: %s) [number or code]: ", i + 1,
+                               getDeptCode(a[studentIndex].pref[i]));
+                        int dept = readDepartmentChoice();
                         getchar();
 
                         // Validate department choice
-                        if (choice >= 1 && choice <= 4) {
-                            strcpy(a[studentIndex].pref[i], depts[choice - 1]);
+                        if (dept >= 0) {
+                            a[studentIndex].pref[i] = (uint8_t) dept;
                             valid = 1;
                         } else {
-                            printError("Invalid! Enter 1 for CSE, 2 for IT, 3 for TT, or 4 for APM.");
+                            printError("Invalid! Enter a department number or code from the list.");
                         }
                     }
                 }
@@ -136,13 +134,13 @@ void studentMenu(long int studentId) {
 
             case 5: { // Change Password
                 printf("\n--- CHANGE PASSWORD ---\n");
-                char oldPass[20], newPass[20];
+                char oldPass[PASSWORD_LEN], newPass[PASSWORD_LEN];
 
                 printf("Enter current password: ");
                 scanf("%19s", oldPass);
                 getchar();
 
-                if (strcmp(oldPass, a[studentIndex].password) == 0) {
+                if (strcmp(oldPass, applicantPassword(&a[studentIndex])) == 0) {
                     int validPass = 0;
                     while (!validPass) {
                         printf("Enter new password (3-9 characters): ");
@@ -150,7 +148,7 @@ void studentMenu(long int studentId) {
                         getchar();
 
                         if (strlen(newPass) >= 3 && strlen(newPass) <= 9) {
-                            strcpy(a[studentIndex].password, newPass);
+                            a[studentIndex].password = arenaIntern(newPass);
                             validPass = 1;
                         } else {
                             printWarning("Password must be 3-9 characters!");
@@ -165,7 +163,71 @@ void studentMenu(long int studentId) {
                 break;
             }
 
-            case 6: {
+            case 6: { // Predict Allocation
+                Applicant self = a[studentIndex];
+                int rank, marks, cat;
+                char code[8], usePrefs;
+                uint8_t pref[PREF_COUNT];
+
+                printf("\n--- PREDICT ALLOCATION ---\n");
+                printf("JEE Rank (current: %d): ", self.jee_rank);
+                scanf("%d", &rank);
+                printf("HS Marks (current: %d): ", self.marks);
+                scanf("%d", &marks);
+                printf("Category GEN/OBC/SC/ST (current: %s): ", categoryCode(self.category));
+                scanf("%7s", code);
+                printf("Use your current preferences? (y/n): ");
+                scanf(" %c", &usePrefs);
+                getchar();
+
+                cat = parseCategory(code);
+                if (rank <= 0 || marks < 0 || cat < 0) {
+                    printError("Invalid rank, marks or category.");
+                    break;
+                }
+
+                memcpy(pref, self.pref, sizeof(pref));
+                if (usePrefs == 'n' || usePrefs == 'N') {
+                    listDepartments();
+                    for (int i = 0; i < PREF_COUNT; i++) {
+                        printf("Preference %d [number or code]: ", i + 1);
+                        int dept = readDepartmentChoice();
+                        getchar();
+                        pref[i] = dept >= 0 ? (uint8_t) dept : DEPT_NONE;
+                    }
+                }
+
+                // Index the saved allocation; the allocator is not rerun
+                Predictor p;
+                Prediction pr;
+                if (predictorBuild(&p, a, n) != 0) {
+                    printError("Out of memory.");
+                    break;
+                }
+                predictAllocation(&p, rank, marks, pref, &self, &pr);
+
+                printf("\n========== PREDICTED ALLOCATION ==========\n");
+                printf("Merit Position: %d out of %d\n", pr.meritPosition, n);
+                for (int i = 0; i < PREF_COUNT; i++) {
+                    int d = pref[i];
+                    char catClose[16] = "-";
+                    if (d >= p.programs) continue;
+                    if (p.closeRank[d][cat] > 0) snprintf(catClose, sizeof(catClose), "%d", p.closeRank[d][cat]);
+                    printf("  Preference %d: %-4s  %2d/%d seats to applicants ahead, closing rank %d (%s: %s)\n",
+                           i + 1, getDeptCode(d), pr.ahead[i], p.seats[d], p.closeRank[d][CAT_COUNT],
+                           categoryCode(cat), catClose);
+                }
+                if (pr.department != DEPT_NONE)
+                    printf("Likely Department: %s (preference %d)\n", getDeptCode(pr.department), pr.preference);
+                else
+                    printf("Likely Department: Not Allotted (waiting list)\n");
+                printf("Based on the last merit list; generate it again for changes since.\n");
+                printf("==========================================\n");
+                predictorFree(&p);
+                break;
+            }
+
+            case 7: {
                 printf("Logging out from student menu...\n");
                 return;
             }
@@ -0,0 +1,20 @@
+#include <string.h>
+#include "student.h"
+
+static const char *categories[CAT_COUNT] = {"GEN", "OBC", "SC", "ST"};
+
+/* ============ CATEGORY CODE ============ */
+const char *categoryCode(int category) {
+    if (category >= 0 && category < CAT_COUNT)
+        return categories[category];
+    return "NA";
+}
+
+/* ============ PARSE CATEGORY CODE ============ */
+/* Category for "GEN", "OBC", ... or -1 if unknown */
+int parseCategory(const char *code) {
+    for (int i = 0; i < CAT_COUNT; i++)
+        if (strcmp(code, categories[i]) == 0)
+            return i;
+    return -1;
+}
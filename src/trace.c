@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include "trace.h"
+
+#define SUMMARY_NAMES 64
+
+typedef struct {
+    const char *name;
+    uint64_t startUs, durUs;
+    long long n;
+    int tid;
+} TraceEvent;
+
+/* Slot for ring position p is complete when seq == p + 1; a writer
+   clears seq first, so a reader that sees the same seq before and
+   after copying got an untorn event. */
+typedef struct {
+    _Atomic unsigned long seq;
+    TraceEvent ev;
+} TraceSlot;
+
+static TraceSlot ring[TRACE_CAPACITY];
+static atomic_ulong nextSlot;
+static atomic_int enabled;
+static atomic_int nextTid;
+static _Thread_local int threadId;
+
+static uint64_t nowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+
+void traceEnable(int on) {
+    atomic_store(&enabled, on);
+}
+
+int traceEnabled(void) {
+    return atomic_load_explicit(&enabled, memory_order_relaxed);
+}
+
+/* ============ RECORD ============ */
+TraceSpan traceBegin(const char *name) {
+    TraceSpan s = { name, nowUs(), -1 };
+    return s;
+}
+
+double traceEnd(TraceSpan *span) {
+    uint64_t end = nowUs();
+    uint64_t dur = end - span->startUs;
+
+    if (traceEnabled()) {
+        if (threadId == 0)
+            threadId = atomic_fetch_add(&nextTid, 1) + 1;
+
+        unsigned long pos = atomic_fetch_add(&nextSlot, 1);
+        TraceSlot *slot = &ring[pos & (TRACE_CAPACITY - 1)];
+        atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        slot->ev = (TraceEvent) { span->name, span->startUs, dur, span->n, threadId };
+        atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    }
+    return dur / 1000.0;
+}
+
+unsigned long traceMark(void) {
+    return atomic_load(&nextSlot);
+}
+
+/* ============ SNAPSHOT ============ */
+/* Copies the complete spans recorded since from; returns the count or
+   -1. Spans overwritten or still being written are skipped. */
+static int collect(unsigned long from, TraceEvent **out) {
+    unsigned long end = atomic_load(&nextSlot);
+    if (end - from > TRACE_CAPACITY) from = end - TRACE_CAPACITY;
+
+    TraceEvent *ev = malloc((end > from ? end - from : 1) * sizeof(TraceEvent));
+    if (!ev) return -1;
+
+    int n = 0;
+    for (unsigned long p = from; p < end; p++) {
+        TraceSlot *slot = &ring[p & (TRACE_CAPACITY - 1)];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != p + 1) continue;
+        ev[n] = slot->ev;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) == p + 1) n++;
+    }
+    *out = ev;
+    return n;
+}
+
+/* ============ CHROME TRACE-EVENT JSON ============ */
+/* Complete ("X") events; timestamps are relative to the first span */
+int traceWriteChrome(const char *path, unsigned long from) {
+    TraceEvent *ev;
+    int n = collect(from, &ev);
+    if (n < 0) return -1;
+
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        free(ev);
+        return -1;
+    }
+
+    uint64_t base = 0;
+    for (int i = 0; i < n; i++)
+        if (i == 0 || ev[i].startUs < base) base = ev[i].startUs;
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"merit\",\"ph\":\"X\",\"ts\":%llu,"
+                "\"dur\":%llu,\"pid\":%d,\"tid\":%d",
+                i ? "," : "", ev[i].name, (unsigned long long) (ev[i].startUs - base),
+                (unsigned long long) ev[i].durUs, (int) getpid(), ev[i].tid);
+        if (ev[i].n >= 0)
+            fprintf(fp, ",\"args\":{\"n\":%lld}", ev[i].n);
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "\n]}\n");
+    free(ev);
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/* ============ SUMMARY TABLE ============ */
+/* One row per span name in first-seen order. Wall time runs from the
+   first start to the last end, so for spans run on several threads
+   it is less than the summed time. */
+void tracePrintSummary(FILE *fp, unsigned long from) {
+    struct {
+        const char *name;
+        int count;
+        uint64_t first, last, sum, max;
+        unsigned long long tids;    /* bitmask of thread ids mod 64 */
+    } rows[SUMMARY_NAMES];
+    int nrows = 0;
+    TraceEvent *ev;
+    int n = collect(from, &ev);
+    if (n < 0) return;
+
+    for (int i = 0; i < n; i++) {
+        int r = 0;
+        while (r < nrows && strcmp(rows[r].name, ev[i].name) != 0) r++;
+        if (r == nrows) {
+            if (nrows == SUMMARY_NAMES) continue;
+            memset(&rows[nrows], 0, sizeof(rows[0]));
+            rows[nrows].name = ev[i].name;
+            rows[nrows].first = ev[i].startUs;
+            nrows++;
+        }
+        uint64_t end = ev[i].startUs + ev[i].durUs;
+        rows[r].count++;
+        rows[r].sum += ev[i].durUs;
+        if (ev[i].durUs > rows[r].max) rows[r].max = ev[i].durUs;
+        if (ev[i].startUs < rows[r].first) rows[r].first = ev[i].startUs;
+        if (end > rows[r].last) rows[r].last = end;
+        rows[r].tids |= 1ULL << (ev[i].tid & 63);
+    }
+    free(ev);
+
+    fprintf(fp, "%-24s %6s %7s %11s %11s %11s\n",
+            "span", "count", "threads", "wall ms", "sum ms", "max ms");
+    for (int r = 0; r < nrows; r++)
+        fprintf(fp, "%-24s %6d %7d %11.3f %11.3f %11.3f\n", rows[r].name, rows[r].count,
+                __builtin_popcountll(rows[r].tids), (rows[r].last - rows[r].first) / 1000.0,
+                rows[r].sum / 1000.0, rows[r].max / 1000.0);
+}
@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "student.h"
+#include "department.h"
+#include "sorting.h"
+#include "merit_engine.h"
+#include "bench_data.h"
+
+/* ============================================================
+   SORT AND ALLOCATION BENCHMARK
+   Times every sort engine and the seat allocation pass over a grid
+   of sizes and generator profiles, and prints one JSON document.
+   Each case runs in a forked child so peak RSS is per case and a
+   crash or timeout only loses that case.
+   ============================================================ */
+
+#define MAX_LIST 16
+
+typedef enum {
+    CASE_OK,
+    CASE_SKIPPED,
+    CASE_TIMEOUT,
+    CASE_CRASHED,
+    CASE_FAILED
+} CaseStatus;
+
+static const char *statusNames[] = { "ok", "skipped", "timeout", "crashed", "failed" };
+
+typedef struct {
+    int status;
+    double ms;          /* best of the timed repeats */
+    SortStats stats;
+    long peakRssKb;
+    int sorted;
+    int allocated;
+} CaseResult;
+
+typedef struct {
+    const char *sizes[MAX_LIST];
+    const char *profiles[MAX_LIST];
+    const char *engines[MAX_LIST];
+    int nsizes, nprofiles, nengines;
+    int threads;
+    int repeat;
+    int maxQuadratic;
+    int timeout;
+    unsigned long long seed;
+} BenchOptions;
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* Split a comma list in place; returns the item count */
+static int splitList(char *s, const char *items[]) {
+    int n = 0;
+    for (char *tok = strtok(s, ","); tok && n < MAX_LIST; tok = strtok(NULL, ","))
+        items[n++] = tok;
+    return n;
+}
+
+static int isSorted(Applicant a[], int n) {
+    for (int i = 1; i < n; i++)
+        if (isBetter(a[i], a[i - 1]))
+            return 0;
+    return 1;
+}
+
+/* Cases whose worst case is quadratic are only run up to maxQuadratic */
+static int isQuadratic(SortAlgorithm algo, const char *profile) {
+    if (algo == SORT_SELECTION || algo == SORT_INSERTION)
+        return 1;
+    // Last-element pivot: sorted input and heavy ties degenerate
+    return algo == SORT_QUICK &&
+           (strcmp(profile, "presorted") == 0 ||
+            strcmp(profile, "adversarial-ties") == 0);
+}
+
+/* ============ ONE CASE (runs in the child) ============ */
+static void runCase(const BenchOptions *o, const char *profile, int n,
+                    SortAlgorithm algo, CaseResult *r) {
+    Applicant *a = malloc((size_t) n * sizeof(Applicant));
+    int seats[MAX_PROGRAMS];
+
+    r->ms = -1;
+    if (!a || bench_generate(a, n, profile, o->seed) != 0) {
+        r->status = CASE_FAILED;
+        free(a);
+        return;
+    }
+
+    for (int rep = 0; rep < o->repeat; rep++) {
+        if (rep > 0)
+            bench_generate(a, n, profile, o->seed);
+
+        double start, ms;
+        if (algo) {
+            start = nowMs();
+            int rc = sortApplicants(a, n, algo, o->threads);
+            ms = nowMs() - start;
+            if (rc != 0) {
+                r->status = CASE_FAILED;
+                free(a);
+                return;
+            }
+        } else {
+            ApplicantTable t;
+            if (sortApplicants(a, n, SORT_MERGE, o->threads) != 0 ||
+                tableFromRows(&t, a, n) != 0) {
+                r->status = CASE_FAILED;
+                free(a);
+                return;
+            }
+            start = nowMs();
+            r->allocated = allocateTableSeats(&t, seats, NULL, NULL);
+            ms = nowMs() - start;
+            tableToRows(&t, a);
+            tableFree(&t);
+        }
+        if (r->ms < 0 || ms < r->ms)
+            r->ms = ms;
+    }
+    r->sorted = isSorted(a, n);
+
+    // Counted run kept out of the timings
+    if (algo) {
+        bench_generate(a, n, profile, o->seed);
+        sortStatsEnable(1);
+        sortStatsReset();
+        sortApplicants(a, n, algo, o->threads);
+        r->stats = sortStatsGet();
+        sortStatsEnable(0);
+    }
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    r->peakRssKb = ru.ru_maxrss;
+    r->status = CASE_OK;
+    free(a);
+}
+
+static void forkCase(const BenchOptions *o, const char *profile, int n,
+                     SortAlgorithm algo, CaseResult *r) {
+    int fds[2];
+
+    memset(r, 0, sizeof(*r));
+    r->status = CASE_FAILED;
+    if (pipe(fds) != 0) return;
+
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(o->timeout);
+        runCase(o, profile, n, algo, r);
+        ssize_t w = write(fds[1], r, sizeof(*r));
+        _exit(w == (ssize_t) sizeof(*r) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t got = read(fds[0], r, sizeof(*r));
+    close(fds[0]);
+
+    int wstatus;
+    waitpid(pid, &wstatus, 0);
+    if (WIFSIGNALED(wstatus)) {
+        memset(r, 0, sizeof(*r));
+        r->status = WTERMSIG(wstatus) == SIGALRM ? CASE_TIMEOUT : CASE_CRASHED;
+    } else if (got != (ssize_t) sizeof(*r)) {
+        memset(r, 0, sizeof(*r));
+        r->status = CASE_FAILED;
+    }
+}
+
+/* ============ OUTPUT ============ */
+static void printCase(FILE *out, int first, const char *profile, int n,
+                      const char *engine, const CaseResult *r) {
+    fprintf(out, "%s\n    {\"profile\":\"%s\",\"n\":%d,\"engine\":\"%s\",\"status\":\"%s\"",
+            first ? "" : ",", profile, n, engine, statusNames[r->status]);
+    if (r->status == CASE_OK) {
+        fprintf(out, ",\"total_ms\":%.3f,\"ns_per_elem\":%.2f", r->ms, r->ms * 1e6 / n);
+        if (strcmp(engine, "allocate") == 0)
+            fprintf(out, ",\"allocated\":%d", r->allocated);
+        else
+            fprintf(out, ",\"comparisons\":%llu,\"moves\":%llu,\"bytes_copied\":%llu,"
+                    "\"allocations\":%llu,\"bytes_allocated\":%llu",
+                    r->stats.comparisons, r->stats.moves, r->stats.bytesCopied,
+                    r->stats.allocations, r->stats.bytesAllocated);
+        fprintf(out, ",\"peak_rss_kb\":%ld,\"sorted\":%s",
+                r->peakRssKb, r->sorted ? "true" : "false");
+    }
+    fprintf(out, "}");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [--sizes=N,...] [--profiles=NAME,...] [--engines=NAME,...]\n"
+        "          [--threads=N] [--repeat=N] [--max-quadratic=N] [--timeout=SEC]\n"
+        "          [--seed=N] [--out=FILE]\n"
+        "  profiles: %s\n"
+        "  engines:  selection|insertion|merge|quick|radix|allocate\n",
+        prog, bench_profile_names());
+}
+
+int main(int argc, char *argv[]) {
+    BenchOptions o;
+    char sizes[256] = "1000,10000,100000,1000000,10000000";
+    char profiles[256] = "uniform,realistic-skew,adversarial-ties,presorted";
+    char engines[256] = "selection,insertion,merge,quick,radix,allocate";
+    const char *outPath = NULL;
+
+    memset(&o, 0, sizeof(o));
+    o.threads = 1;
+    o.repeat = 1;
+    o.maxQuadratic = 50000;
+    o.timeout = 300;
+    o.seed = 42;
+
+    if (programsInit() < 0) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = strchr(arg, '=');
+        int bad = val == NULL;
+        if (val) val++;
+
+        if (bad) ;
+        else if (strncmp(arg, "--sizes=", 8) == 0)
+            snprintf(sizes, sizeof(sizes), "%s", val);
+        else if (strncmp(arg, "--profiles=", 11) == 0)
+            snprintf(profiles, sizeof(profiles), "%s", val);
+        else if (strncmp(arg, "--engines=", 10) == 0)
+            snprintf(engines, sizeof(engines), "%s", val);
+        else if (strncmp(arg, "--threads=", 10) == 0)
+            bad = (o.threads = atoi(val)) < 1;
+        else if (strncmp(arg, "--repeat=", 9) == 0)
+            bad = (o.repeat = atoi(val)) < 1;
+        else if (strncmp(arg, "--max-quadratic=", 16) == 0)
+            bad = (o.maxQuadratic = atoi(val)) < 0;
+        else if (strncmp(arg, "--timeout=", 10) == 0)
+            bad = (o.timeout = atoi(val)) < 1;
+        else if (strncmp(arg, "--seed=", 7) == 0)
+            o.seed = strtoull(val, NULL, 10);
+        else if (strncmp(arg, "--out=", 6) == 0)
+            outPath = val;
+        else
+            bad = 1;
+
+        if (bad) {
+            fprintf(stderr, "Invalid argument: %s\n", arg);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    o.nsizes = splitList(sizes, o.sizes);
+    o.nprofiles = splitList(profiles, o.profiles);
+    o.nengines = splitList(engines, o.engines);
+
+    for (int e = 0; e < o.nengines; e++) {
+        if (strcmp(o.engines[e], "allocate") != 0 && !parseSortAlgorithm(o.engines[e])) {
+            fprintf(stderr, "Unknown engine: %s\n", o.engines[e]);
+            return 2;
+        }
+    }
+    for (int p = 0; p < o.nprofiles; p++) {
+        if (bench_generate(NULL, 0, o.profiles[p], o.seed) != 0) {
+            fprintf(stderr, "Unknown profile: %s\n", o.profiles[p]);
+            return 2;
+        }
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Unable to create %s\n", outPath);
+        return 1;
+    }
+
+    fprintf(out, "{\"benchmark\":\"sort\",\"timestamp\":%ld,\"seed\":%llu,"
+            "\"threads\":%d,\"repeat\":%d,\"record_bytes\":%zu,\"results\":[",
+            (long) time(NULL), o.seed, o.threads, o.repeat, sizeof(Applicant));
+
+    int first = 1;
+    for (int s = 0; s < o.nsizes; s++) {
+        int n = atoi(o.sizes[s]);
+        if (n < 1) continue;
+
+        for (int p = 0; p < o.nprofiles; p++) {
+            for (int e = 0; e < o.nengines; e++) {
+                const char *engine = o.engines[e];
+                SortAlgorithm algo = parseSortAlgorithm(engine);
+                CaseResult r;
+
+                if (algo && n > o.maxQuadratic && isQuadratic(algo, o.profiles[p])) {
+                    memset(&r, 0, sizeof(r));
+                    r.status = CASE_SKIPPED;
+                } else {
+                    fprintf(stderr, "%-16s n=%-9d %-10s ", o.profiles[p], n, engine);
+                    forkCase(&o, o.profiles[p], n, algo, &r);
+                    if (r.status == CASE_OK)
+                        fprintf(stderr, "%10.3f ms %8.2f ns/elem\n", r.ms, r.ms * 1e6 / n);
+                    else
+                        fprintf(stderr, "%s\n", statusNames[r.status]);
+                }
+
+                printCase(out, first, o.profiles[p], n, engine, &r);
+                first = 0;
+                fflush(out);
+            }
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
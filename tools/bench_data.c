@@ -0,0 +1,23 @@
+#include "../headers/data_generator.h"
+#include "bench_data.h"
+
+/* Generated text is interned, so records are complete applicants */
+int bench_generate(Applicant *records, int n, const char *profile, uint64_t seed) {
+    GenProfile p;
+
+    if (gen_profile_lookup(profile, &p) != 0)
+        return -1;
+
+    for (int i = 0; i < n; i++) {
+        GenRow r;
+        generate_row(&r, &p, seed, (uint64_t) i, (uint64_t) n);
+        records[i] = r.a;
+        records[i].name = arenaIntern(r.name);
+        records[i].password = arenaIntern(r.password);
+    }
+    return 0;
+}
+
+const char *bench_profile_names(void) {
+    return gen_profile_names();
+}
@@ -0,0 +1,12 @@
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+#include <stdint.h>
+#include "../headers/student.h"
+
+/* Fill `records` with n generator rows for the named profile.
+   Returns 0, or -1 for an unknown profile. */
+int bench_generate(Applicant *records, int n, const char *profile, uint64_t seed);
+const char *bench_profile_names(void);
+
+#endif
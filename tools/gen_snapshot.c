@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <string.h>
+#include "snapshot.h"
+#include "gen_snapshot.h"
+
+size_t gen_snapshot_chunk_bound(int rows) {
+    return SNAPSHOT_CHUNK_BOUND(rows);
+}
+
+int gen_snapshot_header(FILE *fp, uint64_t count) {
+    return writeSnapshotHeader(fp, count);
+}
+
+/* Lays out a chunk of exactly `rows` records at out */
+void gen_chunk_begin(GenChunk *c, char *out, int rows) {
+    c->out = out;
+    c->records = (Applicant *) (out + sizeof(SnapshotChunk));
+    c->strings = (char *) (c->records + rows);
+    c->rows = (uint32_t) rows;
+    c->added = 0;
+    c->stringBytes = 0;
+}
+
+static uint32_t add_string(GenChunk *c, const char *s) {
+    uint32_t off = c->stringBytes;
+    size_t n = strlen(s) + 1;
+    memcpy(c->strings + off, s, n);
+    c->stringBytes += (uint32_t) n;
+    return off;
+}
+
+void gen_chunk_add(GenChunk *c, const GenRow *r) {
+    Applicant *a = &c->records[c->added++];
+    *a = r->a;
+    a->name = add_string(c, r->name);
+    a->password = add_string(c, r->password);
+}
+
+/* Writes the chunk header; returns the chunk's size in bytes */
+size_t gen_chunk_end(GenChunk *c) {
+    SnapshotChunk h = { c->added, c->stringBytes };
+    memcpy(c->out, &h, sizeof(h));
+    return (size_t) (c->strings - c->out) + c->stringBytes;
+}
@@ -0,0 +1,31 @@
+#ifndef GEN_SNAPSHOT_H
+#define GEN_SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../headers/data_generator.h"
+
+/* ============================================================
+   SNAPSHOT OUTPUT FOR THE DATA GENERATOR
+   Each block of generated rows becomes one snapshot chunk, packed
+   into memory so workers can build blocks in parallel. The rows'
+   text goes into the chunk's own string section, so nothing is
+   interned.
+   ============================================================ */
+
+typedef struct {
+    char *out;
+    Applicant *records;
+    char *strings;
+    uint32_t rows;
+    uint32_t added;
+    uint32_t stringBytes;
+} GenChunk;
+
+size_t gen_snapshot_chunk_bound(int rows);
+int gen_snapshot_header(FILE *fp, uint64_t count);
+void gen_chunk_begin(GenChunk *c, char *out, int rows);
+void gen_chunk_add(GenChunk *c, const GenRow *r);
+size_t gen_chunk_end(GenChunk *c);
+
+#endif
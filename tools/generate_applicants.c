@@ -1,31 +1,311 @@
 #include "../headers/data_generator.h"
+#include "../headers/department.h"
+#include "gen_snapshot.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 
-#define TOTAL_APPLICANTS 100
+#define DEFAULT_ROWS 100
+#define BLOCK_ROWS 16384
+#define OUT_BUFFER (8 * 1024 * 1024)
 
-int main(void) {
-    srand((unsigned)time(NULL));
+/* ============================================================
+   PARALLEL GENERATION PIPELINE
+   Rows are cut into fixed blocks. Workers claim blocks in order and
+   format them into a ring of 2 x threads buffers; the main thread
+   writes the buffers out strictly in block order. Every row draws
+   from its own RNG stream (seed, row), so the output depends only
+   on the seed and row count, never on the thread count.
+   ============================================================ */
 
-    FILE *fp = fopen("applicants_full.csv", "w");
+typedef struct {
+    char *buf;
+    size_t len;
+    long long block;    /* -1 when free */
+    int ready;
+} Slot;
+
+typedef struct {
+    unsigned long long rows;
+    unsigned long long seed;
+    GenProfile profile;
+    int binary;
+
+    long long blocks;
+    long long nextBlock;
+    Slot *slots;
+    int nslots;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} Pipeline;
+
+static size_t fill_block(Pipeline *p, long long block, char *out) {
+    unsigned long long first = (unsigned long long) block * BLOCK_ROWS;
+    unsigned long long last = first + BLOCK_ROWS;
+    if (last > p->rows) last = p->rows;
+
+    if (p->binary) {
+        /* One snapshot chunk per block */
+        GenChunk c;
+        gen_chunk_begin(&c, out, (int) (last - first));
+        for (unsigned long long row = first; row < last; row++) {
+            GenRow r;
+            generate_row(&r, &p->profile, p->seed, row, p->rows);
+            gen_chunk_add(&c, &r);
+        }
+        return gen_chunk_end(&c);
+    }
+
+    char *o = out;
+    for (unsigned long long row = first; row < last; row++) {
+        GenRow r;
+        generate_row(&r, &p->profile, p->seed, row, p->rows);
+        o += format_applicant_csv(o, &r);
+    }
+    return (size_t) (o - out);
+}
+
+static void *worker(void *arg) {
+    Pipeline *p = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&p->lock);
+        if (p->nextBlock >= p->blocks) {
+            pthread_mutex_unlock(&p->lock);
+            return NULL;
+        }
+        long long block = p->nextBlock++;
+        Slot *s = &p->slots[block % p->nslots];
+        while (s->block != -1)
+            pthread_cond_wait(&p->changed, &p->lock);
+        s->block = block;
+        s->ready = 0;
+        pthread_mutex_unlock(&p->lock);
+
+        s->len = fill_block(p, block, s->buf);
+
+        pthread_mutex_lock(&p->lock);
+        s->ready = 1;
+        pthread_cond_broadcast(&p->changed);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+static int write_blocks(Pipeline *p, FILE *fp) {
+    int ok = 1;
+
+    for (long long block = 0; block < p->blocks; block++) {
+        Slot *s = &p->slots[block % p->nslots];
+
+        pthread_mutex_lock(&p->lock);
+        while (s->block != block || !s->ready)
+            pthread_cond_wait(&p->changed, &p->lock);
+        pthread_mutex_unlock(&p->lock);
+
+        if (ok && fwrite(s->buf, 1, s->len, fp) != s->len)
+            ok = 0;
+
+        pthread_mutex_lock(&p->lock);
+        s->block = -1;
+        pthread_cond_broadcast(&p->changed);
+        pthread_mutex_unlock(&p->lock);
+    }
+    return ok;
+}
+
+/* ============ ARGUMENTS ============ */
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [--rows=N] [--seed=N] [--threads=N] [--out=FILE] "
+        "[--format=csv|bin]\n"
+        "       [--profile=NAME] [--PARAM=VALUE ...]\n"
+        "  --rows     applicants to generate (default %d)\n"
+        "  --seed     RNG seed; same seed and rows give the same file\n"
+        "             (default: current time, printed on exit)\n"
+        "  --threads  worker threads (default: online CPUs)\n"
+        "  --out      output path, '-' for stdout "
+        "(default applicants_full.csv)\n"
+        "  --format   csv, or bin for an admission_system snapshot\n"
+        "  --profile  %s (default uniform)\n"
+        "Profile parameters (override the profile's values):\n"
+        "  --rank-range=N   ranks drawn from 1..N\n"
+        "  --ties=N         collapse ranks onto N distinct values (0 = off)\n"
+        "  --correlation=X  0..1, how closely marks follow rank\n"
+        "  --mark-levels=N  round marks onto N values, 2..101 (0 = off)\n"
+        "  --skew=X         department popularity exponent (0 = even)\n"
+        "  --min-prefs=N    shortest preference list, 1..4 (rest are NA)\n"
+        "  --presorted=0|1  ranks ascend with row order\n",
+        prog, DEFAULT_ROWS, gen_profile_names());
+}
+
+static int parse_count(const char *s, unsigned long long *out) {
+    char *end;
+    if (*s < '0' || *s > '9') return -1;
+    *out = strtoull(s, &end, 10);
+    return *end == '\0' ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long long rows = DEFAULT_ROWS;
+    unsigned long long seed = (unsigned long long) time(NULL);
+    unsigned long long threads = 0;
+    const char *out = "applicants_full.csv";
+    int binary = 0;
+    const char *profileName = "uniform";
+    int overrides[64], noverrides = 0;
+
+    /* Preferences are drawn over the programs in the registry */
+    if (programsInit() < 0) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *eq = strchr(arg, '=');
+        const char *val = eq ? eq + 1 : NULL;
+        int bad = (val == NULL);
+
+        if (!bad && strncmp(arg, "--rows=", 7) == 0)
+            bad = parse_count(val, &rows) != 0;
+        else if (!bad && strncmp(arg, "--seed=", 7) == 0)
+            bad = parse_count(val, &seed) != 0;
+        else if (!bad && strncmp(arg, "--threads=", 10) == 0)
+            bad = parse_count(val, &threads) != 0 || threads == 0;
+        else if (!bad && strncmp(arg, "--out=", 6) == 0)
+            out = val;
+        else if (!bad && strcmp(arg, "--format=csv") == 0)
+            binary = 0;
+        else if (!bad && strcmp(arg, "--format=bin") == 0)
+            binary = 1;
+        else if (!bad && strncmp(arg, "--profile=", 10) == 0)
+            profileName = val;
+        else if (!bad && strncmp(arg, "--", 2) == 0 && noverrides < 64)
+            overrides[noverrides++] = i;   /* applied once the profile is known */
+        else
+            bad = 1;
+
+        if (bad) {
+            fprintf(stderr, "Invalid argument: %s\n", arg);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    GenProfile profile;
+    if (gen_profile_lookup(profileName, &profile) != 0) {
+        fprintf(stderr, "Unknown profile: %s\n", profileName);
+        usage(argv[0]);
+        return 2;
+    }
+    for (int k = 0; k < noverrides; k++) {
+        const char *arg = argv[overrides[k]];
+        const char *eq = strchr(arg, '=');
+        char key[32];
+
+        snprintf(key, sizeof(key), "%.*s", (int) (eq - arg - 2), arg + 2);
+        if (gen_profile_set(&profile, key, eq + 1) != 0) {
+            fprintf(stderr, "Invalid argument: %s\n", arg);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    /* IDs are 1000 + a permutation index and must fit in an int */
+    if (rows > 0x7FFFFFFFULL - 1000) {
+        fprintf(stderr, "--rows is too large (max %llu)\n",
+                0x7FFFFFFFULL - 1000);
+        return 2;
+    }
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned long long) cpus : 1;
+    }
+    if (threads > 256) threads = 256;
+
+    FILE *fp = strcmp(out, "-") == 0 ? stdout : fopen(out, binary ? "wb" : "w");
     if (!fp) {
-        perror("Unable to create applicants_full.csv");
+        fprintf(stderr, "Unable to create %s\n", out);
         return 1;
     }
+    setvbuf(fp, NULL, _IOFBF, OUT_BUFFER);
 
-    fprintf(fp,
-        "ID,Name,Password,Category,Pref1,Pref2,Pref3,Pref4,"
-        "Department,Marks,JEE_Rank,Allocated\n");
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.rows = rows;
+    p.seed = seed;
+    p.profile = profile;
+    p.binary = binary;
+    p.blocks = (long long) ((rows + BLOCK_ROWS - 1) / BLOCK_ROWS);
+    p.nslots = (int) threads * 2;
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.changed, NULL);
 
-    for (int i = 0; i < TOTAL_APPLICANTS; i++) {
-        Applicant a;
-        generate_applicant(&a);
-        write_applicant_csv(fp, &a);
+    size_t blockBytes = binary ? gen_snapshot_chunk_bound(BLOCK_ROWS)
+                               : (size_t) BLOCK_ROWS * MAX_CSV_LINE;
+    p.slots = calloc(p.nslots, sizeof(Slot));
+    int ok = p.slots != NULL;
+    for (int i = 0; ok && i < p.nslots; i++) {
+        p.slots[i].block = -1;
+        p.slots[i].buf = malloc(blockBytes);
+        ok = p.slots[i].buf != NULL;
+    }
+    if (!ok) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
     }
 
-    fclose(fp);
+    if (binary)
+        ok = gen_snapshot_header(fp, rows) == 0;
+    else
+        ok = fputs("ID,Name,Password,Category,Pref1,Pref2,Pref3,Pref4,"
+                   "Department,Marks,JEE_Rank,Allocated\n", fp) >= 0;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    pthread_t *tids = malloc(threads * sizeof(pthread_t));
+    unsigned long long started = 0;
+    while (tids && started < threads &&
+           pthread_create(&tids[started], NULL, worker, &p) == 0)
+        started++;
+
+    if (started == 0) {
+        /* No workers: run the pipeline inline, one block at a time */
+        p.nslots = 1;
+        for (long long b = 0; b < p.blocks && ok; b++) {
+            size_t len = fill_block(&p, b, p.slots[0].buf);
+            ok = fwrite(p.slots[0].buf, 1, len, fp) == len;
+        }
+    } else {
+        ok = write_blocks(&p, fp) && ok;
+        for (unsigned long long i = 0; i < started; i++)
+            pthread_join(tids[i], NULL);
+    }
+
+    if (fp == stdout)
+        ok = fflush(fp) == 0 && ok;
+    else
+        ok = fclose(fp) == 0 && ok;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    for (int i = 0; i < (int) threads * 2; i++)
+        free(p.slots[i].buf);
+    free(p.slots);
+    free(tids);
+    pthread_mutex_destroy(&p.lock);
+    pthread_cond_destroy(&p.changed);
+
+    if (!ok) {
+        fprintf(stderr, "Write to %s failed\n", out);
+        return 1;
+    }
 
-    printf("applicants_full.csv generated successfully\n");
+    fprintf(stderr, "%s generated: %llu rows, profile %s, seed %llu, "
+            "%llu threads, %.2fs\n", out, rows, profile.name, seed,
+            started ? started : 1, secs);
     return 0;
 }
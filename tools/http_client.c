@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "http_client.h"
+
+static int open_socket(const char *host, int port) {
+    struct addrinfo hints, *res;
+    char service[16];
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(service, sizeof(service), "%d", port);
+    if (getaddrinfo(host, service, &hints, &res) != 0)
+        return -1;
+
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+int http_connect(HttpConn *c, const char *host, int port) {
+    if (!c->buf) {
+        c->cap = 64 * 1024;
+        c->buf = malloc(c->cap);
+        if (!c->buf) return -1;
+    }
+    snprintf(c->host, sizeof(c->host), "%s", host);
+    c->port = port;
+    c->len = 0;
+    c->fd = open_socket(host, port);
+    return c->fd >= 0 ? 0 : -1;
+}
+
+void http_close(HttpConn *c) {
+    if (c->fd >= 0) close(c->fd);
+    c->fd = -1;
+    free(c->buf);
+    c->buf = NULL;
+    c->cap = c->len = 0;
+}
+
+static int send_all(int fd, const char *p, size_t n) {
+    while (n > 0) {
+        ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+        if (w <= 0) return -1;
+        p += w;
+        n -= (size_t) w;
+    }
+    return 0;
+}
+
+/* Read more bytes into the buffer, growing it if full */
+static int fill(HttpConn *c) {
+    if (c->len == c->cap) {
+        char *grown = realloc(c->buf, c->cap * 2);
+        if (!grown) return -1;
+        c->buf = grown;
+        c->cap *= 2;
+    }
+    ssize_t r = recv(c->fd, c->buf + c->len, c->cap - c->len, 0);
+    if (r <= 0) return -1;
+    c->len += (size_t) r;
+    return 0;
+}
+
+static const char *find_header(const char *head, size_t len, const char *name) {
+    size_t n = strlen(name);
+    for (const char *p = head; p + n < head + len; p++) {
+        if ((p == head || p[-1] == '\n') && strncasecmp(p, name, n) == 0 && p[n] == ':')
+            return p + n + 1;
+    }
+    return NULL;
+}
+
+/* Send one request and wait for the whole response. Returns the HTTP
+   status, or -1 if the connection failed (the caller reconnects).
+   resp->body stays valid until the next call on this connection. */
+int http_request(HttpConn *c, const char *method, const char *path,
+                 const char *headers, const char *body, size_t body_len,
+                 HttpResponse *resp) {
+    char head[1024];
+    int n = snprintf(head, sizeof(head),
+        "%s %s HTTP/1.1\r\nHost: %s:%d\r\nConnection: keep-alive\r\n"
+        "Content-Length: %zu\r\n%s\r\n",
+        method, path, c->host, c->port, body_len, headers ? headers : "");
+    if (n < 0 || (size_t) n >= sizeof(head) || c->fd < 0)
+        return -1;
+
+    // Small bodies go out in the same segment as the headers
+    if (body_len > 0 && (size_t) n + body_len <= sizeof(head)) {
+        memcpy(head + n, body, body_len);
+        n += (int) body_len;
+        body_len = 0;
+    }
+    if (send_all(c->fd, head, (size_t) n) < 0 ||
+        (body_len > 0 && send_all(c->fd, body, body_len) < 0))
+        return -1;
+
+    // Headers
+    char *end;
+    size_t scanned = 0;
+    for (;;) {
+        end = NULL;
+        for (size_t i = scanned > 3 ? scanned - 3 : 0; i + 4 <= c->len; i++) {
+            if (memcmp(c->buf + i, "\r\n\r\n", 4) == 0) {
+                end = c->buf + i + 4;
+                break;
+            }
+        }
+        if (end) break;
+        scanned = c->len;
+        if (fill(c) < 0) return -1;
+    }
+
+    size_t head_len = (size_t) (end - c->buf);
+    int status = 0;
+    if (sscanf(c->buf, "HTTP/1.%*d %d", &status) != 1)
+        return -1;
+
+    const char *cl = find_header(c->buf, head_len, "Content-Length");
+    if (!cl) return -1;
+    size_t content_len = strtoul(cl, NULL, 10);
+
+    while (c->len < head_len + content_len)
+        if (fill(c) < 0) return -1;
+
+    resp->status = status;
+    resp->body = c->buf + head_len;
+    resp->body_len = content_len;
+
+    const char *conn = find_header(c->buf, head_len, "Connection");
+    if (conn && strncasecmp(conn + strspn(conn, " "), "close", 5) == 0) {
+        close(c->fd);
+        c->fd = open_socket(c->host, c->port);
+    }
+
+    // One request in flight, so nothing follows this response; the
+    // bytes stay in place for resp->body until the next request
+    c->len = 0;
+    return status;
+}
+
+/* Poll until something accepts connections on host:port */
+int http_wait_ready(const char *host, int port, int timeout_ms) {
+    for (int waited = 0; waited <= timeout_ms; waited += 50) {
+        int fd = open_socket(host, port);
+        if (fd >= 0) {
+            close(fd);
+            return 0;
+        }
+        struct timespec ts = { 0, 50 * 1000000L };
+        nanosleep(&ts, NULL);
+    }
+    return -1;
+}
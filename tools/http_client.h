@@ -0,0 +1,35 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <stddef.h>
+
+/* ============================================================
+   MINIMAL HTTP/1.1 CLIENT
+   One keep-alive connection, one request in flight. Enough for the
+   load and replay tools to drive api_server; responses must carry a
+   Content-Length (mg_http_reply always sends one).
+   ============================================================ */
+
+typedef struct {
+    int fd;
+    char host[64];
+    int port;
+    char *buf;          /* response bytes; grown as needed */
+    size_t cap;
+    size_t len;         /* bytes in buf (may include the next response) */
+} HttpConn;
+
+typedef struct {
+    int status;
+    const char *body;   /* points into the connection buffer */
+    size_t body_len;
+} HttpResponse;
+
+int http_connect(HttpConn *c, const char *host, int port);
+void http_close(HttpConn *c);
+int http_request(HttpConn *c, const char *method, const char *path,
+                 const char *headers, const char *body, size_t body_len,
+                 HttpResponse *resp);
+int http_wait_ready(const char *host, int port, int timeout_ms);
+
+#endif
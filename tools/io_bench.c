@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <sys/resource.h>
+#include "student.h"
+#include "department.h"
+#include "csv_handler.h"
+#include "snapshot.h"
+#include "merit_engine.h"
+#include "bench_data.h"
+
+/* ============================================================
+   STORAGE I/O BENCHMARK
+   Runs each storage path (CSV load/save, durable save, binary
+   snapshot, merit list writer, request-log append) against a
+   generated dataset in a tmpfs directory and a disk directory.
+   Loads run with a warm page cache and with the file's pages
+   dropped first (cold). Reports MB/s, rows/s, read/write syscall
+   counts from /proc/self/io and major faults, as one JSON document.
+   ============================================================ */
+
+#define TMPFS_MAGIC 0x01021994
+
+typedef struct {
+    unsigned long long rchar, wchar, syscr, syscw;
+} IoCounters;
+
+typedef struct {
+    double ms;
+    long long bytes;
+    IoCounters io;
+    long majorFaults;
+    int rows;
+    int ok;
+} IoResult;
+
+typedef struct {
+    const char *name;
+    int isLoad;
+    const char *ext;
+} IoCase;
+
+static const IoCase CASES[] = {
+    { "csv-save",         0, "csv" },
+    { "csv-save-durable", 0, "csv" },
+    { "csv-load",         1, "csv" },
+    { "snapshot-save",    0, "snap" },
+    { "snapshot-load",    1, "snap" },
+    { "merit-write",      0, "merit.csv" },
+    { "log-append",       0, "log" },
+};
+
+#define CASE_COUNT (sizeof(CASES) / sizeof(CASES[0]))
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* /proc/self/io; the read of the file itself shows up as one syscr */
+static void readIoCounters(IoCounters *c) {
+    char buf[512];
+    memset(c, 0, sizeof(*c));
+
+    int fd = open("/proc/self/io", O_RDONLY);
+    if (fd < 0) return;
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return;
+    buf[n] = '\0';
+
+    char *p;
+    if ((p = strstr(buf, "rchar:"))) c->rchar = strtoull(p + 6, NULL, 10);
+    if ((p = strstr(buf, "wchar:"))) c->wchar = strtoull(p + 6, NULL, 10);
+    if ((p = strstr(buf, "syscr:"))) c->syscr = strtoull(p + 6, NULL, 10);
+    if ((p = strstr(buf, "syscw:"))) c->syscw = strtoull(p + 6, NULL, 10);
+}
+
+static long majorFaults(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_majflt;
+}
+
+static long long fileSize(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long long) st.st_size : -1;
+}
+
+/* Flush the file's dirty pages, then ask the kernel to drop it from
+   the page cache so the next read comes from the device. */
+static void dropFileCache(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static int isTmpfs(const char *dir) {
+    struct statfs fs;
+    return statfs(dir, &fs) == 0 && (unsigned long) fs.f_type == TMPFS_MAGIC;
+}
+
+/* Same write pattern as the API server's request log: one formatted
+   line and one fflush per request. */
+static int appendLog(const char *path, Applicant a[], int n) {
+    FILE *fp = fopen(path, "a");
+    if (!fp) return -1;
+
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "[2024-01-01 00:00:00] POST /api/register -> 200 | ID: %d, Name: %s\n",
+                a[i].id, applicantName(&a[i]));
+        fflush(fp);
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+static void runCase(const IoCase *c, const char *path, Applicant a[], int n,
+                    int logLines, IoResult *r) {
+    IoCounters before, after;
+    Applicant *loaded = NULL;
+    int seats[MAX_PROGRAMS];
+
+    memset(r, 0, sizeof(*r));
+    if (strcmp(c->name, "merit-write") == 0)
+        allocateSeats(a, n, seats, NULL, NULL);
+    if (strcmp(c->name, "log-append") == 0)
+        remove(path);
+
+    long faults = majorFaults();
+    readIoCounters(&before);
+    double start = nowMs();
+
+    if (strcmp(c->name, "csv-save") == 0) {
+        r->ok = saveApplicantsTo(path, a, n) == 0;
+        r->rows = n;
+    } else if (strcmp(c->name, "csv-save-durable") == 0) {
+        r->ok = saveApplicantsDurable(path, a, n) == 0;
+        r->rows = n;
+    } else if (strcmp(c->name, "csv-load") == 0) {
+        r->rows = loadApplicantsFrom(path, &loaded);
+        r->ok = r->rows == n;
+    } else if (strcmp(c->name, "snapshot-save") == 0) {
+        r->ok = saveSnapshot(path, a, n) == 0;
+        r->rows = n;
+    } else if (strcmp(c->name, "snapshot-load") == 0) {
+        r->rows = loadSnapshot(path, &loaded);
+        r->ok = r->rows == n;
+    } else if (strcmp(c->name, "merit-write") == 0) {
+        r->ok = writeMeritList(path, a, n) == 0;
+        r->rows = n;
+    } else {
+        r->rows = logLines < n ? logLines : n;
+        r->ok = appendLog(path, a, r->rows) == 0;
+    }
+
+    r->ms = nowMs() - start;
+    readIoCounters(&after);
+    r->majorFaults = majorFaults() - faults;
+    r->bytes = fileSize(path);
+
+    r->io.rchar = after.rchar - before.rchar;
+    r->io.wchar = after.wchar - before.wchar;
+    r->io.syscr = after.syscr - before.syscr - 1;
+    r->io.syscw = after.syscw - before.syscw;
+    free(loaded);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [--rows=N] [--tmpfs-dir=DIR] [--disk-dir=DIR] [--log-lines=N]\n"
+        "          [--profile=NAME] [--seed=N] [--out=FILE]\n"
+        "  Either directory can be set to an empty string to skip it.\n",
+        prog);
+}
+
+int main(int argc, char *argv[]) {
+    int rows = 1000000;
+    int logLines = 100000;
+    const char *dirs[2] = { "/dev/shm", "." };
+    const char *profile = "uniform";
+    unsigned long long seed = 42;
+    const char *outPath = NULL;
+
+    if (programsInit() < 0) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = strchr(arg, '=');
+        int bad = val == NULL;
+        if (val) val++;
+
+        if (bad) ;
+        else if (strncmp(arg, "--rows=", 7) == 0)
+            bad = (rows = atoi(val)) < 1;
+        else if (strncmp(arg, "--tmpfs-dir=", 12) == 0)
+            dirs[0] = val;
+        else if (strncmp(arg, "--disk-dir=", 11) == 0)
+            dirs[1] = val;
+        else if (strncmp(arg, "--log-lines=", 12) == 0)
+            bad = (logLines = atoi(val)) < 1;
+        else if (strncmp(arg, "--profile=", 10) == 0)
+            profile = val;
+        else if (strncmp(arg, "--seed=", 7) == 0)
+            seed = strtoull(val, NULL, 10);
+        else if (strncmp(arg, "--out=", 6) == 0)
+            outPath = val;
+        else
+            bad = 1;
+
+        if (bad) {
+            fprintf(stderr, "Invalid argument: %s\n", arg);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    Applicant *a = malloc((size_t) rows * sizeof(Applicant));
+    if (!a) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    if (bench_generate(a, rows, profile, seed) != 0) {
+        fprintf(stderr, "Unknown profile: %s\n", profile);
+        return 2;
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Unable to create %s\n", outPath);
+        return 1;
+    }
+
+    fprintf(out, "{\"benchmark\":\"io\",\"timestamp\":%ld,\"rows\":%d,"
+            "\"profile\":\"%s\",\"seed\":%llu,\"results\":[",
+            (long) time(NULL), rows, profile, seed);
+
+    int first = 1;
+    for (int d = 0; d < 2; d++) {
+        const char *dir = dirs[d];
+        if (!dir || !*dir) continue;
+
+        int tmpfs = isTmpfs(dir);
+        const char *fs = tmpfs ? "tmpfs" : "disk";
+
+        for (size_t c = 0; c < CASE_COUNT; c++) {
+            // Dropping the cache means nothing when the cache is the storage
+            int modes = CASES[c].isLoad && !tmpfs ? 2 : 1;
+
+            for (int m = 0; m < modes; m++) {
+                char path[512];
+                IoResult r;
+                const char *cache = !CASES[c].isLoad ? "n/a" : (m ? "cold" : "warm");
+
+                snprintf(path, sizeof(path), "%s/io_bench.%s", dir, CASES[c].ext);
+                if (CASES[c].isLoad && m == 1)
+                    dropFileCache(path);
+
+                runCase(&CASES[c], path, a, rows, logLines, &r);
+
+                double secs = r.ms / 1000.0;
+                double mb = r.bytes > 0 ? r.bytes / (1024.0 * 1024.0) : 0;
+                fprintf(stderr, "%-5s %-16s %-4s %9.2f ms %9.1f MB/s %12.0f rows/s%s\n",
+                        fs, CASES[c].name, cache, r.ms,
+                        secs > 0 ? mb / secs : 0, secs > 0 ? r.rows / secs : 0,
+                        r.ok ? "" : "  FAILED");
+
+                fprintf(out, "%s\n    {\"path\":\"%s\",\"fs\":\"%s\",\"dir\":\"%s\","
+                        "\"cache\":\"%s\",\"status\":\"%s\",\"rows\":%d,"
+                        "\"bytes\":%lld,\"total_ms\":%.3f,\"mb_per_s\":%.1f,"
+                        "\"rows_per_s\":%.0f,\"read_syscalls\":%llu,"
+                        "\"write_syscalls\":%llu,\"read_bytes\":%llu,"
+                        "\"write_bytes\":%llu,\"major_faults\":%ld}",
+                        first ? "" : ",", CASES[c].name, fs, dir, cache,
+                        r.ok ? "ok" : "failed", r.rows, r.bytes, r.ms,
+                        secs > 0 ? mb / secs : 0, secs > 0 ? r.rows / secs : 0,
+                        r.io.syscr, r.io.syscw, r.io.rchar, r.io.wchar,
+                        r.majorFaults);
+                first = 0;
+            }
+        }
+
+        for (size_t c = 0; c < CASE_COUNT; c++) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/io_bench.%s", dir, CASES[c].ext);
+            remove(path);
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout)
+        fclose(out);
+    free(a);
+    return 0;
+}
@@ -0,0 +1,376 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/wait.h>
+#include "student.h"
+#include "department.h"
+#include "csv_handler.h"
+#include "http_client.h"
+
+/* ============================================================
+   HTTP LOAD GENERATOR
+   N worker threads, each with one keep-alive connection, issue a
+   weighted mix of API requests back to back until the duration or
+   request budget is spent. Every latency is kept so percentiles are
+   exact. Optionally launches the server itself and stops it after.
+   ============================================================ */
+
+typedef enum {
+    ROUTE_LOGIN,
+    ROUTE_APPLICANTS,
+    ROUTE_REGISTER,
+    ROUTE_MERIT,
+    ROUTE_COUNT
+} Route;
+
+static const char *routeNames[ROUTE_COUNT] = { "login", "applicants", "register", "merit" };
+static const char *routePaths[ROUTE_COUNT] = {
+    "/api/login/student", "/api/applicants", "/api/register", "/api/generate-merit"
+};
+
+typedef struct {
+    unsigned int *latencyUs;    /* one entry per completed request */
+    size_t count, cap;
+    unsigned long long status[6];   /* by class: 0 = conn error, 1xx..5xx */
+} RouteSamples;
+
+typedef struct {
+    int index;
+    pthread_t tid;
+    RouteSamples routes[ROUTE_COUNT];
+    unsigned long long seed;
+} Worker;
+
+typedef struct {
+    const char *host;
+    int port;
+    int concurrency;
+    double duration;
+    long long maxRequests;
+    int weights[ROUTE_COUNT];
+    int totalWeight;
+    Applicant *creds;           /* login credentials from the data file */
+    int ncreds;
+} LoadOptions;
+
+static LoadOptions opt;
+static atomic_llong issued;
+static double startMs;
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static unsigned long long nextRandom(unsigned long long *s) {
+    unsigned long long z = (*s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static Route pickRoute(unsigned long long *rng) {
+    int r = (int) (nextRandom(rng) % (unsigned long long) opt.totalWeight);
+    for (int i = 0; i < ROUTE_COUNT; i++) {
+        if (r < opt.weights[i]) return (Route) i;
+        r -= opt.weights[i];
+    }
+    return ROUTE_APPLICANTS;
+}
+
+static void record(RouteSamples *s, double ms, int status) {
+    if (s->count == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 4096;
+        unsigned int *grown = realloc(s->latencyUs, cap * sizeof(unsigned int));
+        if (!grown) return;
+        s->latencyUs = grown;
+        s->cap = cap;
+    }
+    s->latencyUs[s->count++] = (unsigned int) (ms * 1000.0);
+    s->status[status > 0 && status < 600 ? status / 100 : 0]++;
+}
+
+/* Request body for a route; returns its length */
+static int buildBody(Route route, Worker *w, char *body, size_t size) {
+    switch (route) {
+        case ROUTE_LOGIN: {
+            if (opt.ncreds > 0) {
+                const Applicant *a = &opt.creds[nextRandom(&w->seed) % opt.ncreds];
+                return snprintf(body, size,
+                    "{\"name\":\"%s\",\"id\":%d,\"password\":\"%s\"}",
+                    applicantName(a), a->id, applicantPassword(a));
+            }
+            return snprintf(body, size,
+                "{\"name\":\"Load Test\",\"id\":1000,\"password\":\"none\"}");
+        }
+        case ROUTE_REGISTER:
+            return snprintf(body, size,
+                "{\"name\":\"Load User %d\",\"password\":\"load123\","
+                "\"category\":\"GEN\",\"jee_rank\":%d,\"marks\":%d,"
+                "\"pref\":[\"%s\",\"%s\",\"%s\",\"%s\"]}",
+                w->index, 1 + (int) (nextRandom(&w->seed) % 50000),
+                (int) (nextRandom(&w->seed) % 101),
+                getDeptCode(0), getDeptCode(1), getDeptCode(2), getDeptCode(3));
+        case ROUTE_MERIT:
+            return snprintf(body, size, "{}");
+        default:
+            body[0] = '\0';
+            return 0;
+    }
+}
+
+static void *workerMain(void *arg) {
+    Worker *w = arg;
+    HttpConn conn;
+    char body[512];
+
+    memset(&conn, 0, sizeof(conn));
+    conn.fd = -1;
+    http_connect(&conn, opt.host, opt.port);
+
+    for (;;) {
+        if (opt.maxRequests > 0 && atomic_fetch_add(&issued, 1) >= opt.maxRequests)
+            break;
+        if (opt.duration > 0 && nowMs() - startMs >= opt.duration * 1000.0)
+            break;
+
+        Route route = pickRoute(&w->seed);
+        int len = buildBody(route, w, body, sizeof(body));
+        HttpResponse resp;
+
+        double t0 = nowMs();
+        int status = http_request(&conn, route == ROUTE_APPLICANTS ? "GET" : "POST",
+                                  routePaths[route],
+                                  len > 0 ? "Content-Type: application/json\r\n" : NULL,
+                                  body, (size_t) len, &resp);
+        record(&w->routes[route], nowMs() - t0, status);
+
+        if (status < 0) {
+            http_close(&conn);
+            conn.fd = -1;
+            http_connect(&conn, opt.host, opt.port);
+        }
+    }
+
+    http_close(&conn);
+    return NULL;
+}
+
+/* ============ REPORT ============ */
+static int compareUint(const void *x, const void *y) {
+    unsigned int a = *(const unsigned int *) x, b = *(const unsigned int *) y;
+    return (a > b) - (a < b);
+}
+
+static double percentileMs(const unsigned int *sorted, size_t n, double p) {
+    if (n == 0) return 0;
+    size_t i = (size_t) (p * (double) (n - 1) + 0.5);
+    return sorted[i] / 1000.0;
+}
+
+static void report(FILE *out, Worker *workers, double elapsedMs) {
+    unsigned long long total = 0;
+
+    fprintf(out, "{\"benchmark\":\"http\",\"timestamp\":%ld,\"target\":\"%s:%d\","
+            "\"concurrency\":%d,\"elapsed_s\":%.3f,\"routes\":{",
+            (long) time(NULL), opt.host, opt.port, opt.concurrency, elapsedMs / 1000.0);
+
+    fprintf(stderr, "%-11s %9s %9s %9s %9s %9s %9s %7s\n",
+            "route", "requests", "rps", "p50 ms", "p99 ms", "p999 ms", "max ms", "errors");
+
+    int first = 1;
+    for (int r = 0; r < ROUTE_COUNT; r++) {
+        RouteSamples all;
+        memset(&all, 0, sizeof(all));
+
+        for (int t = 0; t < opt.concurrency; t++)
+            all.count += workers[t].routes[r].count;
+        if (all.count == 0) continue;
+
+        all.latencyUs = malloc(all.count * sizeof(unsigned int));
+        if (!all.latencyUs) continue;
+        size_t k = 0;
+        for (int t = 0; t < opt.concurrency; t++) {
+            RouteSamples *s = &workers[t].routes[r];
+            memcpy(all.latencyUs + k, s->latencyUs, s->count * sizeof(unsigned int));
+            k += s->count;
+            for (int c = 0; c < 6; c++) all.status[c] += s->status[c];
+        }
+        qsort(all.latencyUs, all.count, sizeof(unsigned int), compareUint);
+        total += all.count;
+
+        double rps = all.count / (elapsedMs / 1000.0);
+        double p50 = percentileMs(all.latencyUs, all.count, 0.50);
+        double p99 = percentileMs(all.latencyUs, all.count, 0.99);
+        double p999 = percentileMs(all.latencyUs, all.count, 0.999);
+        double max = all.latencyUs[all.count - 1] / 1000.0;
+        unsigned long long errors = all.status[0] + all.status[5];
+
+        fprintf(out, "%s\"%s\":{\"requests\":%zu,\"rps\":%.1f,\"p50_ms\":%.3f,"
+                "\"p99_ms\":%.3f,\"p999_ms\":%.3f,\"max_ms\":%.3f,"
+                "\"status\":{\"2xx\":%llu,\"3xx\":%llu,\"4xx\":%llu,\"5xx\":%llu,"
+                "\"conn_errors\":%llu}}",
+                first ? "" : ",", routeNames[r], all.count, rps, p50, p99, p999, max,
+                all.status[2], all.status[3], all.status[4], all.status[5], all.status[0]);
+        fprintf(stderr, "%-11s %9zu %9.1f %9.3f %9.3f %9.3f %9.3f %7llu\n",
+                routeNames[r], all.count, rps, p50, p99, p999, max, errors);
+        first = 0;
+        free(all.latencyUs);
+    }
+
+    fprintf(out, "},\"requests\":%llu,\"throughput_rps\":%.1f}\n",
+            total, total / (elapsedMs / 1000.0));
+    fprintf(stderr, "total       %9llu %9.1f\n", total, total / (elapsedMs / 1000.0));
+}
+
+/* ============ ARGUMENTS ============ */
+/* "login:60,applicants:30,register:8,merit:2" */
+static int parseMix(char *mix) {
+    memset(opt.weights, 0, sizeof(opt.weights));
+    for (char *tok = strtok(mix, ","); tok; tok = strtok(NULL, ",")) {
+        char *colon = strchr(tok, ':');
+        if (!colon) return -1;
+        *colon = '\0';
+
+        int r = 0;
+        while (r < ROUTE_COUNT && strcmp(routeNames[r], tok) != 0) r++;
+        if (r == ROUTE_COUNT || atoi(colon + 1) < 0) return -1;
+        opt.weights[r] = atoi(colon + 1);
+    }
+    opt.totalWeight = 0;
+    for (int r = 0; r < ROUTE_COUNT; r++) opt.totalWeight += opt.weights[r];
+    return opt.totalWeight > 0 ? 0 : -1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [--host=H] [--port=P] [--concurrency=N] [--duration=SEC]\n"
+        "          [--requests=N] [--mix=ROUTE:WEIGHT,...] [--data=CSV]\n"
+        "          [--launch=CMD] [--out=FILE]\n"
+        "  routes: login, applicants, register, merit\n"
+        "  --data    applicants file used for valid login credentials\n"
+        "  --launch  start the server with CMD, wait for the port, stop it after\n",
+        prog);
+}
+
+int main(int argc, char *argv[]) {
+    char mix[256] = "login:60,applicants:30,register:8,merit:2";
+    const char *dataPath = "applicants_full.csv";
+    const char *launch = NULL;
+    const char *outPath = NULL;
+
+    opt.host = "127.0.0.1";
+    opt.port = 8080;
+    opt.concurrency = 16;
+    opt.duration = -1;     // default: 10s unless --requests is given
+
+    if (programsInit() < 0) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = strchr(arg, '=');
+        int bad = val == NULL;
+        if (val) val++;
+
+        if (bad) ;
+        else if (strncmp(arg, "--host=", 7) == 0)
+            opt.host = val;
+        else if (strncmp(arg, "--port=", 7) == 0)
+            bad = (opt.port = atoi(val)) <= 0;
+        else if (strncmp(arg, "--concurrency=", 14) == 0)
+            bad = (opt.concurrency = atoi(val)) < 1;
+        else if (strncmp(arg, "--duration=", 11) == 0)
+            bad = (opt.duration = atof(val)) < 0;
+        else if (strncmp(arg, "--requests=", 11) == 0)
+            bad = (opt.maxRequests = atoll(val)) < 0;
+        else if (strncmp(arg, "--mix=", 6) == 0)
+            snprintf(mix, sizeof(mix), "%s", val);
+        else if (strncmp(arg, "--data=", 7) == 0)
+            dataPath = val;
+        else if (strncmp(arg, "--launch=", 9) == 0)
+            launch = val;
+        else if (strncmp(arg, "--out=", 6) == 0)
+            outPath = val;
+        else
+            bad = 1;
+
+        if (bad) {
+            fprintf(stderr, "Invalid argument: %s\n", arg);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (parseMix(mix) != 0) {
+        fprintf(stderr, "Invalid --mix\n");
+        return 2;
+    }
+    if (opt.duration < 0)
+        opt.duration = opt.maxRequests > 0 ? 0 : 10;
+
+    opt.ncreds = loadApplicantsFrom(dataPath, &opt.creds);
+    if (opt.ncreds < 0) {
+        opt.ncreds = 0;
+        fprintf(stderr, "Warning: %s not readable, logins will fail with 401\n", dataPath);
+    }
+
+    pid_t server = 0;
+    if (launch) {
+        server = fork();
+        if (server == 0) {
+            // exec so SIGTERM reaches the server, not the shell
+            char cmd[1024];
+            snprintf(cmd, sizeof(cmd), "exec %s", launch);
+            execl("/bin/sh", "sh", "-c", cmd, (char *) NULL);
+            _exit(127);
+        }
+        if (server < 0 || http_wait_ready(opt.host, opt.port, 10000) != 0) {
+            fprintf(stderr, "Server did not start listening on %s:%d\n", opt.host, opt.port);
+            if (server > 0) kill(server, SIGTERM);
+            return 1;
+        }
+    }
+
+    Worker *workers = calloc(opt.concurrency, sizeof(Worker));
+    if (!workers) return 1;
+
+    startMs = nowMs();
+    int started = 0;
+    for (int t = 0; t < opt.concurrency; t++) {
+        workers[t].index = t;
+        workers[t].seed = 0x5EED0000ULL + (unsigned long long) t;
+        if (pthread_create(&workers[t].tid, NULL, workerMain, &workers[t]) != 0)
+            break;
+        started++;
+    }
+    for (int t = 0; t < started; t++)
+        pthread_join(workers[t].tid, NULL);
+    double elapsed = nowMs() - startMs;
+    opt.concurrency = started;
+
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Unable to create %s\n", outPath);
+        return 1;
+    }
+    report(out, workers, elapsed);
+    if (out != stdout)
+        fclose(out);
+
+    for (int t = 0; t < started; t++)
+        for (int r = 0; r < ROUTE_COUNT; r++)
+            free(workers[t].routes[r].latencyUs);
+    free(workers);
+    free(opt.creds);
+    return 0;
+}
@@ -0,0 +1,329 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/wait.h>
+#include "capture.h"
+#include "http_client.h"
+
+/* ============================================================
+   TRAFFIC REPLAY
+   Feeds a capture log (api_server --capture=FILE) back to a server.
+   Requests are dispatched in capture order, each at its original
+   arrival offset divided by --speed (0 = back to back). With
+   --concurrency=1 the request sequence is fully deterministic.
+   Reports replay latency next to the captured latency per route
+   and counts responses whose status differs from the capture.
+   ============================================================ */
+
+#define MAX_ROUTES 64
+
+typedef struct {
+    CaptureEntry e;
+    int status;             /* replayed status, -1 on connection error */
+    unsigned int latencyUs;
+    double lagMs;           /* how late it was sent versus schedule */
+} ReplayItem;
+
+typedef struct {
+    char key[96];
+    unsigned int *captured, *replayed;
+    size_t count;
+    unsigned long long mismatches;
+} RouteStats;
+
+static ReplayItem *items;
+static size_t nitems;
+static atomic_size_t nextItem;
+static const char *host = "127.0.0.1";
+static int port = 8080;
+static double speed = 1.0;
+static double startMs;
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void sleepUntil(double targetMs) {
+    double wait = targetMs - nowMs();
+    if (wait <= 0) return;
+    struct timespec ts = { (time_t) (wait / 1000), (long) (((long long) (wait * 1e6)) % 1000000000LL) };
+    nanosleep(&ts, NULL);
+}
+
+static void *workerMain(void *arg) {
+    HttpConn conn;
+    (void) arg;
+
+    memset(&conn, 0, sizeof(conn));
+    conn.fd = -1;
+    http_connect(&conn, host, port);
+
+    for (;;) {
+        size_t i = atomic_fetch_add(&nextItem, 1);
+        if (i >= nitems) break;
+        ReplayItem *it = &items[i];
+
+        double due = startMs;
+        if (speed > 0) {
+            due += it->e.rec.offsetUs / 1000.0 / speed;
+            sleepUntil(due);
+        }
+
+        HttpResponse resp;
+        double t0 = nowMs();
+        it->lagMs = speed > 0 ? t0 - due : 0;
+        it->status = http_request(&conn, it->e.method, it->e.uri,
+                                  it->e.rec.bodyLen > 0 ? "Content-Type: application/json\r\n" : NULL,
+                                  it->e.body, it->e.rec.bodyLen, &resp);
+        it->latencyUs = (unsigned int) ((nowMs() - t0) * 1000.0);
+
+        if (it->status < 0) {
+            http_close(&conn);
+            conn.fd = -1;
+            http_connect(&conn, host, port);
+        }
+    }
+
+    http_close(&conn);
+    return NULL;
+}
+
+/* ============ REPORT ============ */
+/* "GET /api/jobs/17" -> "GET /api/jobs/:id" so routes aggregate */
+static void routeKey(const CaptureEntry *e, char *key, size_t size) {
+    size_t n = (size_t) snprintf(key, size, "%s ", e->method);
+    const char *p = e->uri;
+
+    while (*p && n + 4 < size) {
+        if (*p == '/' && p[1] >= '0' && p[1] <= '9') {
+            const char *q = p + 1;
+            while (*q >= '0' && *q <= '9') q++;
+            if (*q == '\0' || *q == '/' || *q == '?') {
+                n += (size_t) snprintf(key + n, size - n, "/:id");
+                p = q;
+                continue;
+            }
+        }
+        key[n++] = *p++;
+    }
+    key[n < size ? n : size - 1] = '\0';
+}
+
+static int compareUint(const void *x, const void *y) {
+    unsigned int a = *(const unsigned int *) x, b = *(const unsigned int *) y;
+    return (a > b) - (a < b);
+}
+
+static double pct(unsigned int *v, size_t n, double p) {
+    return n ? v[(size_t) (p * (double) (n - 1) + 0.5)] / 1000.0 : 0;
+}
+
+static void report(FILE *out, double elapsedMs, const CaptureHeader *h) {
+    static RouteStats routes[MAX_ROUTES];
+    int nroutes = 0;
+    unsigned long long mismatches = 0, errors = 0;
+    double maxLag = 0;
+
+    for (size_t i = 0; i < nitems; i++) {
+        char key[96];
+        routeKey(&items[i].e, key, sizeof(key));
+
+        int r = 0;
+        while (r < nroutes && strcmp(routes[r].key, key) != 0) r++;
+        if (r == nroutes) {
+            if (nroutes == MAX_ROUTES) r = MAX_ROUTES - 1;   // overflow bucket
+            else snprintf(routes[nroutes++].key, sizeof(routes[0].key), "%s", key);
+        }
+
+        RouteStats *s = &routes[r];
+        if (!s->captured) {
+            s->captured = malloc(nitems * sizeof(unsigned int));
+            s->replayed = malloc(nitems * sizeof(unsigned int));
+            if (!s->captured || !s->replayed) return;
+        }
+        s->captured[s->count] = items[i].e.rec.latencyUs;
+        s->replayed[s->count] = items[i].latencyUs;
+        s->count++;
+
+        if (items[i].status < 0) errors++;
+        else if (items[i].status != items[i].e.rec.status) {
+            mismatches++;
+            s->mismatches++;
+        }
+        if (items[i].lagMs > maxLag) maxLag = items[i].lagMs;
+    }
+
+    double capturedMs = nitems ? items[nitems - 1].e.rec.offsetUs / 1000.0 : 0;
+    fprintf(out, "{\"benchmark\":\"replay\",\"timestamp\":%ld,\"capture_start_unix_us\":%llu,"
+            "\"target\":\"%s:%d\",\"speed\":%.3f,\"requests\":%zu,"
+            "\"captured_span_s\":%.3f,\"elapsed_s\":%.3f,\"throughput_rps\":%.1f,"
+            "\"max_dispatch_lag_ms\":%.3f,\"status_mismatches\":%llu,"
+            "\"conn_errors\":%llu,\"routes\":{",
+            (long) time(NULL), (unsigned long long) h->startUnixUs, host, port, speed,
+            nitems, capturedMs / 1000.0, elapsedMs / 1000.0,
+            elapsedMs > 0 ? nitems / (elapsedMs / 1000.0) : 0, maxLag, mismatches, errors);
+
+    fprintf(stderr, "%-36s %8s %10s %10s %10s %10s %8s\n", "route", "requests",
+            "cap p50", "rep p50", "cap p99", "rep p99", "status!=");
+    for (int r = 0; r < nroutes; r++) {
+        RouteStats *s = &routes[r];
+        qsort(s->captured, s->count, sizeof(unsigned int), compareUint);
+        qsort(s->replayed, s->count, sizeof(unsigned int), compareUint);
+
+        fprintf(out, "%s\"%s\":{\"requests\":%zu,\"captured_p50_ms\":%.3f,"
+                "\"replay_p50_ms\":%.3f,\"captured_p99_ms\":%.3f,\"replay_p99_ms\":%.3f,"
+                "\"replay_p999_ms\":%.3f,\"status_mismatches\":%llu}",
+                r ? "," : "", s->key, s->count,
+                pct(s->captured, s->count, 0.5), pct(s->replayed, s->count, 0.5),
+                pct(s->captured, s->count, 0.99), pct(s->replayed, s->count, 0.99),
+                pct(s->replayed, s->count, 0.999), s->mismatches);
+        fprintf(stderr, "%-36s %8zu %10.3f %10.3f %10.3f %10.3f %8llu\n", s->key, s->count,
+                pct(s->captured, s->count, 0.5), pct(s->replayed, s->count, 0.5),
+                pct(s->captured, s->count, 0.99), pct(s->replayed, s->count, 0.99),
+                s->mismatches);
+        free(s->captured);
+        free(s->replayed);
+    }
+    fprintf(out, "}}\n");
+    fprintf(stderr, "%zu requests in %.2fs, %llu status mismatches, %llu connection errors\n",
+            nitems, elapsedMs / 1000.0, mismatches, errors);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s --capture=FILE [--host=H] [--port=P] [--speed=X]\n"
+        "          [--concurrency=N] [--launch=CMD] [--out=FILE]\n"
+        "  --speed        1 = original pacing, 10 = ten times faster,\n"
+        "                 0 = as fast as possible (default 1)\n"
+        "  --concurrency  connections replaying in parallel (default 8);\n"
+        "                 1 replays the exact captured order\n"
+        "  --launch       start the server with CMD, wait for the port, stop it after\n",
+        prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *capturePath = NULL;
+    const char *launch = NULL;
+    const char *outPath = NULL;
+    int concurrency = 8;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = strchr(arg, '=');
+        int bad = val == NULL;
+        if (val) val++;
+
+        if (bad) ;
+        else if (strncmp(arg, "--capture=", 10) == 0)
+            capturePath = val;
+        else if (strncmp(arg, "--host=", 7) == 0)
+            host = val;
+        else if (strncmp(arg, "--port=", 7) == 0)
+            bad = (port = atoi(val)) <= 0;
+        else if (strncmp(arg, "--speed=", 8) == 0)
+            bad = (speed = atof(val)) < 0;
+        else if (strncmp(arg, "--concurrency=", 14) == 0)
+            bad = (concurrency = atoi(val)) < 1;
+        else if (strncmp(arg, "--launch=", 9) == 0)
+            launch = val;
+        else if (strncmp(arg, "--out=", 6) == 0)
+            outPath = val;
+        else
+            bad = 1;
+
+        if (bad) {
+            fprintf(stderr, "Invalid argument: %s\n", arg);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!capturePath) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    CaptureHeader h;
+    FILE *fp = captureOpenRead(capturePath, &h);
+    if (!fp) {
+        fprintf(stderr, "%s is not a readable capture log\n", capturePath);
+        return 1;
+    }
+
+    size_t cap = 0;
+    for (;;) {
+        if (nitems == cap) {
+            cap = cap ? cap * 2 : 1024;
+            ReplayItem *grown = realloc(items, cap * sizeof(ReplayItem));
+            if (!grown) {
+                fprintf(stderr, "Out of memory\n");
+                return 1;
+            }
+            items = grown;
+        }
+        memset(&items[nitems], 0, sizeof(ReplayItem));
+        int rc = captureRead(fp, &items[nitems].e);
+        if (rc == 0) break;
+        if (rc < 0) {
+            captureEntryFree(&items[nitems].e);
+            fprintf(stderr, "Warning: capture truncated after %zu requests\n", nitems);
+            break;
+        }
+        nitems++;
+    }
+    fclose(fp);
+
+    pid_t server = 0;
+    if (launch) {
+        server = fork();
+        if (server == 0) {
+            char cmd[1024];
+            snprintf(cmd, sizeof(cmd), "exec %s", launch);
+            execl("/bin/sh", "sh", "-c", cmd, (char *) NULL);
+            _exit(127);
+        }
+        if (server < 0 || http_wait_ready(host, port, 10000) != 0) {
+            fprintf(stderr, "Server did not start listening on %s:%d\n", host, port);
+            if (server > 0) kill(server, SIGTERM);
+            return 1;
+        }
+    }
+
+    pthread_t *tids = malloc(concurrency * sizeof(pthread_t));
+    int started = 0;
+    startMs = nowMs();
+    while (tids && started < concurrency &&
+           pthread_create(&tids[started], NULL, workerMain, NULL) == 0)
+        started++;
+    if (started == 0)
+        workerMain(NULL);
+    for (int t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+    double elapsed = nowMs() - startMs;
+    free(tids);
+
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+    }
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Unable to create %s\n", outPath);
+        return 1;
+    }
+    report(out, elapsed, &h);
+    if (out != stdout)
+        fclose(out);
+
+    for (size_t i = 0; i < nitems; i++)
+        captureEntryFree(&items[i].e);
+    free(items);
+    return 0;
+}